@@ -14,6 +14,7 @@
 #include <chrono>
 #include <cstring>
 #include <algorithm>
+#include <iomanip>
 #include "memcpyfast_audio.h"
 
 // ============================================================================
@@ -72,6 +73,120 @@ void AudioBuffer::resize(size_t size) {
     m_data = new uint8_t[size];
 }
 
+// ============================================================================
+// MemoryTrack
+// ============================================================================
+
+bool MemoryTrack::Budget::reserve(uint64_t bytes) {
+    uint64_t cur = used.load();
+    do {
+        if (cur + bytes > limit) return false;
+    } while (!used.compare_exchange_weak(cur, cur + bytes));
+    return true;
+}
+
+MemoryTrack::MemoryTrack(const std::string& uri, Budget& budget)
+    : m_uri(uri)
+    , m_budget(budget)
+{
+    m_openThread = std::thread([this]() { openThreadFunc(); });
+}
+
+MemoryTrack::~MemoryTrack() {
+    m_cancel = true;
+    if (m_openThread.joinable()) {
+        m_openThread.join();
+    }
+    if (m_ring) {
+        m_ring->stop();  // Joins the reader thread before its HTTP context goes away
+        m_ring.reset();
+    }
+    if (m_http) {
+        avio_closep(&m_http);
+    }
+    if (m_reserved > 0) {
+        m_budget.release(m_reserved);
+    }
+}
+
+int MemoryTrack::interruptCb(void* opaque) {
+    // Set first in the destructor: aborts the open and the reader's blocked reads
+    return static_cast<MemoryTrack*>(opaque)->m_cancel.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+void MemoryTrack::openThreadFunc() {
+    AVDictionary* options = nullptr;
+    av_dict_set(&options, "timeout", "30000000", 0);
+    av_dict_set(&options, "user_agent", "DirettaRenderer/1.0", 0);
+    av_dict_set(&options, "reconnect", "1", 0);
+    av_dict_set(&options, "reconnect_delay_max", "5", 0);
+
+    AVIOInterruptCB interrupt = { interruptCb, this };
+    AVIOContext* http = nullptr;
+    int ret = avio_open2(&http, m_uri.c_str(), AVIO_FLAG_READ, &interrupt, &options);
+    av_dict_free(&options);
+
+    std::unique_ptr<HttpReadAhead> ring;
+    int64_t size = -1;
+    if (ret < 0) {
+        if (!m_cancel) {
+            char errbuf[AV_ERROR_MAX_STRING_SIZE];
+            av_strerror(ret, errbuf, sizeof(errbuf));
+            std::cerr << "[MemoryTrack] Open failed (" << errbuf << "), streaming instead" << std::endl;
+        }
+    } else {
+        size = avio_size(http);
+        if (size <= 0) {
+            std::cout << "[MemoryTrack] Unknown length, streaming instead" << std::endl;
+        } else if (!m_budget.reserve(static_cast<uint64_t>(size))) {
+            uint64_t used = m_budget.used.load();
+            uint64_t avail = used < m_budget.limit ? m_budget.limit - used : 0;
+            std::cout << "[MemoryTrack] " << (size >> 20) << " MB exceeds free budget ("
+                      << (avail >> 20) << " MB), streaming instead" << std::endl;
+        } else {
+            m_reserved = static_cast<uint64_t>(size);
+            // Retain-all ring one chunk larger than the file: never overwrites
+            ring = std::make_unique<HttpReadAhead>(static_cast<size_t>(size) + HttpReadAhead::CHUNK_SIZE, true);
+            ring->start(
+                [http](uint8_t* buf, int n) -> int {
+                    int r = avio_read(http, buf, n);
+                    return (r == AVERROR_EOF) ? 0 : r;
+                },
+                [http](int64_t pos) -> int64_t { return avio_seek(http, pos, SEEK_SET); });
+            std::cout << "[MemoryTrack] Loading " << (size >> 20) << " MB into RAM" << std::endl;
+        }
+        if (!ring) {
+            avio_closep(&http);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_http = http;
+        m_ring = std::move(ring);
+        m_size = size;
+        m_opened = true;
+    }
+    m_cv.notify_all();
+}
+
+HttpReadAhead* MemoryTrack::waitReady() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_opened; });
+    return m_ring.get();
+}
+
+MemoryTrack::Progress MemoryTrack::getProgress() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Progress p;
+    if (m_ring) {
+        p.size = m_size;
+        p.downloaded = m_ring->getStats().bytesIn;
+        p.inMemory = true;
+    }
+    return p;
+}
+
 // ============================================================================
 // AudioDecoder
 // ============================================================================
@@ -100,6 +215,7 @@ AudioDecoder::~AudioDecoder() {
 
 int AudioDecoder::ffmpegReadInterruptCb(void* opaque) {
     auto* self = static_cast<AudioDecoder*>(opaque);
+    if (self->m_demuxAbort.load(std::memory_order_acquire)) return 1;
     int64_t deadline = self->m_readDeadlineNs.load(std::memory_order_relaxed);
     if (deadline == 0) return 0;
     int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -107,8 +223,333 @@ int AudioDecoder::ffmpegReadInterruptCb(void* opaque) {
     return (now >= deadline) ? 1 : 0;
 }
 
+int AudioDecoder::readAheadInterruptCb(void* opaque) {
+    return static_cast<HttpReadAhead*>(opaque)->stopping() ? 1 : 0;
+}
+
+int AudioDecoder::readAheadRead(void* opaque, uint8_t* buf, int bufSize) {
+    auto* self = static_cast<AudioDecoder*>(opaque);
+    // Same 20s stall deadline as the direct HTTP path (returns AVERROR_EXIT)
+    int n = self->m_memoryCursor
+        ? self->m_memoryCursor->read(buf, bufSize, ffmpegReadInterruptCb, self)
+        : self->m_activeReadAhead->read(buf, bufSize, ffmpegReadInterruptCb, self);
+    if (n == HttpReadAhead::ABORTED) return AVERROR_EXIT;
+    return (n == 0) ? AVERROR_EOF : n;
+}
+
+int64_t AudioDecoder::readAheadSeek(void* opaque, int64_t offset, int whence) {
+    auto* self = static_cast<AudioDecoder*>(opaque);
+    if (whence & AVSEEK_SIZE) {
+        return self->m_readAheadSize >= 0 ? self->m_readAheadSize : AVERROR(ENOSYS);
+    }
+    whence &= ~AVSEEK_FORCE;
+
+    int64_t pos;
+    if (whence == SEEK_SET) {
+        pos = offset;
+    } else if (whence == SEEK_CUR) {
+        pos = (self->m_memoryCursor ? self->m_memoryCursor->position()
+                                    : self->m_activeReadAhead->position()) + offset;
+    } else if (whence == SEEK_END && self->m_readAheadSize >= 0) {
+        pos = self->m_readAheadSize + offset;
+    } else {
+        return AVERROR(EINVAL);
+    }
+
+    if (self->m_memoryCursor) return self->m_memoryCursor->seek(pos);
+    int64_t ret = self->m_activeReadAhead->seek(pos, ffmpegReadInterruptCb, self);
+    return (ret == HttpReadAhead::ABORTED) ? AVERROR_EXIT : ret;
+}
+
+AVIOContext* AudioDecoder::allocReadAheadIO(bool seekable) {
+    unsigned char* ioBuf = static_cast<unsigned char*>(av_malloc(READ_AHEAD_IO_BUF_SIZE));
+    AVIOContext* wrap = ioBuf ? avio_alloc_context(ioBuf, READ_AHEAD_IO_BUF_SIZE, 0, this,
+                                                   readAheadRead, nullptr,
+                                                   seekable ? readAheadSeek : nullptr)
+                              : nullptr;
+    if (!wrap) {
+        std::cerr << "[AudioDecoder] Failed to allocate read-ahead IO" << std::endl;
+        av_free(ioBuf);
+        return nullptr;
+    }
+    wrap->seekable = seekable ? AVIO_SEEKABLE_NORMAL : 0;
+    return wrap;
+}
+
+int AudioDecoder::openMemoryTrack(AVIOContext** pb) {
+    // Blocks only until the HTTP open finished, not for the download
+    HttpReadAhead* ring = m_memoryTrack->waitReady();
+    if (!ring) return AVERROR(ENOENT);
+
+    // Own cursor from the start: the same RAM copy is reused when a track is
+    // reopened (Stop/Play) and may be playing in another decoder (repeat-one)
+    m_memoryCursor = std::make_unique<HttpReadAhead::Cursor>(*ring);
+    m_readAheadSize = m_memoryTrack->size();
+    AVIOContext* wrap = allocReadAheadIO(true);
+    if (!wrap) {
+        m_memoryCursor.reset();
+        return AVERROR(ENOMEM);
+    }
+
+    MemoryTrack::Progress p = m_memoryTrack->getProgress();
+    std::cout << "[AudioDecoder] Memory play: " << (p.downloaded >> 20) << "/"
+              << (p.size >> 20) << " MB in RAM" << std::endl;
+    *pb = wrap;
+    return 0;
+}
+
+int AudioDecoder::uringRead(void* opaque, uint8_t* buf, int bufSize) {
+    int n = static_cast<AudioDecoder*>(opaque)->m_uring->read(buf, bufSize);
+    return (n == 0) ? AVERROR_EOF : n;   // -errno is already an AVERROR
+}
+
+int64_t AudioDecoder::uringSeek(void* opaque, int64_t offset, int whence) {
+    UringFileReader* reader = static_cast<AudioDecoder*>(opaque)->m_uring.get();
+    if (whence & AVSEEK_SIZE) return reader->size();
+    whence &= ~AVSEEK_FORCE;
+
+    if (whence == SEEK_CUR) {
+        offset += reader->position();
+    } else if (whence == SEEK_END) {
+        offset += reader->size();
+    } else if (whence != SEEK_SET) {
+        return AVERROR(EINVAL);
+    }
+    return reader->seek(offset);
+}
+
+int AudioDecoder::mappedRead(void* opaque, uint8_t* buf, int bufSize) {
+    int n = static_cast<AudioDecoder*>(opaque)->m_mapped->read(buf, bufSize);
+    return (n == 0) ? AVERROR_EOF : n;
+}
+
+int64_t AudioDecoder::mappedSeek(void* opaque, int64_t offset, int whence) {
+    MappedFile* file = static_cast<AudioDecoder*>(opaque)->m_mapped.get();
+    if (whence & AVSEEK_SIZE) return file->size();
+    whence &= ~AVSEEK_FORCE;
+
+    if (whence == SEEK_CUR) {
+        offset += file->position();
+    } else if (whence == SEEK_END) {
+        offset += file->size();
+    } else if (whence != SEEK_SET) {
+        return AVERROR(EINVAL);
+    }
+    return file->seek(offset);
+}
+
+AVIOContext* AudioDecoder::allocLocalIO(int (*readFn)(void*, uint8_t*, int),
+                                        int64_t (*seekFn)(void*, int64_t, int)) {
+    unsigned char* ioBuf = static_cast<unsigned char*>(av_malloc(READ_AHEAD_IO_BUF_SIZE));
+    AVIOContext* wrap = ioBuf ? avio_alloc_context(ioBuf, READ_AHEAD_IO_BUF_SIZE, 0, this,
+                                                   readFn, nullptr, seekFn)
+                              : nullptr;
+    if (!wrap) {
+        std::cerr << "[AudioDecoder] Failed to allocate local file IO" << std::endl;
+        av_free(ioBuf);
+        return nullptr;
+    }
+    wrap->seekable = AVIO_SEEKABLE_NORMAL;
+    return wrap;
+}
+
+int AudioDecoder::openLocalFile(const std::string& url, AVIOContext** pb) {
+    std::string path;
+    if (url.compare(0, 7, "file://") == 0) {
+        path = url.substr(7);
+    } else if (!url.empty() && url[0] == '/') {
+        path = url;
+    } else {
+        return AVERROR(EINVAL);
+    }
+
+    int ret = AVERROR(ENOSYS);
+    if (m_mmap) {
+        auto file = std::make_unique<MappedFile>();
+        ret = file->open(path);
+        if (ret < 0) {
+            DEBUG_LOG("[AudioDecoder] mmap failed for " << path << " (" << strerror(-ret) << ")");
+        } else if (!(*pb = allocLocalIO(mappedRead, mappedSeek))) {
+            ret = AVERROR(ENOMEM);
+        } else {
+            DEBUG_LOG("[AudioDecoder] Mapped " << path << " (" << (file->size() >> 20) << " MB)");
+            m_mapped = std::move(file);
+            return 0;
+        }
+    }
+
+    if (m_ioUring) {
+        auto reader = std::make_unique<UringFileReader>();
+        ret = reader->open(path);
+        if (ret < 0) {
+            DEBUG_LOG("[AudioDecoder] io_uring unavailable for " << path << " (" << strerror(-ret)
+                      << "), using FFmpeg file I/O");
+        } else if (!(*pb = allocLocalIO(uringRead, uringSeek))) {
+            ret = AVERROR(ENOMEM);
+        } else {
+            DEBUG_LOG("[AudioDecoder] io_uring read-ahead: " << (reader->size() >> 20) << " MB"
+                      << (reader->getStats().fixedBuffers ? ", registered buffers" : ""));
+            m_uring = std::move(reader);
+            return 0;
+        }
+    }
+    return ret;
+}
+
+int AudioDecoder::openReadAhead(const std::string& url, AVDictionary** options, AVIOContext** pb) {
+    size_t ringBytes = m_httpReadAheadBytes > 0 ? m_httpReadAheadBytes : TRACK_CACHE_READ_AHEAD_BYTES;
+    m_readAhead = std::make_unique<HttpReadAhead>(ringBytes);
+
+    // Keep-alive pool first: plain http:// only, anything it can't handle goes to FFmpeg
+    if (m_httpPool && url.compare(0, 7, "http://") == 0) {
+        auto stream = std::make_unique<PooledHttpStream>(*m_httpPool, readAheadInterruptCb, m_readAhead.get());
+        int pooled = stream->open(url);
+        if (pooled == 0) {
+            DEBUG_LOG("[AudioDecoder] HTTP keep-alive: " << (stream->reused() ? "reused" : "new")
+                      << " connection to " << stream->hostKey());
+            m_pooledHttp = std::move(stream);
+        } else {
+            DEBUG_LOG("[AudioDecoder] HTTP keep-alive: not usable (" << pooled << "), using FFmpeg HTTP");
+        }
+    }
+
+    bool seekable;
+    HttpReadAhead::ReadFn netRead;
+    HttpReadAhead::SeekFn netSeek;
+    if (m_pooledHttp) {
+        m_readAheadSize = m_pooledHttp->size();
+        seekable = m_pooledHttp->seekable();
+        if (m_parallelConnections > 1 && seekable && m_readAheadSize >= PARALLEL_MIN_BYTES) {
+            // Segment workers make their own range requests; this response is not needed
+            m_pooledHttp.reset();
+            // Aborted with the read-ahead: stop() must not wait for a segment from a stalled server
+            m_parallelReader = std::make_unique<ParallelRangeReader>(
+                *m_httpPool, url, m_readAheadSize, m_parallelConnections,
+                readAheadInterruptCb, m_readAhead.get());
+            ParallelRangeReader* reader = m_parallelReader.get();
+            netRead = [reader](uint8_t* buf, int size) { return reader->read(buf, size); };
+            netSeek = [reader](int64_t pos) { return reader->seek(pos); };
+            DEBUG_LOG("[AudioDecoder] Parallel range download: up to " << m_parallelConnections
+                      << " connections");
+        } else {
+            PooledHttpStream* stream = m_pooledHttp.get();
+            netRead = [stream](uint8_t* buf, int size) { return stream->read(buf, size); };
+            netSeek = [stream](int64_t pos) { return stream->seek(pos); };
+        }
+    } else {
+        // Interrupt lets close() abort a source read blocked on the network
+        AVIOInterruptCB interrupt = { readAheadInterruptCb, m_readAhead.get() };
+        int ret = avio_open2(&m_readAheadHttp, url.c_str(), AVIO_FLAG_READ, &interrupt, options);
+        if (ret < 0) {
+            m_readAhead.reset();
+            return ret;
+        }
+
+        m_readAheadSize = avio_size(m_readAheadHttp);
+        seekable = (m_readAheadHttp->seekable & AVIO_SEEKABLE_NORMAL) != 0;
+
+        AVIOContext* http = m_readAheadHttp;
+        netRead = [http](uint8_t* buf, int size) -> int {
+            int n = avio_read(http, buf, size);
+            return (n == AVERROR_EOF) ? 0 : n;
+        };
+        netSeek = [http](int64_t pos) -> int64_t {
+            return avio_seek(http, pos, SEEK_SET);
+        };
+    }
+    m_activeReadAhead = m_readAhead.get();
+
+    AVIOContext* wrap = allocReadAheadIO(seekable);
+    if (!wrap) {
+        closeReadAhead();
+        return AVERROR(ENOMEM);
+    }
+
+    // Track cache needs random access (Content-Length known, server honours ranges)
+    std::shared_ptr<TrackCache::Entry> entry;
+    if (m_trackCache && seekable) {
+        entry = m_trackCache->acquire(url, m_readAheadSize);
+    }
+    if (entry) {
+        size_t present = entry->blocksPresent();
+        if (entry->complete()) {
+            // Everything is on disk: no network reads for this track
+            avio_closep(&m_readAheadHttp);
+            m_pooledHttp.reset();
+            m_parallelReader.reset();
+            netRead = nullptr;
+            netSeek = nullptr;
+        }
+        std::cout << "[AudioDecoder] Track cache "
+                  << (entry->complete() ? "hit" : (present > 0 ? "partial" : "miss"))
+                  << " (" << present * 100 / entry->numBlocks() << "% on disk)" << std::endl;
+        m_cacheSource = std::make_shared<TrackCache::Source>(entry, std::move(netRead), std::move(netSeek));
+        auto src = m_cacheSource;
+        m_readAhead->start(
+            [src](uint8_t* buf, int size) { return src->read(buf, size); },
+            [src](int64_t pos) { return src->seek(pos); });
+    } else {
+        m_readAhead->start(std::move(netRead), std::move(netSeek));
+    }
+
+    DEBUG_LOG("[AudioDecoder] HTTP read-ahead: " << (ringBytes >> 20) << " MB ring"
+              << (seekable ? "" : " (not seekable)"));
+    *pb = wrap;
+    return 0;
+}
+
+void AudioDecoder::closeReadAhead() {
+    m_activeReadAhead = nullptr;
+    m_memoryCursor.reset();
+    m_memoryTrack.reset();  // RAM copy stays alive while the engine holds it
+    if (m_uring) {
+        UringFileReader::Stats us = m_uring->getStats();
+        DEBUG_LOG("[AudioDecoder] io_uring: " << (us.bytes >> 20) << " MB, " << us.reads
+                  << " block read(s) in " << us.submits << " submission(s), " << us.waits << " wait(s)");
+        m_uring.reset();  // Drains reads still in flight
+    }
+    m_mapped.reset();
+    if (!m_readAhead) {
+        m_readAheadSize = -1;
+        return;
+    }
+
+    m_readAhead->stop();  // Joins the reader thread before its HTTP context goes away
+    HttpReadAhead::Stats st = m_readAhead->getStats();
+    if (st.bytesIn > 0) {
+        double mb = st.bytesIn / 1048576.0;
+        double rate = st.sourceNs > 0 ? mb / (st.sourceNs / 1e9) : 0.0;
+        std::cout << "[AudioDecoder] Read-ahead: " << std::fixed << std::setprecision(1)
+                  << mb << " MB at " << rate << " MB/s, " << st.stalls << " stall(s) ("
+                  << st.stallNs / 1000000 << " ms), " << st.seeks << " seek(s) ("
+                  << st.seeksInBuffer << " in buffer)" << std::defaultfloat << std::endl;
+    }
+    m_readAhead.reset();
+    if (m_cacheSource) {
+        TrackCache::Source::Stats cs = m_cacheSource->getStats();
+        uint64_t total = cs.cacheBytes + cs.networkBytes;
+        if (total > 0) {
+            std::cout << "[AudioDecoder] Track cache: " << cs.cacheBytes * 100 / total
+                      << "% from disk, " << cs.networkSeeks << " range request(s)" << std::endl;
+        }
+        m_cacheSource.reset();  // Entry is written back by the cache thread
+    }
+    if (m_readAheadHttp) {
+        avio_closep(&m_readAheadHttp);
+    }
+    m_pooledHttp.reset();  // Connection goes back to the pool if its response was read to the end
+    if (m_parallelReader) {
+        ParallelRangeReader::Stats ps = m_parallelReader->getStats();
+        std::cout << "[AudioDecoder] Parallel download: " << ps.segments << " segment(s) over up to "
+                  << ps.peakConnections << " connection(s), " << ps.failures << " retried" << std::endl;
+        m_parallelReader.reset();
+    }
+    m_readAheadSize = -1;
+}
+
 bool AudioDecoder::open(const std::string& url) {
     std::cout << "[AudioDecoder] Opening: " << url.substr(0, 80) << "..." << std::endl;
+    auto openStart = std::chrono::steady_clock::now();
     m_decodeError = false;
     m_readTimeout = false;
 
@@ -135,6 +576,7 @@ bool AudioDecoder::open(const std::string& url) {
 
     // Detect format from URL extension (helps FFmpeg when Content-Type is missing/wrong)
     const AVInputFormat* inputFormat = nullptr;
+    bool nativeCandidate = false;  // WAV / AIFF / DSF: try the built-in reader first
     bool isAudirvanaPCM = false;
     // Detect streaming service URLs proxied through local UPnP servers
     // (e.g., Audirvana relays Qobuz/Tidal via http://192.168.x.x/...qobuz...)
@@ -167,6 +609,7 @@ bool AudioDecoder::open(const std::string& url) {
         if (lastComponent.size() >= 4) {
             std::string ext = lastComponent.substr(lastComponent.size() - 4);
             std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            nativeCandidate = (ext == ".wav" || ext == ".dsf" || ext == ".aif" || ext == "aiff");
             if (ext == ".dsf") {
                 inputFormat = av_find_input_format("dsf");
                 if (inputFormat) {
@@ -227,9 +670,56 @@ bool AudioDecoder::open(const std::string& url) {
         av_dict_set(&options, "ignore_eof", "1", 0);
     }
 
+    // Uncompressed containers: built-in reader, FFmpeg only if the header is unusual
+    if (nativeCandidate && !isAudirvanaPCM && openNative(url, options, isLocalServer)) {
+        av_dict_free(&options);
+        avformat_free_context(m_formatContext);
+        m_formatContext = nullptr;
+        return true;
+    }
+
+    // Probed before: name the demuxer now, skip stream-info probing after open
+    StreamProbe probe;
+    bool haveProbe = m_probeCache && !isAudirvanaPCM && m_probeCache->lookup(url, probe);
+    if (haveProbe && !inputFormat) {
+        inputFormat = av_find_input_format(probe.demuxer.substr(0, probe.demuxer.find(',')).c_str());
+    }
+
     int ret;
     AVIOContext* audirvanaWrap = nullptr;
-    if (isAudirvanaPCM) {
+    // Memory play first: the engine started the download at SetURI time
+    AVIOContext* readAheadPb = nullptr;
+    if (m_memoryTrack && m_memoryTrack->uri() == url && !isAudirvanaPCM) {
+        if (openMemoryTrack(&readAheadPb) < 0) {
+            readAheadPb = nullptr;
+            m_memoryTrack.reset();  // Not held in RAM: stream as usual
+        }
+    }
+
+    // Local file: mapped or io_uring read-ahead instead of FFmpeg's blocking file reads
+    if (!readAheadPb && (m_mmap || m_ioUring) && !isAudirvanaPCM && openLocalFile(url, &readAheadPb) < 0) {
+        readAheadPb = nullptr;
+    }
+
+    bool useReadAhead = readAheadPb != nullptr ||
+                        ((m_httpReadAheadBytes > 0 || m_trackCache || m_httpPool) && !isAudirvanaPCM &&
+                         (url.compare(0, 7, "http://") == 0 || url.compare(0, 8, "https://") == 0));
+    if (useReadAhead) {
+        ret = readAheadPb ? 0 : openReadAhead(url, &options, &readAheadPb);
+        if (ret >= 0) {
+            m_formatContext->pb = readAheadPb;
+            m_formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+            // URL still passed: extension-based probing and ->url checks below
+            ret = avformat_open_input(&m_formatContext, url.c_str(), inputFormat, &options);
+            if (ret < 0) {
+                // Custom pb is not freed by avformat_open_input (see Audirvana path)
+                unsigned char* buf = readAheadPb->buffer;
+                avio_context_free(&readAheadPb);
+                av_free(buf);
+                closeReadAhead();
+            }
+        }
+    } else if (isAudirvanaPCM) {
         // FFmpeg's s16be demuxer reads the HTTP Content-Type via av_opt_get on
         // pb, sees "audio/L16" without rate=, and returns AVERROR_INVALIDDATA
         // before our sample_rate/channels options are even consulted. Workaround:
@@ -322,19 +812,22 @@ bool AudioDecoder::open(const std::string& url) {
     // Free unused options
     av_dict_free(&options);
 
-    // Limit probe for local servers: WAV headers are ~44 bytes, no need to
-    // read megabytes. Default probesize (5MB) causes massive concurrent reads
-    // during anticipated preload, saturating Audirvana's HTTP server.
-    if (isLocalServer) {
-        m_formatContext->probesize = 32768;       // 32KB — enough for any WAV/FLAC/DSF header
-        m_formatContext->max_analyze_duration = 0; // Don't analyze beyond header
-    }
+    bool probeHit = haveProbe && applyCachedProbe(url, probe);
+    if (!probeHit) {
+        // Limit probe for local servers: WAV headers are ~44 bytes, no need to
+        // read megabytes. Default probesize (5MB) causes massive concurrent reads
+        // during anticipated preload, saturating Audirvana's HTTP server.
+        if (isLocalServer) {
+            m_formatContext->probesize = 32768;       // 32KB — enough for any WAV/FLAC/DSF header
+            m_formatContext->max_analyze_duration = 0; // Don't analyze beyond header
+        }
 
-    // Retrieve stream information
-    if (avformat_find_stream_info(m_formatContext, nullptr) < 0) {
-        std::cerr << "[AudioDecoder] Failed to find stream info" << std::endl;
-        avformat_close_input(&m_formatContext);
-        return false;
+        // Retrieve stream information
+        if (avformat_find_stream_info(m_formatContext, nullptr) < 0) {
+            std::cerr << "[AudioDecoder] Failed to find stream info" << std::endl;
+            avformat_close_input(&m_formatContext);
+            return false;
+        }
     }
 
     // Log duration information
@@ -430,8 +923,16 @@ bool AudioDecoder::open(const std::string& url) {
         std::cerr << "[AudioDecoder] Failed to open codec" << std::endl;
         avcodec_free_context(&m_codecContext);
         avformat_close_input(&m_formatContext);
+        if (probeHit) m_probeCache->invalidate(url);  // Next open probes again
         return false;
     }
+    if (!probeHit && !isAudirvanaPCM) {
+        storeProbe(url);
+    }
+    auto openMs = [&]() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - openStart).count();
+    };
 
     // Fill track info
     m_trackInfo.sampleRate = codecpar->sample_rate;
@@ -608,7 +1109,8 @@ bool AudioDecoder::open(const std::string& url) {
                 DEBUG_LOG("[AudioDecoder] Pre-allocated DSD buffers: " << DSD_BUFFER_PREALLOC << " bytes/channel");
             }
 
-            std::cout << "[AudioDecoder] Opened successfully (DSD NATIVE)" << std::endl;
+            std::cout << "[AudioDecoder] Opened successfully (DSD NATIVE, " << openMs() << " ms"
+                      << (probeHit ? ", cached stream parameters" : "") << ")" << std::endl;
 
             return true;  // Exit early - no codec opening needed!
         }  // End of else (non-Audirvana DSD native mode)
@@ -781,11 +1283,80 @@ bool AudioDecoder::open(const std::string& url) {
 
     m_eof = false;
 
-    std::cout << "[AudioDecoder] Opened successfully" << std::endl;
+    std::cout << "[AudioDecoder] Opened successfully (" << openMs() << " ms"
+              << (probeHit ? ", cached stream parameters" : "") << ")" << std::endl;
 
     return true;
 }
 
+// Reopen of a probed URI: fill what the demuxer header leaves to probing
+bool AudioDecoder::applyCachedProbe(const std::string& url, const StreamProbe& probe) {
+    int64_t size = m_formatContext->pb ? avio_size(m_formatContext->pb) : -1;
+    if (size != probe.size || std::strcmp(m_formatContext->iformat->name, probe.demuxer.c_str()) != 0 ||
+        probe.streamIndex >= static_cast<int>(m_formatContext->nb_streams) ||
+        m_formatContext->streams[probe.streamIndex]->codecpar->codec_id != probe.codecId) {
+        DEBUG_LOG("[AudioDecoder] Cached stream parameters are stale, probing");
+        m_probeCache->invalidate(url);
+        return false;
+    }
+
+    AVStream* st = m_formatContext->streams[probe.streamIndex];
+    AVCodecParameters* par = st->codecpar;
+    if (par->extradata_size == 0 && !probe.extradata.empty()) {
+        par->extradata = static_cast<uint8_t*>(
+            av_mallocz(probe.extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (!par->extradata) return false;
+        std::memcpy(par->extradata, probe.extradata.data(), probe.extradata.size());
+        par->extradata_size = static_cast<int>(probe.extradata.size());
+    }
+    if (par->sample_rate <= 0) par->sample_rate = probe.sampleRate;
+    if (par->ch_layout.nb_channels <= 0) {
+        av_channel_layout_uninit(&par->ch_layout);
+        av_channel_layout_default(&par->ch_layout, probe.channels);
+    }
+    if (par->format < 0) par->format = probe.format;
+    if (par->bits_per_coded_sample == 0) par->bits_per_coded_sample = probe.bitsPerCodedSample;
+    if (par->bits_per_raw_sample == 0) par->bits_per_raw_sample = probe.bitsPerRawSample;
+    if (par->block_align == 0) par->block_align = probe.blockAlign;
+    if (par->frame_size == 0) par->frame_size = probe.frameSize;
+    if (par->bit_rate == 0) par->bit_rate = probe.bitRate;
+    if (probe.durationUs >= 0) {
+        if (st->duration == AV_NOPTS_VALUE) {
+            st->duration = av_rescale_q(probe.durationUs, AV_TIME_BASE_Q, st->time_base);
+        }
+        if (m_formatContext->duration == AV_NOPTS_VALUE) m_formatContext->duration = probe.durationUs;
+    }
+    DEBUG_LOG("[AudioDecoder] Stream parameters from probe cache (" << probe.demuxer << ")");
+    return true;
+}
+
+void AudioDecoder::storeProbe(const std::string& url) {
+    if (!m_probeCache || !m_formatContext->pb) return;
+    const AVStream* st = m_formatContext->streams[m_audioStreamIndex];
+    const AVCodecParameters* par = st->codecpar;
+
+    StreamProbe p;
+    p.demuxer = m_formatContext->iformat->name;
+    p.size = avio_size(m_formatContext->pb);
+    p.streamIndex = m_audioStreamIndex;
+    p.codecId = par->codec_id;
+    p.format = par->format;
+    p.sampleRate = par->sample_rate;
+    p.channels = par->ch_layout.nb_channels;
+    p.bitsPerCodedSample = par->bits_per_coded_sample;
+    p.bitsPerRawSample = par->bits_per_raw_sample;
+    p.blockAlign = par->block_align;
+    p.frameSize = par->frame_size;
+    p.bitRate = par->bit_rate;
+    if (par->extradata_size > 0) p.extradata.assign(par->extradata, par->extradata + par->extradata_size);
+    if (st->duration != AV_NOPTS_VALUE) {
+        p.durationUs = av_rescale_q(st->duration, st->time_base, AV_TIME_BASE_Q);
+    } else if (m_formatContext->duration != AV_NOPTS_VALUE) {
+        p.durationUs = m_formatContext->duration;
+    }
+    m_probeCache->store(url, std::move(p));
+}
+
 // ============================================================================
 // DSDIFF/DFF Parser - Bypasses FFmpeg demuxer (which has no DSDIFF support)
 // Uses FFmpeg's avio for HTTP I/O, parses DSDIFF container manually.
@@ -868,6 +1439,8 @@ bool AudioDecoder::openDFF(const std::string& url) {
     uint16_t channels = 0;
     bool foundData = false;
     int64_t dataSize = 0;
+    bool dst = false;            // CMPR "DST ": data is a "DST " chunk of DSTF frames
+    uint32_t dstFrames = 0;
 
     // Read position after FRM8 header (16 bytes: tag4 + size8 + formtype4)
     int64_t containerEnd = 16 + frm8Size - 4;  // -4 because formtype is inside size
@@ -906,12 +1479,16 @@ bool AudioDecoder::openDFF(const std::string& url) {
                     std::cout << "[AudioDecoder] DFF: Channels = " << channels << std::endl;
                 } else if (subTag == 0x434D5052) {  // "CMPR"
                     uint32_t cmpr = dff_read_tag(m_dffIO);
-                    if (cmpr != 0x44534420) {  // "DSD "
-                        std::cerr << "[AudioDecoder] DFF: Compressed DSDIFF (DST) not supported" << std::endl;
+                    if (cmpr == 0x44535420) {  // "DST "
+                        dst = true;
+                        DEBUG_LOG("[AudioDecoder] DFF: Compression = DST");
+                    } else if (cmpr != 0x44534420) {  // "DSD "
+                        std::cerr << "[AudioDecoder] DFF: Unknown compression type" << std::endl;
                         avio_closep(&m_dffIO);
                         return false;
+                    } else {
+                        DEBUG_LOG("[AudioDecoder] DFF: Compression = DSD (uncompressed)");
                     }
-                    DEBUG_LOG("[AudioDecoder] DFF: Compression = DSD (uncompressed)");
                 }
 
                 // Skip to end of sub-chunk
@@ -921,10 +1498,33 @@ bool AudioDecoder::openDFF(const std::string& url) {
 
         } else if (chunkTag == 0x44534420) {  // "DSD " (data chunk)
             dataSize = chunkSize;
+            m_dffDataStart = chunkStart;
             foundData = true;
             std::cout << "[AudioDecoder] DFF: DSD data chunk, size=" << dataSize << " bytes" << std::endl;
             break;  // Stop here - data follows immediately
 
+        } else if (chunkTag == 0x44535420 && dst) {  // "DST " (compressed data chunk)
+            // FRTE (frame count + frame rate) comes first, DSTF/DSTC frame chunks follow
+            uint32_t frteTag = dff_read_tag(m_dffIO);
+            int64_t frteSize = dff_read_size(m_dffIO);
+            if (frteTag != 0x46525445 || frteSize < 6) {  // "FRTE"
+                std::cerr << "[AudioDecoder] DFF: DST chunk without FRTE" << std::endl;
+                break;
+            }
+            dstFrames = dff_read_u32(m_dffIO);
+            uint16_t frameRate = dff_read_u16(m_dffIO);
+            if (frteSize > 6) avio_skip(m_dffIO, frteSize - 6);
+            if (frameRate != 75) {
+                std::cerr << "[AudioDecoder] DFF: Unsupported DST frame rate " << frameRate << std::endl;
+                break;
+            }
+            m_dffDataStart = avio_tell(m_dffIO);
+            dataSize = chunkSize - (m_dffDataStart - chunkStart);
+            foundData = true;
+            std::cout << "[AudioDecoder] DFF: DST data chunk, " << dstFrames << " frames, "
+                      << dataSize << " bytes" << std::endl;
+            break;
+
         } else {
             // Skip unknown chunks (FVER, DIIN, etc.)
             DEBUG_LOG("[AudioDecoder] DFF: Skipping chunk 0x" << std::hex << chunkTag
@@ -956,10 +1556,35 @@ bool AudioDecoder::openDFF(const std::string& url) {
         m_trackInfo.duration = (dataSize * 8) / channels;  // Total DSD samples
     }
 
+    if (dst) {
+        if (channels < 2 || channels > DstFrameDecoder::MAX_CHANNELS || sampleRate % 600 != 0) {
+            std::cerr << "[AudioDecoder] DFF: Unsupported DST layout (" << channels << "ch "
+                      << sampleRate << "Hz)" << std::endl;
+            avio_closep(&m_dffIO);
+            return false;
+        }
+        m_dstBytesPerChannel = sampleRate / 75 / 8;
+        m_trackInfo.duration = static_cast<uint64_t>(dstFrames) * (sampleRate / 75);
+
+        unsigned threads = m_dstThreads;
+        if (threads == 0) {
+            threads = std::min(4u, std::max(1u, std::thread::hardware_concurrency() / 2));
+        }
+        m_dstPool = std::make_unique<DstFramePool>(threads, channels, m_dstBytesPerChannel, m_dstCores);
+        m_dstFramePos = m_dstFrameValid = 0;
+    }
+
     // ── Activate DFF mode ──
     m_rawDSD = true;
     m_dffMode = true;
     m_dffDataRemaining = dataSize;
+    m_dffDataSize = dataSize;
+    m_dstFrames = dstFrames;
+    m_dstFrameNumber = 0;
+    m_dstFrameExact = true;
+    m_dstIndexLoaded = false;
+    m_dstIndex.clear();
+    m_dstFrameSkip = 0;
     m_eof = false;
 
     // Pre-allocate DSD buffers
@@ -974,14 +1599,463 @@ bool AudioDecoder::openDFF(const std::string& url) {
     std::cout << "[AudioDecoder] DSD NATIVE MODE (DFF/DSDIFF parser)" << std::endl;
     std::cout << "[AudioDecoder]   DSD" << m_trackInfo.dsdRate
               << " " << sampleRate << "Hz " << channels << "ch" << std::endl;
-    std::cout << "[AudioDecoder]   Data: " << dataSize << " bytes"
-              << " (" << (dataSize / (channels * sampleRate / 8)) << "s)" << std::endl;
+    if (m_dstPool) {
+        std::cout << "[AudioDecoder]   DST: " << dstFrames << " frames"
+                  << " (" << (dstFrames / 75) << "s), " << m_dstPool->workers()
+                  << " decode threads" << std::endl;
+    } else {
+        std::cout << "[AudioDecoder]   Data: " << dataSize << " bytes"
+                  << " (" << (dataSize / (channels * sampleRate / 8)) << "s)" << std::endl;
+    }
     std::cout << "[AudioDecoder] ════════════════════════════════════════" << std::endl;
 
     return true;
 }
 
+void AudioDecoder::fillDstPool() {
+    // Keep every worker busy with one frame plus one queued behind it
+    size_t target = 2 * m_dstPool->workers();
+    while (m_dstPool->inFlight() < target && m_dffDataRemaining >= 12) {
+        int64_t chunkPos = avio_tell(m_dffIO);
+        uint32_t tag = dff_read_tag(m_dffIO);
+        int64_t size = dff_read_size(m_dffIO);
+        if (size < 0 || avio_feof(m_dffIO) || 12 + size > m_dffDataRemaining) {
+            m_dffDataRemaining = 0;
+            break;
+        }
+        int64_t padded = size + (size & 1);  // Chunks are even-aligned
+        m_dffDataRemaining -= 12 + std::min(padded, m_dffDataRemaining - 12);
+
+        if (tag != 0x44535446) {  // Not "DSTF" (DSTC checksums): skip
+            avio_skip(m_dffIO, padded);
+            continue;
+        }
+        if (m_dstFrameExact) m_dstIndex.add(m_dstFrameNumber, chunkPos);
+        m_dstFrameNumber++;
+        m_dstChunk.resize(static_cast<size_t>(size));
+        if (avio_read(m_dffIO, m_dstChunk.data(), static_cast<int>(size)) != size) {
+            m_dffDataRemaining = 0;
+            break;
+        }
+        if (padded != size) avio_skip(m_dffIO, 1);
+        m_dstPool->submit(m_dstChunk.data(), m_dstChunk.size());
+        m_packetCount++;
+    }
+}
+
+size_t AudioDecoder::readDst(uint8_t* left, uint8_t* right, size_t bytesPerChannel) {
+    size_t done = 0;
+    while (done < bytesPerChannel) {
+        if (m_dstFramePos >= m_dstFrameValid) {
+            fillDstPool();
+            if (!m_dstPool->next(m_dstFrame)) {
+                m_eof = true;
+                break;
+            }
+            m_dstFramePos = std::min(m_dstFrameSkip, m_dstBytesPerChannel);  // Seek into the frame
+            m_dstFrameSkip = 0;
+            m_dstFrameValid = m_dstBytesPerChannel;
+        }
+        // Planar frame: channel 0, then channel 1 (further channels are dropped)
+        size_t n = std::min(bytesPerChannel - done, m_dstFrameValid - m_dstFramePos);
+        memcpy(left + done, m_dstFrame.data() + m_dstFramePos, n);
+        memcpy(right + done, m_dstFrame.data() + m_dstBytesPerChannel + m_dstFramePos, n);
+        m_dstFramePos += n;
+        done += n;
+    }
+    return done;
+}
+
+void AudioDecoder::loadDstIndex() {
+    m_dstIndexLoaded = true;
+
+    // Optional "DSTI" chunk after the "DST " chunk: per frame, offset (8) + length (4)
+    int64_t pos = m_dffDataStart + m_dffDataSize;
+    pos += pos & 1;
+    if (avio_seek(m_dffIO, pos, SEEK_SET) < 0) return;
+    uint32_t tag = dff_read_tag(m_dffIO);
+    int64_t size = dff_read_size(m_dffIO);
+    if (tag != 0x44535449 || size < 12) {  // "DSTI"
+        DEBUG_LOG("[AudioDecoder] DFF: no DSTI index, frames are indexed while read");
+        return;
+    }
+
+    // Writers point either at the DSTF chunk or at its data: frame 0 tells which
+    uint64_t entries = static_cast<uint64_t>(size) / 12;
+    int64_t delta = 0;
+    for (uint64_t i = 0; i < entries && !avio_feof(m_dffIO); i++) {
+        int64_t offset = dff_read_size(m_dffIO);
+        dff_read_u32(m_dffIO);  // Frame length
+        if (offset < 0) break;
+        if (i == 0) {
+            delta = m_dffDataStart - offset;
+            if (delta != 0 && delta != -12) {
+                std::cerr << "[AudioDecoder] DFF: DSTI index does not match the DST chunk, ignored" << std::endl;
+                return;
+            }
+        }
+        m_dstIndex.add(i, offset + delta);
+    }
+    std::cout << "[AudioDecoder] DFF: DSTI index, " << entries << " frames" << std::endl;
+}
+
+bool AudioDecoder::resyncDstFrame(int64_t offset) {
+    // A DSTF header whose size leads to the next frame (or DSTC) header
+    size_t maxChunk = m_dstBytesPerChannel * m_trackInfo.channels + 64;
+    std::vector<uint8_t> buf(2 * (maxChunk + 12) + 4);
+    if (avio_seek(m_dffIO, offset, SEEK_SET) < 0) return false;
+    int n = avio_read(m_dffIO, buf.data(), static_cast<int>(buf.size()));
+    if (n < 16) return false;
+
+    auto be = [&](size_t at, int bytes) {
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; i++) v = (v << 8) | buf[at + i];
+        return v;
+    };
+    for (size_t i = 0; i + 12 <= static_cast<size_t>(n); i++) {
+        if (be(i, 4) != 0x44535446) continue;  // "DSTF"
+        uint64_t size = be(i + 4, 8);
+        if (size == 0 || size > maxChunk) continue;
+        size_t next = i + 12 + static_cast<size_t>(size + (size & 1));
+        if (next + 4 > static_cast<size_t>(n)) break;
+        uint32_t nextTag = static_cast<uint32_t>(be(next, 4));
+        if (nextTag != 0x44535446 && nextTag != 0x44535443) continue;  // "DSTF" / "DSTC"
+
+        int64_t found = offset + static_cast<int64_t>(i);
+        if (avio_seek(m_dffIO, found, SEEK_SET) < 0) return false;
+        m_dffDataRemaining = m_dffDataStart + m_dffDataSize - found;
+        return true;
+    }
+    return false;
+}
+
+bool AudioDecoder::seekDFF(double seconds) {
+    if (!m_dffIO || !(m_dffIO->seekable & AVIO_SEEKABLE_NORMAL)) {
+        std::cerr << "[AudioDecoder] DFF: source not seekable" << std::endl;
+        return false;
+    }
+    uint32_t channels = m_trackInfo.channels;
+    // Per channel, 8 DSD samples per byte (MSB first)
+    uint64_t byte = static_cast<uint64_t>(std::max(0.0, seconds) * m_trackInfo.sampleRate / 8);
+    int64_t offset;
+
+    if (!m_dstPool) {
+        byte = std::min(byte, static_cast<uint64_t>(m_dffDataSize) / channels);
+        offset = m_dffDataStart + static_cast<int64_t>(byte * channels);
+        if (avio_seek(m_dffIO, offset, SEEK_SET) < 0) return false;
+        m_dffDataRemaining = m_dffDataSize - static_cast<int64_t>(byte * channels);
+    } else {
+        uint64_t frame = byte / m_dstBytesPerChannel;
+        if (m_dstFrames > 0) frame = std::min<uint64_t>(frame, m_dstFrames - 1);
+        if (!m_dstIndexLoaded) loadDstIndex();
+
+        m_dstPool->reset();
+        m_dstFramePos = m_dstFrameValid = 0;
+        m_dstFrameSkip = static_cast<size_t>(std::min(byte - frame * m_dstBytesPerChannel,
+                                                      static_cast<uint64_t>(m_dstBytesPerChannel)));
+
+        SeekIndex::Point from{0, m_dffDataStart};
+        m_dstIndex.floor(frame, from);
+        bool estimated = false;
+        if (frame - from.position > DST_WALK_LIMIT && m_dstFrames > 0) {
+            // Far past anything indexed: start at the proportional byte position
+            offset = m_dffDataStart + static_cast<int64_t>(
+                static_cast<double>(frame) / m_dstFrames * static_cast<double>(m_dffDataSize));
+            estimated = resyncDstFrame(offset);
+        }
+        if (estimated) {
+            m_dstFrameNumber = frame;
+            m_dstFrameExact = false;
+            offset = avio_tell(m_dffIO);
+        } else {
+            // Walk frame headers from the nearest indexed frame
+            if (avio_seek(m_dffIO, from.offset, SEEK_SET) < 0) return false;
+            m_dffDataRemaining = m_dffDataStart + m_dffDataSize - from.offset;
+            m_dstFrameNumber = from.position;
+            m_dstFrameExact = true;
+            while (m_dstFrameNumber < frame && m_dffDataRemaining >= 12) {
+                int64_t chunkPos = avio_tell(m_dffIO);
+                uint32_t tag = dff_read_tag(m_dffIO);
+                int64_t size = dff_read_size(m_dffIO);
+                if (size < 0 || avio_feof(m_dffIO) || 12 + size > m_dffDataRemaining) {
+                    m_dffDataRemaining = 0;
+                    break;
+                }
+                int64_t padded = size + (size & 1);
+                m_dffDataRemaining -= 12 + std::min(padded, m_dffDataRemaining - 12);
+                if (tag == 0x44535446) {  // "DSTF"
+                    m_dstIndex.add(m_dstFrameNumber, chunkPos);
+                    m_dstFrameNumber++;
+                }
+                avio_skip(m_dffIO, padded);
+            }
+            offset = avio_tell(m_dffIO);
+        }
+        std::cout << "[AudioDecoder] DFF: DST seek to frame " << frame
+                  << (estimated ? " (estimated from the byte position)" : "") << std::endl;
+    }
+
+    dsdRemainderClear();
+    m_eof = false;
+    m_packetCount = 0;
+    std::cout << "[AudioDecoder] DFF seek to " << seconds << "s (byte " << offset << ")" << std::endl;
+    return true;
+}
+
+bool AudioDecoder::openNative(const std::string& url, AVDictionary* options, bool isLocalServer) {
+    // Same source stack as the FFmpeg path: memory play, read-ahead/cache, mmap/io_uring, or plain I/O
+    std::shared_ptr<MemoryTrack> memory = m_memoryTrack;
+    bool http = url.compare(0, 7, "http://") == 0 || url.compare(0, 8, "https://") == 0;
+    AVDictionary* opts = nullptr;
+    av_dict_copy(&opts, options, 0);  // The FFmpeg fallback still needs the originals
+
+    int ret = -1;
+    if (m_memoryTrack && m_memoryTrack->uri() == url) {
+        ret = openMemoryTrack(&m_nativeIO);
+    }
+    if (ret < 0 && http && (m_httpReadAheadBytes > 0 || m_trackCache || m_httpPool)) {
+        ret = openReadAhead(url, &opts, &m_nativeIO);
+    }
+    if (ret < 0 && !http && (m_mmap || m_ioUring)) {
+        ret = openLocalFile(url, &m_nativeIO);
+    }
+    m_nativeCustomIO = (ret >= 0);
+    if (ret < 0) {
+        m_nativeIO = nullptr;
+        AVIOInterruptCB interrupt = { ffmpegReadInterruptCb, this };
+        ret = avio_open2(&m_nativeIO, url.c_str(), AVIO_FLAG_READ, &interrupt, &opts);
+    }
+    av_dict_free(&opts);
+    if (ret < 0) {
+        m_nativeIO = nullptr;
+        m_memoryTrack = memory;
+        return false;
+    }
+
+    std::vector<uint8_t> header(NATIVE_PROBE_BYTES);
+    int n = avio_read(m_nativeIO, header.data(), static_cast<int>(header.size()));
+    NativeLayout layout;
+    if (n <= 0 || !parseNativeHeader(header.data(), static_cast<size_t>(n), layout) ||
+        !nativeSeekTo(layout.dataOffset)) {
+        std::cout << "[AudioDecoder] Native reader: unsupported header, using FFmpeg" << std::endl;
+        releaseNativeIO();
+        closeReadAhead();
+        m_memoryTrack = memory;  // Dropped by closeReadAhead(), still valid for FFmpeg
+        return false;
+    }
+
+    m_native = layout;
+    m_nativeMode = true;
+    m_eof = false;
+    m_trackInfo.sampleRate = layout.sampleRate;
+    m_trackInfo.channels = layout.channels;
+    m_trackInfo.duration = layout.frames;
+    m_trackInfo.isCompressed = false;
+    m_trackInfo.isRemoteStream = !isLocalServer;
+
+    if (layout.kind == NativeLayout::Kind::DSF) {
+        m_rawDSD = true;
+        m_trackInfo.isDSD = true;
+        m_trackInfo.bitDepth = 1;
+        m_trackInfo.dsdRate = layout.sampleRate / 44100;
+        m_trackInfo.codec = layout.dsdMsbFirst ? "dsd_msbf_planar" : "dsd_lsbf_planar";
+        // Bit order for the ring buffer: DSF is LSB-first unless bitsPerSample says 8
+        m_trackInfo.dsdSourceFormat = layout.dsdMsbFirst ? TrackInfo::DSDSourceFormat::DFF
+                                                         : TrackInfo::DSDSourceFormat::DSF;
+        m_nativeRemaining = static_cast<int64_t>((layout.frames + 7) / 8);
+        m_nativeBlockPos = m_nativeBlockValid = m_nativeBlockSkip = 0;
+        m_nativeBlock = nullptr;
+        if (!m_mapped) {   // Mapped: block pairs are used in place
+            m_nativeScratch.resize(static_cast<size_t>(layout.dsfBlockSize) * layout.channels);
+        }
+        std::cout << "[AudioDecoder] Native DSF reader: DSD" << m_trackInfo.dsdRate << " "
+                  << layout.channels << "ch, " << layout.dsfBlockSize << "-byte blocks"
+                  << (m_mapped ? " (mapped)" : "") << std::endl;
+    } else {
+        m_rawDSD = false;
+        m_trackInfo.isDSD = false;
+        m_trackInfo.bitDepth = layout.bitsPerSample;
+        m_trackInfo.codec = std::string("pcm_s") + std::to_string(layout.bitsPerSample) +
+                            (layout.bigEndian ? "be" : "le");
+        // 24-bit is output in S32 with the sample in the upper bytes, like FFmpeg's pcm_s24
+        m_trackInfo.s24Alignment = layout.bitsPerSample == 24 ? TrackInfo::S24Alignment::MsbAligned
+                                                              : TrackInfo::S24Alignment::Unknown;
+        m_nativeRemaining = layout.dataSize;
+        std::cout << "[AudioDecoder] Native " << (layout.kind == NativeLayout::Kind::WAV ? "WAV" : "AIFF")
+                  << " reader: " << layout.sampleRate << "Hz/" << layout.bitsPerSample << "bit/"
+                  << layout.channels << "ch" << (m_mapped ? " (mapped)" : "") << std::endl;
+    }
+    return true;
+}
+
+void AudioDecoder::releaseNativeIO() {
+    if (m_nativeIO) {
+        if (m_nativeCustomIO) {
+            // Wrapper around the read-ahead ring (closeReadAhead() stops the ring)
+            unsigned char* buf = m_nativeIO->buffer;
+            avio_context_free(&m_nativeIO);
+            av_free(buf);
+        } else {
+            avio_closep(&m_nativeIO);
+        }
+    }
+    m_nativeIO = nullptr;
+    m_nativeCustomIO = false;
+    m_nativeMode = false;
+    m_nativeBlock = nullptr;
+    std::vector<uint8_t>().swap(m_nativeScratch);
+}
+
+bool AudioDecoder::nativeSeekTo(int64_t offset) {
+    // Mapped reads bypass the AVIO buffer, whose position is stale: move the mapping
+    if (m_mapped) return m_mapped->seek(offset) >= 0;
+    return avio_seek(m_nativeIO, offset, SEEK_SET) >= 0;
+}
+
+const uint8_t* AudioDecoder::nativeView(uint8_t* scratch, size_t size, size_t& got) {
+    if (m_mapped) {
+        const uint8_t* p = m_mapped->view(size, got);
+        if (got < size) m_eof = true;
+        return p;
+    }
+    got = nativeReadFully(scratch, size);
+    return scratch;
+}
+
+size_t AudioDecoder::nativeReadFully(uint8_t* dst, size_t size) {
+    size_t got = 0;
+    while (got < size) {
+        // Same 20s stall deadline as av_read_frame() on the FFmpeg path
+        m_readDeadlineNs.store(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                (std::chrono::steady_clock::now() + std::chrono::seconds(READ_STALL_TIMEOUT_S)).time_since_epoch()
+            ).count(), std::memory_order_relaxed);
+        int n = avio_read(m_nativeIO, dst + got, static_cast<int>(size - got));
+        m_readDeadlineNs.store(0, std::memory_order_relaxed);
+        if (n <= 0) {
+            if (n == AVERROR_EXIT) {
+                std::cerr << "[AudioDecoder] Native: Read timeout — stream stalled" << std::endl;
+                m_readTimeout = true;
+            } else {
+                if (n < 0 && n != AVERROR_EOF) {
+                    char errbuf[AV_ERROR_MAX_STRING_SIZE];
+                    av_strerror(n, errbuf, sizeof(errbuf));
+                    std::cerr << "[AudioDecoder] Native: Read error (" << n << "): " << errbuf << std::endl;
+                }
+                m_eof = true;
+            }
+            break;
+        }
+        got += static_cast<size_t>(n);
+    }
+    return got;
+}
+
+size_t AudioDecoder::readNative(AudioBuffer& buffer, size_t numSamples) {
+    if (m_eof || m_readTimeout) {
+        return 0;
+    }
+
+    if (m_native.kind == NativeLayout::Kind::DSF) {
+        // Output [all L][all R]: both planes go straight to their place in the buffer
+        size_t perChNeeded = numSamples / 8;
+        size_t blockSize = m_native.dsfBlockSize;
+        if (buffer.size() < 2 * perChNeeded) buffer.resize(2 * perChNeeded);
+        uint8_t* left = buffer.data();
+        uint8_t* right = buffer.data() + perChNeeded;
+
+        size_t got = 0;
+        while (got < perChNeeded) {
+            if (m_nativeBlockPos >= m_nativeBlockValid) {
+                if (m_nativeRemaining <= 0) {
+                    m_eof = true;
+                    break;
+                }
+                // File layout: [blockSize L][blockSize R] per block pair
+                size_t pair;
+                m_nativeBlock = nativeView(m_nativeScratch.data(), 2 * blockSize, pair);
+                if (pair < 2 * blockSize) break;
+                m_nativeBlockValid = std::min(blockSize, static_cast<size_t>(m_nativeRemaining));
+                m_nativeRemaining -= static_cast<int64_t>(m_nativeBlockValid);
+                m_nativeBlockPos = std::min(m_nativeBlockSkip, m_nativeBlockValid);
+                m_nativeBlockSkip = 0;
+                continue;
+            }
+            size_t take = std::min(perChNeeded - got, m_nativeBlockValid - m_nativeBlockPos);
+            memcpy_audio(left + got, m_nativeBlock + m_nativeBlockPos, take);
+            memcpy_audio(right + got, m_nativeBlock + blockSize + m_nativeBlockPos, take);
+            m_nativeBlockPos += take;
+            got += take;
+        }
+        if (got > 0 && got < perChNeeded) {
+            memmove(left + got, right, got);  // Short read (end of track): close the gap
+        }
+        if (m_nativeRemaining <= 0 && m_nativeBlockPos >= m_nativeBlockValid) {
+            m_eof = true;
+        }
+        return got * 8;
+    }
+
+    // PCM: 16/32-bit little-endian is read straight into the output buffer;
+    // mapped sources are converted from the page cache into it
+    size_t frameIn = m_native.blockAlign;
+    size_t frameOut = ((m_native.bitsPerSample == 16) ? 2 : 4) * m_native.channels;
+    size_t frames = std::min(numSamples, static_cast<size_t>(m_nativeRemaining) / frameIn);
+    if (frames == 0) {
+        m_eof = true;
+        return 0;
+    }
+    if (buffer.size() < numSamples * frameOut) buffer.resize(numSamples * frameOut);
+
+    uint8_t* dst = buffer.data();
+    if (frameIn != frameOut && !m_mapped) {
+        if (m_nativeScratch.size() < frames * frameIn) m_nativeScratch.resize(frames * frameIn);
+        dst = m_nativeScratch.data();
+    }
+    size_t bytes;
+    const uint8_t* src = nativeView(dst, frames * frameIn, bytes);
+    size_t got = bytes / frameIn;
+    nativePcmToOutput(src, buffer.data(), got * m_native.channels, m_native);
+    m_nativeRemaining -= static_cast<int64_t>(got * frameIn);
+    if (m_nativeRemaining < static_cast<int64_t>(frameIn)) {
+        m_eof = true;
+    }
+    return got;
+}
+
+bool AudioDecoder::seekNative(double seconds) {
+    if (!m_nativeIO || !(m_nativeIO->seekable & AVIO_SEEKABLE_NORMAL)) {
+        std::cerr << "[AudioDecoder] Native: source not seekable" << std::endl;
+        return false;
+    }
+    uint64_t frame = static_cast<uint64_t>(std::max(0.0, seconds) * m_native.sampleRate);
+    frame = std::min(frame, m_native.frames);
+
+    int64_t offset;
+    if (m_native.kind == NativeLayout::Kind::DSF) {
+        // Whole block pairs from the data start, then skip into the pair
+        uint64_t byte = frame / 8;
+        uint64_t block = byte / m_native.dsfBlockSize;
+        offset = m_native.dataOffset +
+                 static_cast<int64_t>(block * m_native.dsfBlockSize * m_native.channels);
+        if (!nativeSeekTo(offset)) return false;
+        m_nativeRemaining = static_cast<int64_t>((m_native.frames + 7) / 8 - block * m_native.dsfBlockSize);
+        m_nativeBlockPos = m_nativeBlockValid = 0;
+        m_nativeBlockSkip = static_cast<size_t>(byte % m_native.dsfBlockSize);
+    } else {
+        offset = m_native.dataOffset + static_cast<int64_t>(frame * m_native.blockAlign);
+        if (!nativeSeekTo(offset)) return false;
+        m_nativeRemaining = m_native.dataSize - static_cast<int64_t>(frame * m_native.blockAlign);
+    }
+    m_eof = false;
+    std::cout << "[AudioDecoder] Native seek to " << seconds << "s (byte " << offset << ")" << std::endl;
+    return true;
+}
+
 void AudioDecoder::close() {
+    stopDecodeAhead();  // Worker uses everything below
+    stopDemux(true);
+    clearPreroll();
     if (m_swrContext) {
         swr_free(&m_swrContext);
     }
@@ -998,6 +2072,8 @@ void AudioDecoder::close() {
         av_audio_fifo_free(m_pcmFifo);
         m_pcmFifo = nullptr;
     }
+    m_dstPool.reset();  // Joins the DST workers
+    m_dstFramePos = m_dstFrameValid = 0;
     if (m_dffIO) {  // Close DFF/DSDIFF I/O context
         avio_closep(&m_dffIO);
     }
@@ -1018,11 +2094,15 @@ void AudioDecoder::close() {
     if (m_audirvanaHttp) {  // Close inner HTTP context (Audirvana PCM workaround)
         avio_closep(&m_audirvanaHttp);
     }
+    releaseNativeIO();
+    closeReadAhead();  // Custom pb already freed above
     m_audioStreamIndex = -1;
     m_eof = false;
     m_rawDSD = false;
     m_dffMode = false;
     m_dffDataRemaining = 0;
+    m_dstIndex.clear();
+    m_seekTrimPending = false;
     m_resampleBufferCapacity = 0;  // Reset capacity tracking
     m_dsdBufferCapacity = 0;       // Reset DSD buffer capacity tracking
     dsdRemainderClear();           // Reset DSD packet remainder ring
@@ -1032,8 +2112,224 @@ void AudioDecoder::close() {
     m_delayRefreshCounter = 0;
 }
 
+void AudioDecoder::startDecodeAhead(uint32_t outputRate, uint32_t outputBits) {
+    if (m_decodeAhead || m_decodeAheadBytes == 0 || m_rawDSD || !m_codecContext) return;
+
+    // Same frame size decodeSamples() produces (24-bit in S32 containers)
+    size_t frameBytes = ((outputBits == 16) ? 2 : 4) * m_trackInfo.channels;
+    if (frameBytes == 0) return;
+    m_decodeAhead = std::make_unique<DecodeAhead>(m_decodeAheadBytes, frameBytes);
+    m_decodeAhead->start([this, outputRate, outputBits](const uint8_t** data) -> size_t {
+        if (m_decodeError || m_readTimeout) return 0;  // Surfaced once the FIFO drains
+        size_t frames = decodeSamples(m_decodeAheadChunk, DECODE_AHEAD_CHUNK_FRAMES,
+                                      outputRate, outputBits);
+        *data = m_decodeAheadChunk.data();
+        return frames * m_decodeAhead->frameBytes();
+    }, m_decodeAheadCores);
+    DEBUG_LOG("[AudioDecoder] Decode-ahead: " << (m_decodeAheadBytes >> 20) << " MB FIFO");
+}
+
+void AudioDecoder::stopDecodeAhead() {
+    if (!m_decodeAhead) return;
+    m_decodeAhead->stop();
+    DecodeAhead::Stats st = m_decodeAhead->getStats();
+    if (st.bytesOut > 0) {
+        DEBUG_LOG("[AudioDecoder] Decode-ahead: " << (st.bytesOut >> 20) << " MB played, "
+                  << st.waits << " wait(s) for the worker");
+    }
+    m_decodeAhead.reset();
+}
+
+int AudioDecoder::readPacketDirect(AVPacket* pkt) {
+    // 20s deadline so av_read_frame() cannot block indefinitely (live streams
+    // via a proxy that keeps TCP alive with no audio data)
+    m_readDeadlineNs.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (std::chrono::steady_clock::now() + std::chrono::seconds(READ_STALL_TIMEOUT_S)).time_since_epoch()
+        ).count(), std::memory_order_relaxed);
+    int ret = av_read_frame(m_formatContext, pkt);
+    m_readDeadlineNs.store(0, std::memory_order_relaxed);
+    return ret;
+}
+
+int AudioDecoder::nextPacket(AVPacket* pkt) {
+    if (m_demuxPackets == 0) return readPacketDirect(pkt);
+    if (m_demuxEnd < 0) return m_demuxEnd;
+    if (!m_demuxThread.joinable() && !startDemux()) return readPacketDirect(pkt);
+
+    DemuxEntry entry;
+    if (!m_demuxFilled->tryPop(entry)) {
+        m_demuxDecoderWaits.fetch_add(1, std::memory_order_relaxed);
+        if (!m_demuxFilled->pop(entry, m_demuxStop)) return AVERROR_EXIT;
+    }
+    m_demuxDepth.store(m_demuxFilled->size(), std::memory_order_relaxed);
+    if (entry.ret < 0) {
+        m_demuxEnd = entry.ret;
+        return entry.ret;
+    }
+    av_packet_move_ref(pkt, entry.packet);
+    m_demuxFree->tryPush(entry);   // Never full: it holds at most the whole pool
+    return 0;
+}
+
+bool AudioDecoder::startDemux() {
+    m_demuxFilled = std::make_unique<SpscQueue<DemuxEntry>>(m_demuxPackets + 1);  // + end entry
+    m_demuxFree = std::make_unique<SpscQueue<DemuxEntry>>(m_demuxPackets);
+    for (size_t i = 0; i < m_demuxPackets; i++) {
+        AVPacket* pkt = av_packet_alloc();
+        if (!pkt) break;
+        m_demuxPool.push_back(pkt);
+        m_demuxFree->tryPush({pkt, 0});
+    }
+    if (m_demuxPool.empty()) {
+        std::cerr << "[AudioDecoder] Failed to allocate demux packets, reading on the decode thread" << std::endl;
+        m_demuxFilled.reset();
+        m_demuxFree.reset();
+        m_demuxPackets = 0;
+        m_demuxCapacity.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    m_demuxStop.store(false, std::memory_order_release);
+    m_demuxThread = std::thread(&AudioDecoder::demuxLoop, this);
+    return true;
+}
+
+void AudioDecoder::stopDemux(bool abortRead) {
+    if (m_demuxThread.joinable()) {
+        m_demuxStop.store(true, std::memory_order_release);
+        // Close: don't wait out a stalled network read (seek lets it finish, then seeks)
+        m_demuxAbort.store(abortRead, std::memory_order_release);
+        m_demuxFilled->wakeAll();
+        m_demuxFree->wakeAll();
+        m_demuxThread.join();
+        m_demuxAbort.store(false, std::memory_order_release);
+    }
+    for (AVPacket* pkt : m_demuxPool) av_packet_free(&pkt);
+    m_demuxPool.clear();
+    m_demuxFilled.reset();
+    m_demuxFree.reset();
+    m_demuxEnd = 0;
+    m_demuxDepth.store(0, std::memory_order_relaxed);
+}
+
+void AudioDecoder::demuxLoop() {
+    DecodeAhead::applyWorkerPolicy(m_demuxCores);
+    DemuxEntry entry;
+    while (!m_demuxStop.load(std::memory_order_acquire)) {
+        if (!entry.packet) {
+            if (!m_demuxFree->tryPop(entry)) {
+                m_demuxThreadWaits.fetch_add(1, std::memory_order_relaxed);
+                if (!m_demuxFree->pop(entry, m_demuxStop)) break;
+            }
+        }
+        int ret = readPacketDirect(entry.packet);
+        if (m_demuxStop.load(std::memory_order_acquire)) break;
+
+        if (ret < 0) {
+            m_demuxFilled->push({nullptr, ret}, m_demuxStop);
+            break;   // The decoder sees the end after the packets before it
+        }
+        if (entry.packet->stream_index != m_audioStreamIndex) {
+            av_packet_unref(entry.packet);   // Cover art, data streams: never queued
+            continue;
+        }
+        if (!m_demuxFilled->push(entry, m_demuxStop)) break;
+        m_demuxDepth.store(m_demuxFilled->size(), std::memory_order_relaxed);
+        entry.packet = nullptr;
+    }
+}
+
+AudioDecoder::DemuxStats AudioDecoder::getDemuxStats() const {
+    DemuxStats st;
+    st.capacity = m_demuxCapacity.load(std::memory_order_relaxed);
+    st.depth = m_demuxDepth.load(std::memory_order_relaxed);
+    st.decoderWaits = m_demuxDecoderWaits.load(std::memory_order_relaxed);
+    st.demuxWaits = m_demuxThreadWaits.load(std::memory_order_relaxed);
+    return st;
+}
+
+size_t AudioDecoder::preroll(uint32_t ms, uint32_t outputRate, uint32_t outputBits) {
+    if (ms == 0 || m_decodeAhead || !m_preroll.empty()) return 0;
+    if (m_rawDSD ? m_trackInfo.channels != 2 : (!m_codecContext && !m_nativeMode)) return 0;
+
+    // DSD: sampleRate is the 1-bit rate, and requests stay byte-aligned
+    size_t target = static_cast<size_t>(m_trackInfo.sampleRate) * ms / 1000;
+    if (m_rawDSD) target -= target % 8;
+    else m_prerollFrameBytes = ((outputBits == 16) ? 2 : 4) * m_trackInfo.channels;
+
+    AudioBuffer chunk;
+    size_t frames = 0;
+    while (frames < target && !m_decodeError && !m_readTimeout) {
+        size_t got = decodeSamples(chunk, std::min(PREROLL_CHUNK_FRAMES, target - frames),
+                                   outputRate, outputBits);
+        if (got == 0) break;
+        if (m_rawDSD) {
+            size_t perCh = got / 8;  // Output layout: [all L][all R]
+            m_preroll.insert(m_preroll.end(), chunk.data(), chunk.data() + perCh);
+            m_prerollRight.insert(m_prerollRight.end(), chunk.data() + perCh, chunk.data() + 2 * perCh);
+        } else {
+            m_preroll.insert(m_preroll.end(), chunk.data(), chunk.data() + got * m_prerollFrameBytes);
+        }
+        frames += got;
+    }
+    m_prerollPos = 0;
+    return frames;
+}
+
+size_t AudioDecoder::readPreroll(AudioBuffer& buffer, size_t numSamples) {
+    size_t remaining = m_preroll.size() - m_prerollPos;
+    size_t samples;
+    if (m_rawDSD) {
+        size_t perCh = std::min(numSamples / 8, remaining);
+        if (buffer.size() < 2 * perCh) buffer.resize(2 * perCh);
+        memcpy_audio(buffer.data(), m_preroll.data() + m_prerollPos, perCh);
+        memcpy_audio(buffer.data() + perCh, m_prerollRight.data() + m_prerollPos, perCh);
+        m_prerollPos += perCh;
+        samples = perCh * 8;
+    } else {
+        size_t bytes = std::min(numSamples * m_prerollFrameBytes, remaining);
+        if (buffer.size() < bytes) buffer.resize(bytes);
+        memcpy_audio(buffer.data(), m_preroll.data() + m_prerollPos, bytes);
+        m_prerollPos += bytes;
+        samples = bytes / m_prerollFrameBytes;
+    }
+    if (m_prerollPos >= m_preroll.size()) {
+        clearPreroll();
+    }
+    return samples;
+}
+
+void AudioDecoder::clearPreroll() {
+    std::vector<uint8_t>().swap(m_preroll);
+    std::vector<uint8_t>().swap(m_prerollRight);
+    m_prerollPos = 0;
+}
+
 size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
                                 uint32_t outputRate, uint32_t outputBits) {
+    if (!m_preroll.empty()) {
+        return readPreroll(buffer, numSamples);
+    }
+    if (m_decodeAheadBytes > 0 && !m_rawDSD && m_codecContext) {
+        startDecodeAhead(outputRate, outputBits);
+    }
+    if (!m_decodeAhead) {
+        return decodeSamples(buffer, numSamples, outputRate, outputBits);
+    }
+
+    // Audio thread: copy frames the worker already decoded
+    size_t frameBytes = m_decodeAhead->frameBytes();
+    if (buffer.size() < numSamples * frameBytes) {
+        buffer.resize(numSamples * frameBytes);
+    }
+    return m_decodeAhead->pop(buffer.data(), numSamples * frameBytes) / frameBytes;
+}
+
+size_t AudioDecoder::decodeSamples(AudioBuffer& buffer, size_t numSamples,
+                                   uint32_t outputRate, uint32_t outputBits) {
+    if (m_nativeMode) {
+        return readNative(buffer, numSamples);
+    }
 
     // ══════════════════════════════════════════════════════════════
     // DSD NATIVE MODE - Read raw packets without decoding
@@ -1048,27 +2344,22 @@ size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
         size_t totalBytesNeeded = (numSamples * m_trackInfo.channels) / 8;
         size_t bytesPerChannelNeeded = totalBytesNeeded / m_trackInfo.channels;
 
-        // Ensure pre-allocated DSD buffers are large enough (resize only if capacity insufficient)
-        if (m_dsdBufferCapacity < bytesPerChannelNeeded) {
-            m_dsdLeftBuffer.resize(bytesPerChannelNeeded);
-            m_dsdRightBuffer.resize(bytesPerChannelNeeded);
-            m_dsdBufferCapacity = bytesPerChannelNeeded;
-        }
-
-        // Use offset tracking instead of vector operations (zero allocations)
-        size_t leftOffset = 0;
-        size_t rightOffset = 0;
-        uint8_t* leftData = m_dsdLeftBuffer.data();
-        uint8_t* rightData = m_dsdRightBuffer.data();
-
         // Ensure output buffer is large enough
-        // DFF mode needs extra space for interleaved read + excess de-interleave
+        // DFF mode needs extra space for the interleaved read area after the planes
         static constexpr size_t DFF_READ_CHUNK = 32768;
         size_t bufferNeeded = m_dffMode ? totalBytesNeeded + DFF_READ_CHUNK : totalBytesNeeded;
         if (buffer.size() < bufferNeeded) {
             buffer.resize(bufferNeeded);
         }
 
+        // Packets, DFF bytes and DST frames land directly in the output planes
+        // [L: bytesPerChannelNeeded][R: bytesPerChannelNeeded]; DirettaRingBuffer
+        // converts those straight into the ring, so there is no other copy
+        size_t leftOffset = 0;
+        size_t rightOffset = 0;
+        uint8_t* leftData = buffer.data();
+        uint8_t* rightData = buffer.data() + bytesPerChannelNeeded;
+
         if (m_dffMode) {
             // ── DFF/DSDIFF: Read interleaved bytes from avio, de-interleave ──
             // DFF data layout: L0 R0 L1 R1 L2 R2 ... (byte-interleaved per channel)
@@ -1084,10 +2375,17 @@ size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
                 rightOffset += popped;
             }
 
+            if (m_dstPool) {
+                size_t got = readDst(leftData + leftOffset, rightData + rightOffset,
+                                     bytesPerChannelNeeded - leftOffset);
+                leftOffset += got;
+                rightOffset += got;
+            }
+
             // Read interleaved bytes from HTTP stream and de-interleave
             // For stereo: read 2 bytes at a time (L, R)
             size_t channels = m_trackInfo.channels;
-            while (leftOffset < bytesPerChannelNeeded && !m_eof && m_dffDataRemaining > 0) {
+            while (!m_dstPool && leftOffset < bytesPerChannelNeeded && !m_eof && m_dffDataRemaining > 0) {
                 // Read a chunk of interleaved data
                 size_t stillNeedPerCh = bytesPerChannelNeeded - leftOffset;
                 size_t interleavedToRead = stillNeedPerCh * channels;
@@ -1148,10 +2446,10 @@ size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
                 // Save excess to remainder ring (de-interleave directly)
                 if (canTake < samplesPerCh) {
                     size_t excess = samplesPerCh - canTake;
-                    // De-interleave excess into DSD left/right buffer tails temporarily
-                    // These areas won't be overwritten since leftOffset == bytesPerChannelNeeded
-                    uint8_t* exL = leftData + leftOffset;
-                    uint8_t* exR = rightData + rightOffset;
+                    // De-interleave excess into the DSD scratch buffers (preallocated
+                    // by openDFF to DFF_READ_CHUNK, more than one read can leave over)
+                    uint8_t* exL = m_dsdLeftBuffer.data();
+                    uint8_t* exR = m_dsdRightBuffer.data();
                     for (size_t i = 0; i < excess; i++) {
                         exL[i] = tmpBuf[(canTake + i) * channels];
                         exR[i] = tmpBuf[(canTake + i) * channels + 1];
@@ -1185,13 +2483,8 @@ size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
             // Read packets until we have enough data
             // DSF layout: each packet is [blockSize L][blockSize R]
             while (leftOffset < bytesPerChannelNeeded && !m_eof && !m_readTimeout) {
-                // Deadline: abort if av_read_frame() blocks > 20s (live stream proxy stall)
-                m_readDeadlineNs.store(
-                    std::chrono::duration_cast<std::chrono::nanoseconds>(
-                        (std::chrono::steady_clock::now() + std::chrono::seconds(READ_STALL_TIMEOUT_S)).time_since_epoch()
-                    ).count(), std::memory_order_relaxed);
-                int ret = av_read_frame(m_formatContext, m_packet);
-                m_readDeadlineNs.store(0, std::memory_order_relaxed);
+                // 20s deadline: aborts if av_read_frame() stalls (live stream proxy)
+                int ret = nextPacket(m_packet);
                 if (ret < 0) {
                     if (ret == AVERROR_EOF) {
                         m_eof = true;
@@ -1259,13 +2552,12 @@ size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
             }
         }
 
-        // Build output: [all L][all R]
+        // Output is [all L][all R]; a short read (end of track) closes the gap
         size_t actualPerCh = std::min(leftOffset, rightOffset);
         size_t totalBytes = actualPerCh * 2;
 
-        if (actualPerCh > 0) {
-            memcpy_audio(buffer.data(), leftData, actualPerCh);
-            memcpy_audio(buffer.data() + actualPerCh, rightData, actualPerCh);
+        if (actualPerCh > 0 && actualPerCh < bytesPerChannelNeeded) {
+            memmove(buffer.data() + actualPerCh, rightData, actualPerCh);
         }
 
         // Debug output
@@ -1353,17 +2645,12 @@ size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
     }
 
     while (totalSamplesRead < numSamples && !m_eof && !m_readTimeout) {
-        // Read packet — set 20s deadline so av_read_frame() cannot block indefinitely
+        // Read packet — 20s deadline so av_read_frame() cannot block indefinitely
         // (protects against live streams via proxy keeping TCP alive with no audio data)
-        m_readDeadlineNs.store(
-            std::chrono::duration_cast<std::chrono::nanoseconds>(
-                (std::chrono::steady_clock::now() + std::chrono::seconds(READ_STALL_TIMEOUT_S)).time_since_epoch()
-            ).count(), std::memory_order_relaxed);
-        int ret = av_read_frame(m_formatContext, m_packet);
-        m_readDeadlineNs.store(0, std::memory_order_relaxed);
+        int ret = nextPacket(m_packet);
 
         if (ret < 0) {
-            // Log position when EOF occurs
+            // Log position when EOF occurs (the demux thread, if any, has stopped reading)
             int64_t bytesRead = (m_formatContext->pb) ? m_formatContext->pb->pos : 0;
             if (bytesRead > 0) {
                 std::cout << "[AudioDecoder] Bytes read from stream: " << bytesRead << std::endl;
@@ -1430,6 +2717,12 @@ size_t AudioDecoder::readSamples(AudioBuffer& buffer, size_t numSamples,
                 return totalSamplesRead;
             }
 
+            // Seek: drop what was decoded before the exact target
+            if (m_seekTrimPending && !m_trackInfo.isDSD && !trimSeekFrame()) {
+                av_frame_unref(m_frame);
+                continue;
+            }
+
             // Process frame
             size_t frameSamples = m_frame->nb_samples;
 
@@ -1848,10 +3141,6 @@ void AudioEngine::waitForPreloadThread() {
     }
 }
 
-void AudioEngine::setAudioCallback(const AudioCallback& callback) {
-    m_audioCallback = callback;
-}
-
 void AudioEngine::setTrackChangeCallback(const TrackChangeCallback& callback) {
     m_trackChangeCallback = callback;
 }
@@ -1875,6 +3164,7 @@ void AudioEngine::setCurrentURI(const std::string& uri, const std::string& metad
         // Fermer les décodeurs pour forcer réouverture
         m_currentDecoder.reset();
         m_nextDecoder.reset();
+        m_prerollReadyMs.store(0, std::memory_order_relaxed);
 
         // CRITICAL FIX: Clear gapless queue when changing URI
         // Otherwise, the old "next track" will play after the new track finishes!
@@ -1905,6 +3195,19 @@ void AudioEngine::setCurrentURI(const std::string& uri, const std::string& metad
         // au prochain process()
     }
 
+    if (m_memoryBudget.limit > 0 && (uriChanged || forceReopen)) {
+        std::lock_guard<std::mutex> memLock(m_memoryMutex);
+        if (!m_memoryCurrent || m_memoryCurrent->uri() != uri) {
+            if (m_memoryNext && m_memoryNext->uri() == uri) {
+                m_memoryCurrent = std::move(m_memoryNext);  // Already downloading
+            } else {
+                m_memoryCurrent.reset();  // Release its budget before reserving again
+                m_memoryCurrent = std::make_shared<MemoryTrack>(uri, m_memoryBudget);
+            }
+        }
+        m_memoryNext.reset();  // Gapless queue was cleared above
+    }
+
     std::cout << "[AudioEngine] Current URI set" << std::endl;
 }
 
@@ -1917,6 +3220,34 @@ void AudioEngine::setNextURI(const std::string& uri, const std::string& metadata
     }
     m_pendingNextTrack.store(true, std::memory_order_release);
     std::cout << "[AudioEngine] Next URI queued (gapless)" << std::endl;
+
+    // Memory play: start the download now, the preload decoder picks it up.
+    // Whatever the current track leaves of the budget decides if it fits.
+    if (m_memoryBudget.limit > 0) {
+        std::lock_guard<std::mutex> memLock(m_memoryMutex);
+        bool isCurrent = m_memoryCurrent && m_memoryCurrent->uri() == uri;
+        if (!isCurrent && (!m_memoryNext || m_memoryNext->uri() != uri)) {
+            m_memoryNext.reset();
+            m_memoryNext = std::make_shared<MemoryTrack>(uri, m_memoryBudget);
+        }
+    }
+}
+
+std::shared_ptr<MemoryTrack> AudioEngine::memoryTrackFor(const std::string& uri) const {
+    std::lock_guard<std::mutex> memLock(m_memoryMutex);
+    if (m_memoryCurrent && m_memoryCurrent->uri() == uri) return m_memoryCurrent;
+    if (m_memoryNext && m_memoryNext->uri() == uri) return m_memoryNext;
+    return nullptr;
+}
+
+AudioEngine::MemoryPlayStatus AudioEngine::getMemoryPlayStatus() const {
+    MemoryPlayStatus status;
+    status.limit = m_memoryBudget.limit;
+    status.used = m_memoryBudget.used.load();
+    std::lock_guard<std::mutex> memLock(m_memoryMutex);
+    if (m_memoryCurrent) status.current = m_memoryCurrent->getProgress();
+    if (m_memoryNext) status.next = m_memoryNext->getProgress();
+    return status;
 }
 
 void AudioEngine::setTrackEndCallback(const TrackEndCallback& callback) {
@@ -1997,6 +3328,7 @@ void AudioEngine::stop() {
         // Fermer les décodeurs
         m_currentDecoder.reset();
         m_nextDecoder.reset();
+        m_prerollReadyMs.store(0, std::memory_order_relaxed);
 
         // Réinitialiser la position
         m_samplesPlayed = 0;
@@ -2043,44 +3375,55 @@ bool AudioEngine::process(size_t samplesNeeded) {
         m_seekRequested.store(false, std::memory_order_release);
 
         std::cout << "[AudioEngine] Processing async seek to " << targetSeconds << "s" << std::endl;
+        bool seeked = false;
 
-        // Now we can safely take the mutex (we're in the audio thread)
-        std::lock_guard<std::mutex> seekLock(m_mutex);
+        {
+            // Now we can safely take the mutex (we're in the audio thread)
+            std::lock_guard<std::mutex> seekLock(m_mutex);
 
-        // Validate decoder exists
-        if (!m_currentDecoder) {
-            std::cerr << "[AudioEngine] No decoder for seek" << std::endl;
-            // Don't return false - continue playing
-        } else {
-            // Validate position
-            const TrackInfo& info = m_currentTrackInfo;
-            if (info.sampleRate > 0 && info.duration > 0) {
-                double maxSeconds = static_cast<double>(info.duration) / info.sampleRate;
-                if (targetSeconds > maxSeconds) {
-                    targetSeconds = maxSeconds;
-                }
-                if (targetSeconds < 0) {
-                    targetSeconds = 0;
-                }
+            // Validate decoder exists
+            if (!m_currentDecoder) {
+                std::cerr << "[AudioEngine] No decoder for seek" << std::endl;
+                // Don't return false - continue playing
+            } else {
+                // Validate position
+                const TrackInfo& info = m_currentTrackInfo;
+                if (info.sampleRate > 0 && info.duration > 0) {
+                    double maxSeconds = static_cast<double>(info.duration) / info.sampleRate;
+                    if (targetSeconds > maxSeconds) {
+                        targetSeconds = maxSeconds;
+                    }
+                    if (targetSeconds < 0) {
+                        targetSeconds = 0;
+                    }
 
-                // Perform the actual seek
-                if (m_currentDecoder->seek(targetSeconds)) {
-                    // Update position
-                    m_samplesPlayed = static_cast<uint64_t>(targetSeconds * info.sampleRate);
+                    // Perform the actual seek
+                    if (m_currentDecoder->seek(targetSeconds)) {
+                        // Update position
+                        m_samplesPlayed = static_cast<uint64_t>(targetSeconds * info.sampleRate);
 
-                    // Reset drainage counters
-                    m_silenceCount = 0;
-                    m_isDraining = false;
+                        // Reset drainage counters
+                        m_silenceCount = 0;
+                        m_isDraining = false;
 
-                    std::cout << "[AudioEngine] Seek completed to " << targetSeconds << "s" << std::endl;
-                    DEBUG_LOG("[AudioEngine] Position updated to "
-                              << m_samplesPlayed << " samples (" << targetSeconds << "s)");
-                } else {
-                    std::cerr << "[AudioEngine] Seek failed in decoder" << std::endl;
+                        std::cout << "[AudioEngine] Seek completed to " << targetSeconds << "s" << std::endl;
+                        DEBUG_LOG("[AudioEngine] Position updated to "
+                                  << m_samplesPlayed << " samples (" << targetSeconds << "s)");
+                        seeked = true;
+                    } else {
+                        std::cerr << "[AudioEngine] Seek failed in decoder" << std::endl;
+                    }
                 }
             }
         }
 
+        // Audio queued downstream belongs to the old position (outside m_mutex)
+        if (seeked && m_seekCallback) {
+            std::chrono::steady_clock::time_point requestedAt{std::chrono::steady_clock::duration(
+                m_seekRequestedNs.load(std::memory_order_relaxed))};
+            m_seekCallback(requestedAt);
+        }
+
         // Continue processing after seek
     }
 
@@ -2110,6 +3453,7 @@ bool AudioEngine::process(size_t samplesNeeded) {
         if (m_nextURI != oldNextURI && m_nextDecoder) {
             DEBUG_LOG("[AudioEngine] Next URI changed, discarding stale preload");
             m_nextDecoder.reset();
+            m_prerollReadyMs.store(0, std::memory_order_relaxed);
             m_formatChangePending = false;
         }
 
@@ -2175,6 +3519,20 @@ bool AudioEngine::process(size_t samplesNeeded) {
         outputRate,
         outputBits
     );
+    if (m_firstSamplesPending && samplesRead > 0) {
+        // Open to first decoded samples: probing, header reads and prefill of the source
+        m_firstSamplesPending = false;
+        std::cout << "[AudioEngine] First samples "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - m_openStart).count()
+                  << " ms after open" << std::endl;
+    }
+    if (m_demuxPackets > 0) {
+        AudioDecoder::DemuxStats ds = m_currentDecoder->getDemuxStats();
+        m_demuxDepth.store(static_cast<uint32_t>(ds.depth), std::memory_order_relaxed);
+        m_demuxDecoderWaits.store(ds.decoderWaits, std::memory_order_relaxed);
+        m_demuxThreadWaits.store(ds.demuxWaits, std::memory_order_relaxed);
+    }
 
     // CRITICAL: Preload next track as soon as EOF flag is set (for gapless)
     // Check AFTER readSamples() because EOF flag is set during the read
@@ -2200,15 +3558,22 @@ bool AudioEngine::process(size_t samplesNeeded) {
     }
 
     if (samplesRead > 0) {
-        // Call audio callback to send data to output
-        if (m_audioCallback) {
-            bool continuePlayback = m_audioCallback(
-                m_buffer,
-                samplesRead,
-                outputRate,
-                outputBits,
-                outputChannels
-            );
+        // Send data to the output; the format only when it changed
+        if (m_audioSink) {
+            bool continuePlayback = true;
+            if (m_sinkGeneration != m_formatGeneration) {
+                AudioSink::Format format;
+                format.track = m_currentTrackInfo;
+                format.sampleRate = outputRate;
+                format.bitDepth = outputBits;
+                format.channels = outputChannels;
+                format.generation = m_formatGeneration;
+                continuePlayback = m_audioSink->begin(format);
+                if (continuePlayback) m_sinkGeneration = m_formatGeneration;
+            }
+            if (continuePlayback) {
+                continuePlayback = m_audioSink->write(m_buffer.data(), samplesRead);
+            }
 
             if (!continuePlayback) {
                 std::cout << "[AudioEngine] Playback stopped by callback" << std::endl;
@@ -2233,6 +3598,7 @@ bool AudioEngine::process(size_t samplesNeeded) {
             lock.lock();
         }
         m_nextDecoder.reset();
+        m_prerollReadyMs.store(0, std::memory_order_relaxed);
         m_nextURI.clear();
         m_nextMetadata.clear();
         m_formatChangePending = false;
@@ -2349,9 +3715,22 @@ bool AudioEngine::openCurrentTrack() {
     }
 
     std::cout << "[AudioEngine] Opening track: " << m_currentURI.substr(0, 80) << "..." << std::endl;
+    m_openStart = std::chrono::steady_clock::now();
+    m_firstSamplesPending = true;
 
     // Create decoder
     m_currentDecoder = std::make_unique<AudioDecoder>();
+    m_currentDecoder->setHttpReadAhead(m_httpReadAheadBytes);
+    m_currentDecoder->setTrackCache(m_trackCache);
+    m_currentDecoder->setHttpPool(m_httpPool);
+    m_currentDecoder->setParallelRanges(m_parallelConnections);
+    m_currentDecoder->setIoUring(m_ioUring);
+    m_currentDecoder->setMmap(m_mmap);
+    m_currentDecoder->setProbeCache(m_probeCacheEnabled ? &m_probeCache : nullptr);
+    m_currentDecoder->setMemoryTrack(memoryTrackFor(m_currentURI));
+    m_currentDecoder->setDecodeAhead(m_decodeAheadBytes, m_decodeAheadCores);
+    m_currentDecoder->setDstDecode(m_dstThreads, m_dstCores);
+    m_currentDecoder->setDemuxThread(m_demuxPackets, m_demuxCores);
 
     if (!m_currentDecoder->open(m_currentURI)) {
         std::cerr << "[AudioEngine] Failed to open track" << std::endl;
@@ -2360,6 +3739,7 @@ bool AudioEngine::openCurrentTrack() {
     }
 
     m_currentTrackInfo = m_currentDecoder->getTrackInfo();
+    m_formatGeneration++;
 
     std::cout << "[AudioEngine] Track opened: ";
     if (m_currentTrackInfo.isDSD) {
@@ -2417,12 +3797,34 @@ bool AudioEngine::preloadNextTrack() {
 
     // 2. OPEN: Slow network I/O without holding lock
     auto decoder = std::make_unique<AudioDecoder>();
+    decoder->setHttpReadAhead(m_httpReadAheadBytes);
+    decoder->setTrackCache(m_trackCache);
+    decoder->setHttpPool(m_httpPool);
+    decoder->setParallelRanges(m_parallelConnections);
+    decoder->setIoUring(m_ioUring);
+    decoder->setMmap(m_mmap);
+    decoder->setProbeCache(m_probeCacheEnabled ? &m_probeCache : nullptr);
+    decoder->setMemoryTrack(memoryTrackFor(uriToLoad));
+    decoder->setDecodeAhead(m_decodeAheadBytes, m_decodeAheadCores);
+    decoder->setDstDecode(m_dstThreads, m_dstCores);
+    decoder->setDemuxThread(m_demuxPackets, m_demuxCores);
 
     if (!decoder->open(uriToLoad)) {
         std::cerr << "[AudioEngine] Failed to preload next track" << std::endl;
         return false;
     }
 
+    // Pre-roll: the transition then starts from decoded audio instead of the network
+    uint32_t prerollMs = 0;
+    if (m_prerollMs > 0) {
+        const TrackInfo& info = decoder->getTrackInfo();
+        size_t frames = decoder->preroll(m_prerollMs, info.sampleRate, info.bitDepth);
+        if (info.sampleRate > 0) {
+            prerollMs = static_cast<uint32_t>(frames * 1000 / info.sampleRate);
+        }
+        DEBUG_LOG("[AudioEngine] Next track pre-roll: " << prerollMs << " ms");
+    }
+
     // 3. VALIDATE + COMMIT: Re-check under lock before storing result
     {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -2478,8 +3880,11 @@ bool AudioEngine::preloadNextTrack() {
             return false;
         }
 
-        // All checks passed → commit the preloaded decoder
+        // All checks passed → commit the preloaded decoder. Gapless means the
+        // output format stays the same, so its FIFO can be filled right away.
+        decoder->startDecodeAhead(currentInfo.sampleRate, currentInfo.bitDepth);
         m_nextDecoder = std::move(decoder);
+        m_prerollReadyMs.store(prerollMs, std::memory_order_relaxed);
     }
 
     DEBUG_LOG("[AudioEngine] Next track preloaded: "
@@ -2497,6 +3902,18 @@ void AudioEngine::transitionToNextTrack() {
 
     m_currentDecoder = std::move(m_nextDecoder);
     m_trackNumber++;
+    m_prerollLastMs.store(m_prerollReadyMs.exchange(0, std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    {
+        // Frees the finished track's RAM: the next download can start in full
+        std::lock_guard<std::mutex> memLock(m_memoryMutex);
+        if (m_memoryNext && m_memoryNext->uri() == m_currentURI) {
+            m_memoryCurrent = std::move(m_memoryNext);
+        } else {
+            m_memoryCurrent.reset();
+        }
+        m_memoryNext.reset();
+    }
     m_samplesPlayed = 0;
     m_formatChangePending = false;
 
@@ -2506,6 +3923,7 @@ void AudioEngine::transitionToNextTrack() {
 
     if (m_currentDecoder) {
         m_currentTrackInfo = m_currentDecoder->getTrackInfo();
+        m_formatGeneration++;
         if (m_trackChangeCallback) {
             m_trackChangeCallback(m_trackNumber, m_currentTrackInfo, m_currentURI, m_currentMetadata);
         }
@@ -2513,6 +3931,19 @@ void AudioEngine::transitionToNextTrack() {
 }
 
 bool AudioDecoder::seek(double seconds) {
+    // Decoded frames belong to the old position; restarted by the next readSamples()
+    stopDecodeAhead();
+    stopDemux(false);  // Queued packets too; the thread restarts at the next packet
+    clearPreroll();
+    m_seekTrimPending = false;
+
+    if (m_nativeMode) {
+        return seekNative(seconds);
+    }
+    if (m_dffMode) {
+        return seekDFF(seconds);  // No demuxer: byte offsets (DST: frame index)
+    }
+
     if (!m_formatContext || m_audioStreamIndex < 0) {
         std::cerr << "[AudioDecoder] Cannot seek: no file open" << std::endl;
         return false;
@@ -2578,6 +4009,9 @@ bool AudioDecoder::seek(double seconds) {
     if (m_pcmFifo) {
         av_audio_fifo_reset(m_pcmFifo);
     }
+    // The demuxer lands on the packet at or before the target: trim to the exact sample
+    m_seekTrimTarget = timestamp;
+    m_seekTrimPending = true;
     m_eof = false;
 
     std::cout << "[AudioDecoder] Seek successful to ~" << seconds << "s" << std::endl;
@@ -2585,6 +4019,36 @@ bool AudioDecoder::seek(double seconds) {
     return true;
 }
 
+bool AudioDecoder::trimSeekFrame() {
+    int64_t ts = m_frame->best_effort_timestamp;
+    int rate = m_codecContext->sample_rate;
+    if (ts == AV_NOPTS_VALUE || rate <= 0) {
+        m_seekTrimPending = false;  // No timestamps: keep the packet-accurate position
+        return true;
+    }
+    AVStream* stream = m_formatContext->streams[m_audioStreamIndex];
+    int64_t skip = av_rescale_q(m_seekTrimTarget - ts, stream->time_base, AVRational{1, rate});
+    if (skip >= m_frame->nb_samples) return false;  // Whole frame before the target
+    m_seekTrimPending = false;
+    if (skip <= 0) return true;
+
+    // Advance the plane pointers; the frame's buffers are still released by unref
+    AVSampleFormat fmt = static_cast<AVSampleFormat>(m_frame->format);
+    int channels = m_frame->ch_layout.nb_channels;
+    bool planar = av_sample_fmt_is_planar(fmt);
+    size_t offset = static_cast<size_t>(skip) * av_get_bytes_per_sample(fmt) * (planar ? 1 : channels);
+    int planes = planar ? channels : 1;
+    for (int p = 0; p < planes; p++) {
+        if (m_frame->extended_data && m_frame->extended_data != m_frame->data) {
+            m_frame->extended_data[p] += offset;
+        }
+        if (p < AV_NUM_DATA_POINTERS) m_frame->data[p] += offset;
+    }
+    m_frame->nb_samples -= static_cast<int>(skip);
+    DEBUG_LOG("[AudioDecoder] Seek trim: " << skip << " samples");
+    return true;
+}
+
 // ============================================================================
 // AudioEngine::seek() - Seek avec mise à jour de la position
 // ============================================================================
@@ -2616,6 +4080,8 @@ bool AudioEngine::seek(double seconds) {
     }
 
     // Set seek request atomically (lock-free, non-blocking)
+    m_seekRequestedNs.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                            std::memory_order_relaxed);
     m_seekTarget.store(seconds, std::memory_order_release);
     m_seekRequested.store(true, std::memory_order_release);
 
@@ -8,10 +8,25 @@
 #include <string>
 #include <memory>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <thread>
+#include <vector>
+
+#include "DecodeAhead.h"
+#include "DstDecoder.h"
+#include "HttpConnectionPool.h"
+#include "HttpReadAhead.h"
+#include "MappedFile.h"
+#include "NativeContainer.h"
+#include "ParallelRangeReader.h"
+#include "SeekIndex.h"
+#include "SpscQueue.h"
+#include "StreamProbeCache.h"
+#include "TrackCache.h"
+#include "UringReader.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -77,6 +92,66 @@ private:
     size_t m_size;
 };
 
+/**
+ * @brief Whole-track RAM copy for memory play
+ *
+ * Created by AudioEngine as soon as a URI is set, before any decoder exists.
+ * A helper thread opens the HTTP source and, when the Content-Length fits
+ * the shared budget, downloads the file into a retain-all HttpReadAhead
+ * ring. A decoder opened on the same URI reads and seeks in RAM; once the
+ * download is complete the network is no longer involved.
+ */
+class MemoryTrack {
+public:
+    /** @brief Memory shared by the current and the preloaded next track */
+    struct Budget {
+        uint64_t limit = 0;                  // 0 = memory play off
+        std::atomic<uint64_t> used{0};
+        bool reserve(uint64_t bytes);
+        void release(uint64_t bytes) { used.fetch_sub(bytes); }
+    };
+
+    struct Progress {
+        int64_t size = -1;          // -1 until known / not held in RAM
+        uint64_t downloaded = 0;
+        bool inMemory = false;      // Fits the budget, download running or done
+    };
+
+    MemoryTrack(const std::string& uri, Budget& budget);
+    ~MemoryTrack();
+
+    MemoryTrack(const MemoryTrack&) = delete;
+    MemoryTrack& operator=(const MemoryTrack&) = delete;
+
+    const std::string& uri() const { return m_uri; }
+
+    /**
+     * @brief Wait for the open attempt to finish
+     * @return The RAM ring, or nullptr if the track must be streamed instead
+     */
+    HttpReadAhead* waitReady();
+
+    int64_t size() const { return m_size; }  // Valid once waitReady() returned a ring
+    Progress getProgress() const;
+
+private:
+    void openThreadFunc();
+    static int interruptCb(void* opaque);
+
+    std::string m_uri;
+    Budget& m_budget;
+    uint64_t m_reserved = 0;
+    AVIOContext* m_http = nullptr;           // Owned; read by the ring's reader thread
+    std::unique_ptr<HttpReadAhead> m_ring;
+    int64_t m_size = -1;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_opened = false;                   // Open attempt finished (ring set or not)
+    std::atomic<bool> m_cancel{false};
+    std::thread m_openThread;
+};
+
 /**
  * @brief Audio decoder for a single track
  */
@@ -116,29 +191,136 @@ public:
 
     /**
      * @brief Check if EOF reached
-     * @return true if at end of file
+     * @return true if at end of file (with decode-ahead: and all decoded frames taken)
      */
-    bool isEOF() const { return m_eof; }
+    bool isEOF() const { return outputDrained() && m_eof; }
 
     /**
      * @brief True if avcodec_receive_frame() failed on a corrupt packet (distinct from EOF).
      * @return true if a fatal decode error was detected
      */
-    bool hasDecodeError() const { return m_decodeError; }
+    bool hasDecodeError() const { return outputDrained() && m_decodeError; }
 
     /**
      * @brief True if av_read_frame() was aborted by the interrupt callback (stream stall).
      * Distinct from EOF — indicates the source stopped delivering data (e.g. live proxy stall).
      */
-    bool hasReadTimeout() const { return m_readTimeout; }
+    bool hasReadTimeout() const { return outputDrained() && m_readTimeout; }
 
     /**
      * @brief Seek to a specific position in the audio file
+     *
+     * Sample-accurate: decoded samples before the target are dropped (PCM),
+     * DSD starts at the target byte. DFF seeks by byte offset (DST: frame index).
+     *
      * @param seconds Position in seconds
      * @return true if successful, false otherwise
      */
     bool seek(double seconds);
 
+    /**
+     * @brief Read HTTP(S) sources through a read-ahead ring of @p bytes (0 = off)
+     * Must be called before open().
+     */
+    void setHttpReadAhead(size_t bytes) { m_httpReadAheadBytes = bytes; }
+
+    /**
+     * @brief Serve HTTP(S) sources through @p cache (nullptr = off); implies read-ahead
+     * Must be called before open(). The cache must outlive the decoder.
+     */
+    void setTrackCache(TrackCache* cache) { m_trackCache = cache; }
+
+    /**
+     * @brief Fetch plain http:// sources over @p pool's keep-alive connections (nullptr = off)
+     * Implies read-ahead. Must be called before open(). The pool must outlive the decoder.
+     */
+    void setHttpPool(HttpConnectionPool* pool) { m_httpPool = pool; }
+
+    /**
+     * @brief Fetch pooled sources as byte ranges over up to @p connections at once (<= 1 = off)
+     * Only with setHttpPool() and a server that honours ranges. Must be called before open().
+     */
+    void setParallelRanges(unsigned connections) { m_parallelConnections = connections; }
+
+    /**
+     * @brief Read local files (file:// or an absolute path) with io_uring read-ahead
+     * Falls back to FFmpeg's file protocol where io_uring is unavailable. Must be called before open().
+     */
+    void setIoUring(bool enabled) { m_ioUring = enabled; }
+
+    /**
+     * @brief Map local files (file:// or an absolute path) and read them from the page cache
+     * Takes precedence over setIoUring(); native readers convert straight from the
+     * mapping. Must be called before open().
+     */
+    void setMmap(bool enabled) { m_mmap = enabled; }
+
+    /**
+     * @brief Reuse and record FFmpeg stream parameters per URI (nullptr = always probe)
+     * Must be called before open(). The cache must outlive the decoder.
+     */
+    void setProbeCache(StreamProbeCache* cache) { m_probeCache = cache; }
+
+    /**
+     * @brief Read from @p track's RAM copy if it holds this URI (nullptr = off)
+     * Must be called before open(); takes precedence over read-ahead and cache.
+     */
+    void setMemoryTrack(std::shared_ptr<MemoryTrack> track) { m_memoryTrack = std::move(track); }
+
+    /**
+     * @brief Decode PCM on a worker thread into a FIFO of @p bytes (0 = off)
+     * @param cores CPU cores for the worker (empty = any); never real-time
+     * Must be called before open(). DSD (no codec work) is always read directly.
+     */
+    void setDecodeAhead(size_t bytes, const std::vector<int>& cores) {
+        m_decodeAheadBytes = bytes;
+        m_decodeAheadCores = cores;
+    }
+
+    /**
+     * @brief Worker pool for DST-compressed DFF (@p threads 0 = half the CPUs, max 4)
+     * @param cores CPU cores for the workers (empty = any); never real-time
+     * Must be called before open().
+     */
+    void setDstDecode(unsigned threads, const std::vector<int>& cores) {
+        m_dstThreads = threads;
+        m_dstCores = cores;
+    }
+
+    /**
+     * @brief Read packets on a demux thread into a queue of @p packets (0 = off)
+     * @param cores CPU cores for the thread (empty = any); never real-time
+     * FFmpeg-demuxed sources only (not DFF or the native readers). Must be called before open().
+     */
+    void setDemuxThread(size_t packets, const std::vector<int>& cores) {
+        m_demuxPackets = packets;
+        m_demuxCores = cores;
+        m_demuxCapacity.store(packets, std::memory_order_relaxed);
+    }
+
+    struct DemuxStats {
+        size_t depth = 0;              // Packets queued for the decoder
+        size_t capacity = 0;
+        uint64_t decoderWaits = 0;     // Decoder found the queue empty
+        uint64_t demuxWaits = 0;       // Demux thread found it full
+    };
+
+    /** @brief Any thread (the queue may be started by a decode-ahead worker) */
+    DemuxStats getDemuxStats() const;
+
+    /**
+     * @brief Start the decode-ahead worker now instead of at the first readSamples()
+     * Used for the preloaded next track so its FIFO is full by the transition.
+     */
+    void startDecodeAhead(uint32_t outputRate, uint32_t outputBits);
+
+    /**
+     * @brief Decode the first @p ms of the track into a side buffer now
+     * Used by the gapless preload; readSamples() drains it before decoding more.
+     * @return Frames decoded (PCM frames or DSD bits per channel)
+     */
+    size_t preroll(uint32_t ms, uint32_t outputRate, uint32_t outputBits);
+
 private:
     AVFormatContext* m_formatContext;
     AVCodecContext* m_codecContext;
@@ -161,12 +343,131 @@ private:
     int64_t m_dffDataRemaining = 0;  // Bytes of DSD audio data left to read
     bool openDFF(const std::string& url);  // Custom DSDIFF parser
 
+    // DST-compressed DFF: "DSTF" frame chunks are read from m_dffIO (m_dffDataRemaining
+    // counts the rest of the "DST " chunk) and decoded by m_dstPool in order
+    unsigned m_dstThreads = 0;
+    std::vector<int> m_dstCores;
+    std::unique_ptr<DstFramePool> m_dstPool;
+    std::vector<uint8_t> m_dstChunk;      // Compressed frame being submitted
+    std::vector<uint8_t> m_dstFrame;      // Planar decoded frame being drained
+    size_t m_dstBytesPerChannel = 0;      // Per frame (1/75 s)
+    size_t m_dstFramePos = 0;             // Next byte per channel in m_dstFrame
+    size_t m_dstFrameValid = 0;
+    void fillDstPool();
+    size_t readDst(uint8_t* left, uint8_t* right, size_t bytesPerChannel);
+
+    // DFF seek: audio data (or the DSTF frames) starts at m_dffDataStart. DST frame
+    // offsets are indexed while frames are read, and from the "DSTI" chunk if present
+    static constexpr uint64_t DST_INDEX_STRIDE = 75;      // One point per second
+    static constexpr uint64_t DST_WALK_LIMIT = DST_INDEX_STRIDE;  // Walk <= 1 s of headers, else estimate
+    int64_t m_dffDataStart = 0;
+    int64_t m_dffDataSize = 0;
+    uint32_t m_dstFrames = 0;
+    uint64_t m_dstFrameNumber = 0;        // Next frame fillDstPool() reads
+    bool m_dstFrameExact = true;          // False after an estimated seek: nothing is indexed
+    bool m_dstIndexLoaded = false;        // "DSTI" chunk looked for
+    SeekIndex m_dstIndex{DST_INDEX_STRIDE};
+    size_t m_dstFrameSkip = 0;            // Seek offset into the next decoded frame (per channel)
+    bool seekDFF(double seconds);
+    void loadDstIndex();
+    bool resyncDstFrame(int64_t offset);
+
+    // Native WAV/AIFF/DSF readers (same idea as DFF: no demuxer, byte-offset seek).
+    // m_nativeIO is a plain HTTP context or a read-ahead/memory/local-file wrapper (custom).
+    bool m_nativeMode = false;
+    NativeLayout m_native;
+    AVIOContext* m_nativeIO = nullptr;
+    bool m_nativeCustomIO = false;
+    int64_t m_nativeRemaining = 0;        // PCM: bytes left; DSF: bytes per channel not yet loaded
+    std::vector<uint8_t> m_nativeScratch; // 24-bit / big-endian source, DSF block pair
+    size_t m_nativeBlockPos = 0;          // DSF: next byte in the loaded block pair (per channel)
+    size_t m_nativeBlockValid = 0;        // DSF: valid bytes per channel in the loaded pair
+    size_t m_nativeBlockSkip = 0;         // DSF: seek offset into the next block pair
+    const uint8_t* m_nativeBlock = nullptr;  // DSF: loaded pair (m_nativeScratch or the mapping)
+    static constexpr size_t NATIVE_PROBE_BYTES = 16384;  // Below the 32KB AVIO buffer: rewindable
+    bool openNative(const std::string& url, AVDictionary* options, bool isLocalServer);
+    void releaseNativeIO();
+    size_t nativeReadFully(uint8_t* dst, size_t size);
+    const uint8_t* nativeView(uint8_t* scratch, size_t size, size_t& got);  // Mapping, else read into scratch
+    bool nativeSeekTo(int64_t offset);
+    size_t readNative(AudioBuffer& buffer, size_t numSamples);
+    bool seekNative(double seconds);
+
     // Audirvana raw PCM mode (workaround for audio/L16 missing rate= param)
     // Inner HTTP context wrapped by a custom AVIOContext (m_formatContext->pb)
     // so the s16be demuxer cannot reach the HTTP mime_type option and skips
     // its strict RFC 2586 check, allowing our forced sample_rate/channels.
     AVIOContext* m_audirvanaHttp = nullptr;
 
+    // HTTP read-ahead: reader thread fills m_readAhead from m_readAheadHttp,
+    // the demuxer reads the ring through a custom AVIOContext (m_formatContext->pb)
+    size_t m_httpReadAheadBytes = 0;
+    std::unique_ptr<HttpReadAhead> m_readAhead;
+    AVIOContext* m_readAheadHttp = nullptr;   // Used by the reader thread only once started
+    HttpConnectionPool* m_httpPool = nullptr;
+    std::unique_ptr<PooledHttpStream> m_pooledHttp;  // Replaces m_readAheadHttp when pooled
+    unsigned m_parallelConnections = 0;
+    std::unique_ptr<ParallelRangeReader> m_parallelReader;  // Replaces m_pooledHttp for large sources
+    static constexpr int64_t PARALLEL_MIN_BYTES = 4 * static_cast<int64_t>(ParallelRangeReader::SEGMENT_SIZE);
+    int64_t m_readAheadSize = -1;             // Source size (AVSEEK_SIZE), -1 = unknown
+    static constexpr int READ_AHEAD_IO_BUF_SIZE = 32768;
+    static constexpr size_t TRACK_CACHE_READ_AHEAD_BYTES = 4 << 20;  // Ring when only the cache is set
+    TrackCache* m_trackCache = nullptr;
+    std::shared_ptr<TrackCache::Source> m_cacheSource;  // Set when the source is cached
+    StreamProbeCache* m_probeCache = nullptr;
+    bool applyCachedProbe(const std::string& url, const StreamProbe& probe);
+    void storeProbe(const std::string& url);
+    std::shared_ptr<MemoryTrack> m_memoryTrack;
+    HttpReadAhead* m_activeReadAhead = nullptr;   // m_readAhead (nullptr for a memory track)
+    std::unique_ptr<HttpReadAhead::Cursor> m_memoryCursor;  // This decoder's position in the RAM copy
+    AVIOContext* allocReadAheadIO(bool seekable);
+    int openMemoryTrack(AVIOContext** pb);
+    int openReadAhead(const std::string& url, AVDictionary** options, AVIOContext** pb);
+    void closeReadAhead();
+    static int readAheadRead(void* opaque, uint8_t* buf, int bufSize);
+    static int64_t readAheadSeek(void* opaque, int64_t offset, int whence);
+    static int readAheadInterruptCb(void* opaque);
+
+    // Local files: the demuxer reads m_mapped or m_uring through a custom
+    // AVIOContext, no read-ahead thread. Native readers view m_mapped directly.
+    bool m_mmap = false;
+    bool m_ioUring = false;
+    std::unique_ptr<MappedFile> m_mapped;
+    std::unique_ptr<UringFileReader> m_uring;
+    int openLocalFile(const std::string& url, AVIOContext** pb);
+    AVIOContext* allocLocalIO(int (*readFn)(void*, uint8_t*, int), int64_t (*seekFn)(void*, int64_t, int));
+    static int mappedRead(void* opaque, uint8_t* buf, int bufSize);
+    static int64_t mappedSeek(void* opaque, int64_t offset, int whence);
+    static int uringRead(void* opaque, uint8_t* buf, int bufSize);
+    static int64_t uringSeek(void* opaque, int64_t offset, int whence);
+
+    // Decode-ahead: worker runs decodeSamples() into m_decodeAhead; once it is
+    // running, decoder state belongs to the worker until stopDecodeAhead()
+    size_t m_decodeAheadBytes = 0;
+    std::vector<int> m_decodeAheadCores;
+    std::unique_ptr<DecodeAhead> m_decodeAhead;
+    AudioBuffer m_decodeAheadChunk;                   // Worker's decodeSamples() output
+    static constexpr size_t DECODE_AHEAD_CHUNK_FRAMES = 8192;
+    size_t decodeSamples(AudioBuffer& buffer, size_t numSamples,
+                         uint32_t outputRate, uint32_t outputBits);
+    void stopDecodeAhead();
+
+    // Pre-roll: decoded at preload time, PCM interleaved or DSD planar (L in
+    // m_preroll, R in m_prerollRight, stereo only) to match readSamples() output
+    std::vector<uint8_t> m_preroll;
+    std::vector<uint8_t> m_prerollRight;
+    size_t m_prerollPos = 0;               // Bytes (per channel for DSD) already returned
+    size_t m_prerollFrameBytes = 0;        // PCM only
+    static constexpr size_t PREROLL_CHUNK_FRAMES = 65536;
+    size_t readPreroll(AudioBuffer& buffer, size_t numSamples);
+    void clearPreroll();
+
+    // Pre-roll taken and worker finished (or not running): m_eof / error flags
+    // are final and safe to read
+    bool outputDrained() const {
+        return m_prerollPos >= m_preroll.size() && (!m_decodeAhead || m_decodeAhead->drained());
+    }
+
     // DSD packet remainder ring buffer (O(1) push/pop, replaces O(n) memmove)
     // Stores leftover bytes when DSD packets don't align with request size
     // Layout: [leftChannel bytes][rightChannel bytes] - each channel has same count
@@ -181,6 +482,11 @@ private:
     // Replaces memmove-based overflow handling with efficient FIFO
     AVAudioFifo* m_pcmFifo = nullptr;
 
+    // Sample-accurate seek: decoded samples before the target are dropped
+    bool m_seekTrimPending = false;
+    int64_t m_seekTrimTarget = 0;         // In the audio stream's time_base units
+    bool trimSeekFrame();
+
     // Reusable resample buffer (eliminates per-call allocation)
     AudioBuffer m_resampleBuffer;
     size_t m_resampleBufferCapacity = 0;
@@ -197,6 +503,34 @@ private:
     std::atomic<int64_t> m_readDeadlineNs{0};  // nanoseconds since epoch; 0 = no deadline
     static int ffmpegReadInterruptCb(void* opaque);
 
+    // Demux thread: av_read_frame() runs on m_demuxThread into packets of
+    // m_demuxPool, queued to the decoder on m_demuxFilled and handed back
+    // empty on m_demuxFree. Started by the first nextPacket(), stopped by
+    // seek() and close(). A negative ret ends the stream (no packet).
+    struct DemuxEntry {
+        AVPacket* packet = nullptr;
+        int ret = 0;
+    };
+    size_t m_demuxPackets = 0;
+    std::vector<int> m_demuxCores;
+    std::vector<AVPacket*> m_demuxPool;
+    std::unique_ptr<SpscQueue<DemuxEntry>> m_demuxFilled;
+    std::unique_ptr<SpscQueue<DemuxEntry>> m_demuxFree;
+    std::thread m_demuxThread;
+    std::atomic<bool> m_demuxStop{false};
+    std::atomic<bool> m_demuxAbort{false};       // Interrupts the demux thread's read (close)
+    int m_demuxEnd = 0;                          // End entry taken by the decoder (repeated after)
+    std::atomic<uint64_t> m_demuxDecoderWaits{0};
+    std::atomic<uint64_t> m_demuxThreadWaits{0};
+    // Published for getDemuxStats(): the queues belong to whichever thread decodes
+    std::atomic<size_t> m_demuxDepth{0};
+    std::atomic<size_t> m_demuxCapacity{0};
+    int readPacketDirect(AVPacket* pkt);         // av_read_frame() with the stall deadline
+    int nextPacket(AVPacket* pkt);
+    bool startDemux();
+    void stopDemux(bool abortRead);
+    void demuxLoop();
+
     // Debug/diagnostic counters (instance variables, NOT static!)
     // These were previously static variables causing race conditions when
     // multiple AudioDecoder instances run concurrently (e.g., gapless preload)
@@ -286,6 +620,36 @@ private:
     }
 };
 
+/**
+ * @brief Output stage fed by AudioEngine::process() on the audio thread
+ *
+ * begin() gets the format once per format generation: before the first
+ * frames of every opened track (play, stop/play, gapless transition). All
+ * per-format work (output reconfiguration, frame size, flags) belongs there;
+ * write() then only receives spans of frames in that format.
+ */
+class AudioSink {
+public:
+    struct Format {
+        TrackInfo track;
+        uint32_t sampleRate = 0;     // Output rate (DSD: 1-bit rate)
+        uint32_t bitDepth = 0;       // Output bits (24-bit PCM in 32-bit containers; DSD: 1)
+        uint32_t channels = 0;
+        uint64_t generation = 0;     // Increments with every format handed over
+    };
+
+    virtual ~AudioSink() = default;
+
+    /** @return false to stop playback */
+    virtual bool begin(const Format& format) = 0;
+
+    /**
+     * @param frames PCM frames, or DSD samples per channel (planar [L][R] bytes)
+     * @return false to stop playback
+     */
+    virtual bool write(const uint8_t* data, size_t frames) = 0;
+};
+
 /**
  * @brief Audio Engine with gapless playback support
  *
@@ -303,18 +667,6 @@ public:
         PAUSED
     };
 
-    /**
-     * @brief Callback for audio data ready
-     * @param buffer Audio buffer
-     * @param samples Number of samples
-     * @param sampleRate Sample rate
-     * @param bitDepth Bit depth
-     * @param channels Number of channels
-     * @return true to continue, false to stop
-     */
-    using AudioCallback = std::function<bool(const AudioBuffer&, size_t,
-                                            uint32_t, uint32_t, uint32_t)>;
-
     /**
      * @brief Callback for track change
      * @param trackNumber New track number
@@ -329,6 +681,14 @@ public:
      */
     using TrackEndCallback = std::function<void()>;
 
+    /**
+     * @brief Callback after a seek was applied, before audio from the new position
+     * @param requestedAt When seek() queued the request
+     *
+     * Runs on the audio thread (the one calling the audio callback).
+     */
+    using SeekCallback = std::function<void(std::chrono::steady_clock::time_point)>;
+
     /**
      * @brief Constructor
      */
@@ -340,10 +700,10 @@ public:
     ~AudioEngine();
 
     /**
-     * @brief Set audio callback
-     * @param callback Callback function
+     * @brief Set the output for decoded audio (nullptr = decode and discard)
+     * Set before playback starts; the sink must outlive the engine.
      */
-    void setAudioCallback(const AudioCallback& callback);
+    void setAudioSink(AudioSink* sink) { m_audioSink = sink; }
 
     /**
      * @brief Set track change callback
@@ -357,6 +717,12 @@ public:
      */
     void setTrackEndCallback(const TrackEndCallback& callback);
 
+    /**
+     * @brief Set seek callback (e.g. flush the output ring)
+     * @param callback Callback function
+     */
+    void setSeekCallback(const SeekCallback& callback) { m_seekCallback = callback; }
+
     /**
      * @brief Set current track URI
      * @param uri Track URI
@@ -411,6 +777,11 @@ public:
      */
     double getPosition() const;
 
+    /**
+     * @brief Decoded position in samples (start of the next buffer sent)
+     */
+    uint64_t getSamplesPlayed() const { return m_samplesPlayed; }
+
     /**
      * @brief Seek to a specific position (in seconds)
      * @param seconds Position in seconds
@@ -430,6 +801,126 @@ public:
      */
     uint32_t getCurrentSampleRate() const;
 
+    /**
+     * @brief HTTP read-ahead ring size for decoders opened from now on (0 = off)
+     */
+    void setHttpReadAhead(size_t bytes) { m_httpReadAheadBytes = bytes; }
+
+    /**
+     * @brief On-disk track cache for decoders opened from now on (nullptr = off)
+     */
+    void setTrackCache(TrackCache* cache) { m_trackCache = cache; }
+
+    /**
+     * @brief Keep-alive connection pool for decoders opened from now on (nullptr = off)
+     */
+    void setHttpPool(HttpConnectionPool* pool) { m_httpPool = pool; }
+
+    /**
+     * @brief Concurrent range requests per track for decoders opened from now on (<= 1 = off)
+     */
+    void setParallelRanges(unsigned connections) { m_parallelConnections = connections; }
+
+    /**
+     * @brief io_uring read-ahead for local files, for decoders opened from now on
+     */
+    void setIoUring(bool enabled) { m_ioUring = enabled; }
+
+    /**
+     * @brief mmap for local files, for decoders opened from now on (over io_uring)
+     */
+    void setMmap(bool enabled) { m_mmap = enabled; }
+
+    /**
+     * @brief Reuse probed stream parameters when a URI is reopened, for decoders opened from now on
+     */
+    void setProbeCache(bool enabled) { m_probeCacheEnabled = enabled; }
+
+    /**
+     * @brief Stream-parameter cache hits, misses and size (open() skipping FFmpeg probing)
+     */
+    StreamProbeCache::Stats getProbeCacheStats() const { return m_probeCache.getStats(); }
+
+    /**
+     * @brief Memory play: download tracks into RAM from setCurrentURI/setNextURI on
+     * @param budgetBytes Shared by the current and next track (0 = off)
+     */
+    void setMemoryPlay(size_t budgetBytes) { m_memoryBudget.limit = budgetBytes; }
+
+    /**
+     * @brief Decode PCM ahead of the audio thread (current and preloaded next track)
+     * @param bytes Decoded-PCM FIFO per track (0 = off)
+     * @param cores CPU cores for the decode workers (empty = any)
+     */
+    void setDecodeAhead(size_t bytes, const std::vector<int>& cores) {
+        m_decodeAheadBytes = bytes;
+        m_decodeAheadCores = cores;
+    }
+
+    /**
+     * @brief DST-compressed DFF decode workers (@p threads 0 = auto)
+     * @param cores CPU cores for the workers (empty = any)
+     */
+    void setDstDecode(unsigned threads, const std::vector<int>& cores) {
+        m_dstThreads = threads;
+        m_dstCores = cores;
+    }
+
+    /**
+     * @brief Demux thread with a queue of @p packets for decoders opened from now on (0 = off)
+     * @param cores CPU cores for the thread (empty = any)
+     */
+    void setDemuxThread(size_t packets, const std::vector<int>& cores) {
+        m_demuxPackets = packets;
+        m_demuxCores = cores;
+    }
+
+    struct DemuxStatus {
+        uint32_t depth = 0;              // Packets queued after the last read
+        uint32_t capacity = 0;
+        uint64_t decoderWaits = 0;       // Current track: decoder found the queue empty
+        uint64_t demuxWaits = 0;         // Current track: demux thread found it full
+    };
+
+    DemuxStatus getDemuxStatus() const {
+        DemuxStatus s;
+        s.capacity = static_cast<uint32_t>(m_demuxPackets);
+        s.depth = m_demuxDepth.load(std::memory_order_relaxed);
+        s.decoderWaits = m_demuxDecoderWaits.load(std::memory_order_relaxed);
+        s.demuxWaits = m_demuxThreadWaits.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief Decode the first @p ms of the next track during the gapless preload (0 = off)
+     */
+    void setPreroll(uint32_t ms) { m_prerollMs = ms; }
+
+    struct PrerollStatus {
+        uint32_t targetMs = 0;
+        uint32_t nextReadyMs = 0;        // Decoded for the preloaded next track
+        uint32_t lastTransitionMs = 0;   // What the last gapless transition started from
+    };
+
+    PrerollStatus getPrerollStatus() const {
+        PrerollStatus s;
+        s.targetMs = m_prerollMs;
+        s.nextReadyMs = m_prerollReadyMs.load(std::memory_order_relaxed);
+        s.lastTransitionMs = m_prerollLastMs.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    struct MemoryPlayStatus {
+        MemoryTrack::Progress current;
+        MemoryTrack::Progress next;
+        uint64_t used = 0;
+        uint64_t limit = 0;
+    };
+
+    /**
+     * @brief Download progress of the RAM copies (for statistics)
+     */
+    MemoryPlayStatus getMemoryPlayStatus() const;
 
     /**
      * @brief Main processing loop (called from audio thread)
@@ -450,13 +941,23 @@ private:
     TrackInfo m_currentTrackInfo;
     TrackEndCallback m_trackEndCallback;
 
+    // Memory play (declared before the decoders, which may hold tracks)
+    MemoryTrack::Budget m_memoryBudget;
+    mutable std::mutex m_memoryMutex;
+    std::shared_ptr<MemoryTrack> m_memoryCurrent;  // Protected by m_memoryMutex
+    std::shared_ptr<MemoryTrack> m_memoryNext;
+    std::shared_ptr<MemoryTrack> memoryTrackFor(const std::string& uri) const;
+
     // Decoders
     std::unique_ptr<AudioDecoder> m_currentDecoder;
     std::unique_ptr<AudioDecoder> m_nextDecoder;
 
     // Callbacks
-    AudioCallback m_audioCallback;
+    AudioSink* m_audioSink = nullptr;
+    uint64_t m_formatGeneration = 0;     // Bumped when m_currentTrackInfo changes (m_mutex)
+    uint64_t m_sinkGeneration = 0;       // Last generation handed to m_audioSink->begin()
     TrackChangeCallback m_trackChangeCallback;
+    SeekCallback m_seekCallback;
 
     // Synchronization
     mutable std::mutex m_mutex;
@@ -470,6 +971,28 @@ private:
     int m_silenceCount;  // Pour drainage du buffer Diretta
     bool m_isDraining;   // Flag pour éviter de re-logger "Track finished"
     std::atomic<bool> m_formatChangePending{false};  // Preload detected format change, don't re-preload
+    size_t m_httpReadAheadBytes = 0;  // Passed to each AudioDecoder
+    TrackCache* m_trackCache = nullptr;  // Passed to each AudioDecoder (owned by DirettaRenderer)
+    HttpConnectionPool* m_httpPool = nullptr;  // Passed to each AudioDecoder (owned by DirettaRenderer)
+    StreamProbeCache m_probeCache;       // Passed to each AudioDecoder when enabled
+    bool m_probeCacheEnabled = false;
+    std::chrono::steady_clock::time_point m_openStart;  // openCurrentTrack(), for the first-samples log
+    bool m_firstSamplesPending = false;
+    unsigned m_parallelConnections = 0;  // Passed to each AudioDecoder
+    bool m_ioUring = false;              // Passed to each AudioDecoder
+    bool m_mmap = false;                 // Passed to each AudioDecoder
+    size_t m_decodeAheadBytes = 0;       // Passed to each AudioDecoder
+    std::vector<int> m_decodeAheadCores;
+    unsigned m_dstThreads = 0;           // Passed to each AudioDecoder
+    std::vector<int> m_dstCores;
+    uint32_t m_prerollMs = 0;
+    std::atomic<uint32_t> m_prerollReadyMs{0};   // Atomics: read by dumpStats()
+    std::atomic<uint32_t> m_prerollLastMs{0};
+    size_t m_demuxPackets = 0;           // Passed to each AudioDecoder
+    std::vector<int> m_demuxCores;
+    std::atomic<uint32_t> m_demuxDepth{0};          // Sampled by process(), read by dumpStats()
+    std::atomic<uint64_t> m_demuxDecoderWaits{0};
+    std::atomic<uint64_t> m_demuxThreadWaits{0};
 
     // Helper functions
     bool openCurrentTrack();
@@ -491,6 +1014,7 @@ private:
     // The UPnP thread sets these flags, the audio thread processes the seek
     std::atomic<bool> m_seekRequested{false};
     std::atomic<double> m_seekTarget{0.0};
+    std::atomic<int64_t> m_seekRequestedNs{0};   // steady_clock, for the seek latency
 
     // Prevent copying
     AudioEngine(const AudioEngine&) = delete;
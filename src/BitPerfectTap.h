@@ -0,0 +1,708 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file BitPerfectTap.h
+ * @brief Bit-perfect verification tap for the Diretta output path
+ *
+ * Hashes audio on both sides of the ring buffer and compares the results
+ * block by block:
+ * - Input side (sendAudio thread): source bytes, reduced to the canonical
+ *   layout below, right after they were pushed.
+ * - Wire side (getNewStream, SDK worker): popped bytes are memcpy'd into a
+ *   preallocated slot queue. Nothing else happens on the worker thread.
+ * - Verifier thread (nice +10): inverts the ring conversion on the wire
+ *   bytes, hashes them, compares against the input blocks, reports per
+ *   track and optionally dumps the raw wire bytes to a file.
+ *
+ * Canonical layout (what both sides hash):
+ * - PCM: significant source bytes per sample, interleaved frame order.
+ *   Padding bytes (S24_P32 pad byte, 16->24/32 zero fill) are stripped and
+ *   checked: a non-zero pad is a format error (truncation or corruption).
+ * - DSD: source bit order, channel groups of 4 bytes (native) or 2 bytes
+ *   (DoP), i.e. exactly the ring's interleave with conversions undone.
+ *   DoP markers are checked for 0x05/0xFA alternation.
+ *
+ * Silence buffers from getNewStream() never reach the tap.
+ */
+
+#ifndef BIT_PERFECT_TAP_H
+#define BIT_PERFECT_TAP_H
+
+#include "DirettaRingBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+namespace BitPerfect {
+
+//=============================================================================
+// CRC-32 (IEEE 802.3, reflected) - streamable across arbitrary chunk splits
+//=============================================================================
+
+struct Crc32Table {
+    uint32_t v[256];
+    constexpr Crc32Table() : v() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            v[i] = c;
+        }
+    }
+};
+
+inline constexpr Crc32Table kCrc32Table{};
+
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* p, size_t n) {
+    crc = ~crc;
+    while (n--) {
+        crc = kCrc32Table.v[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+//=============================================================================
+// Stream description (one per ring "stream", i.e. between ring clears)
+//=============================================================================
+
+enum class Transform {
+    Direct,      // PCM copied as-is
+    Pack24,      // S24_P32 -> packed 24-bit (pad byte position from s24Msb)
+    Pad16To32,   // 16-bit -> 32-bit, two zero LSBs
+    Pad16To24,   // 16-bit -> 24-bit, one zero LSB
+    DsdNative,   // Planar DSD -> 4-byte channel groups (+ bit reverse / byte swap)
+    DoP          // Planar DSD -> DoP 24-bit frames
+};
+
+struct StreamParams {
+    Transform transform = Transform::Direct;
+    int channels = 2;
+    int wireBytesPerSample = 2;   // Direct PCM only
+    DirettaRingBuffer::DSDConversionMode dsdMode = DirettaRingBuffer::DSDConversionMode::Passthrough;
+    bool dopBitReverse = false;
+
+    // Wire bytes per channel per canonical unit
+    size_t wireUnitPerChannel() const {
+        switch (transform) {
+            case Transform::Direct:    return static_cast<size_t>(wireBytesPerSample);
+            case Transform::Pack24:    return 3;
+            case Transform::Pad16To32: return 4;
+            case Transform::Pad16To24: return 3;
+            case Transform::DsdNative: return 4;
+            case Transform::DoP:       return 3;
+        }
+        return 1;
+    }
+};
+
+/**
+ * Invert the ring conversion for whole wire frames.
+ * @param frames Number of wire frames (wireUnitPerChannel() * channels bytes each)
+ * @param out    Canonical output (at most the same size as the input)
+ * @param formatErrors Incremented for non-zero padding / broken DoP markers
+ * @param dopMarker    DoP marker phase: -1 = unknown, 0 = expect 0x05, 1 = expect 0xFA
+ * @return Canonical bytes written
+ */
+inline size_t canonicalizeWire(const StreamParams& p, const uint8_t* in, size_t frames,
+                               uint8_t* out, uint64_t& formatErrors, int& dopMarker) {
+    const uint8_t* lut = DirettaRingBuffer::kBitReverseLUT;
+    size_t samples = frames * static_cast<size_t>(p.channels);
+    size_t o = 0;
+
+    switch (p.transform) {
+        case Transform::Direct:
+        case Transform::Pack24: {
+            size_t n = samples * p.wireUnitPerChannel();
+            std::memcpy(out, in, n);
+            return n;
+        }
+        case Transform::Pad16To32:
+            for (size_t i = 0; i < samples; i++, in += 4) {
+                if (in[0] | in[1]) formatErrors++;
+                out[o++] = in[2];
+                out[o++] = in[3];
+            }
+            return o;
+        case Transform::Pad16To24:
+            for (size_t i = 0; i < samples; i++, in += 3) {
+                if (in[0]) formatErrors++;
+                out[o++] = in[1];
+                out[o++] = in[2];
+            }
+            return o;
+        case Transform::DsdNative: {
+            bool rev = p.dsdMode == DirettaRingBuffer::DSDConversionMode::BitReverseOnly ||
+                       p.dsdMode == DirettaRingBuffer::DSDConversionMode::BitReverseAndSwap;
+            bool swap = p.dsdMode == DirettaRingBuffer::DSDConversionMode::ByteSwapOnly ||
+                        p.dsdMode == DirettaRingBuffer::DSDConversionMode::BitReverseAndSwap;
+            for (size_t i = 0; i < samples; i++, in += 4) {
+                for (int b = 0; b < 4; b++) {
+                    uint8_t v = in[swap ? 3 - b : b];
+                    out[o++] = rev ? lut[v] : v;
+                }
+            }
+            return o;
+        }
+        case Transform::DoP:
+            for (size_t f = 0; f < frames; f++) {
+                uint8_t marker = in[2];
+                int phase = (marker == 0x05) ? 0 : (marker == 0xFA) ? 1 : -1;
+                if (phase < 0 || (dopMarker >= 0 && phase != dopMarker)) formatErrors++;
+                dopMarker = (phase < 0) ? -1 : (phase ^ 1);
+                for (int ch = 0; ch < p.channels; ch++, in += 3) {
+                    // Wire: [DSD byte N+1, DSD byte N, marker]
+                    out[o++] = p.dopBitReverse ? lut[in[1]] : in[1];
+                    out[o++] = p.dopBitReverse ? lut[in[0]] : in[0];
+                }
+            }
+            return o;
+    }
+    return 0;
+}
+
+/**
+ * Reduce planar DSD input to canonical channel groups of @p group bytes.
+ * @param planeStride Bytes per channel plane in the caller's buffer
+ * @param perChannel  Bytes per channel actually consumed (multiple of group)
+ */
+inline size_t canonicalizeDsdInput(const uint8_t* in, size_t planeStride, size_t perChannel,
+                                   int channels, size_t group, uint8_t* out) {
+    size_t o = 0;
+    for (size_t g = 0; g + group <= perChannel; g += group) {
+        for (int ch = 0; ch < channels; ch++) {
+            std::memcpy(out + o, in + static_cast<size_t>(ch) * planeStride + g, group);
+            o += group;
+        }
+    }
+    return o;
+}
+
+/**
+ * Reduce S24_P32 input to its 3 significant bytes per sample.
+ * Pad byte must be zero; otherwise the source had more than 24 bits.
+ */
+inline size_t canonicalizeS24Input(const uint8_t* in, size_t samples, bool msbAligned,
+                                   uint8_t* out, uint64_t& formatErrors) {
+    size_t o = 0;
+    size_t first = msbAligned ? 1 : 0;
+    size_t pad = msbAligned ? 0 : 3;
+    for (size_t i = 0; i < samples; i++, in += 4) {
+        if (in[pad]) formatErrors++;
+        out[o++] = in[first];
+        out[o++] = in[first + 1];
+        out[o++] = in[first + 2];
+    }
+    return o;
+}
+
+//=============================================================================
+// Fixed-size block hasher (emits one CRC per BLOCK_BYTES canonical bytes)
+//=============================================================================
+
+struct BlockHasher {
+    static constexpr size_t BLOCK_BYTES = 65536;
+
+    uint32_t crc = 0;
+    size_t fill = 0;
+    uint64_t index = 0;
+
+    void reset() { crc = 0; fill = 0; index = 0; }
+
+    template<typename OnBlock>
+    void feed(const uint8_t* p, size_t n, OnBlock&& onBlock) {
+        while (n > 0) {
+            size_t take = std::min(n, BLOCK_BYTES - fill);
+            crc = crc32Update(crc, p, take);
+            fill += take;
+            p += take;
+            n -= take;
+            if (fill == BLOCK_BYTES) {
+                onBlock(index, crc);
+                index++;
+                crc = 0;
+                fill = 0;
+            }
+        }
+    }
+};
+
+} // namespace BitPerfect
+
+//=============================================================================
+// BitPerfectTap
+//=============================================================================
+
+class BitPerfectTap {
+public:
+    static constexpr size_t SLOT_BYTES = 16384;
+    static constexpr size_t SLOT_COUNT = 256;       // 4MB wire capture (~0.3s at 1536kHz/32/2)
+    static constexpr size_t ENTRY_COUNT = 4096;     // Input block CRCs in flight
+    static constexpr size_t SCRATCH_BYTES = 65536;  // Matches ring STAGING_SIZE
+    static constexpr size_t MAX_PENDING_WIRE = 4096;
+
+    struct TrackReport {
+        uint32_t track = 0;
+        uint64_t blocksVerified = 0;
+        uint64_t blocksMismatched = 0;
+        uint64_t blocksUnverified = 0;
+        uint64_t firstMismatchByte = 0;   // Canonical offset within the stream
+        uint64_t formatErrors = 0;
+    };
+
+    using Reporter = std::function<void(const TrackReport&)>;
+
+    BitPerfectTap() = default;
+    ~BitPerfectTap() { stop(); }
+
+    BitPerfectTap(const BitPerfectTap&) = delete;
+    BitPerfectTap& operator=(const BitPerfectTap&) = delete;
+
+    /**
+     * @brief Allocate capture buffers and start the verifier thread
+     * @param dumpPath Raw wire dump file (empty = no dump)
+     */
+    bool start(const std::string& dumpPath, Reporter reporter) {
+        if (m_enabled) return true;
+        m_slots.assign(SLOT_COUNT, Slot{});
+        m_entries.assign(ENTRY_COUNT, Entry{});
+        m_inScratch.assign(SCRATCH_BYTES, 0);
+        m_reporter = std::move(reporter);
+        if (!dumpPath.empty()) {
+            m_dump = std::fopen(dumpPath.c_str(), "wb");
+            if (!m_dump) return false;
+        }
+        m_stop.store(false, std::memory_order_release);
+        m_enabled = true;
+        m_thread = std::thread([this]() { verifierLoop(); });
+        return true;
+    }
+
+    void stop() {
+        if (!m_enabled) return;
+        m_stop.store(true, std::memory_order_release);
+        if (m_thread.joinable()) m_thread.join();
+        m_enabled = false;
+        if (m_dump) {
+            std::fclose(m_dump);
+            m_dump = nullptr;
+        }
+    }
+
+    bool enabled() const { return m_enabled; }
+
+    //=========================================================================
+    // Input side (sendAudio thread only)
+    //=========================================================================
+
+    /**
+     * @brief Start a new stream (ring was cleared or reconfigured)
+     *
+     * Bytes popped after this call are tagged with the new epoch. Call it
+     * before the ring can be popped again (i.e. before prefill completes).
+     */
+    void beginStream(const BitPerfect::StreamParams& params) {
+        m_params = params;
+        m_inHasher.reset();
+        uint32_t epoch = m_epoch.load(std::memory_order_relaxed) + 1;
+        Entry e;
+        e.kind = Entry::STREAM;
+        e.epoch = epoch;
+        e.track = m_inTrack;
+        e.params = params;
+        pushEntry(e);
+        m_epoch.store(epoch, std::memory_order_release);
+    }
+
+    /** @brief Gapless track boundary at the current input position */
+    void markTrack() { m_inTrack++; }
+
+    /**
+     * @brief Hash consumed input bytes in canonical layout
+     * @param consumed   Input bytes accepted by the ring push
+     * @param totalBytes Input bytes offered (DoP plane stride = totalBytes / channels;
+     *                   native DSD reads planes at consumed / channels, like the ring)
+     * @param s24Msb     Effective S24 alignment used by the push (Pack24 only)
+     */
+    void onInput(const uint8_t* data, size_t consumed, size_t totalBytes, bool s24Msb) {
+        using namespace BitPerfect;
+        const StreamParams& p = m_params;
+        uint8_t* scratch = m_inScratch.data();
+        auto emit = [this](uint64_t index, uint32_t crc) {
+            Entry e;
+            e.kind = Entry::BLOCK;
+            e.epoch = m_epoch.load(std::memory_order_relaxed);
+            e.track = m_inTrack;
+            e.value = index;
+            e.crc = crc;
+            pushEntry(e);
+        };
+
+        switch (p.transform) {
+            case Transform::Pack24: {
+                size_t samples = consumed / 4;
+                size_t maxChunk = SCRATCH_BYTES / 3;
+                while (samples > 0) {
+                    size_t n = std::min(samples, maxChunk);
+                    uint64_t errs = 0;
+                    size_t out = canonicalizeS24Input(data, n, s24Msb, scratch, errs);
+                    m_inFormatErrors.fetch_add(errs, std::memory_order_relaxed);
+                    m_inHasher.feed(scratch, out, emit);
+                    data += n * 4;
+                    samples -= n;
+                }
+                break;
+            }
+            case Transform::DsdNative:
+            case Transform::DoP: {
+                size_t ch = static_cast<size_t>(p.channels);
+                size_t group = (p.transform == Transform::DoP) ? 2 : 4;
+                size_t stride = (p.transform == Transform::DoP ? totalBytes : consumed) / ch;
+                size_t perChannel = consumed / ch;
+                size_t maxPerChannel = (SCRATCH_BYTES / ch) / group * group;
+                for (size_t off = 0; off < perChannel; off += maxPerChannel) {
+                    size_t n = std::min(maxPerChannel, perChannel - off);
+                    size_t out = canonicalizeDsdInput(data + off, stride, n, p.channels, group, scratch);
+                    m_inHasher.feed(scratch, out, emit);
+                }
+                break;
+            }
+            default:
+                // PCM direct and 16-bit upsampling: canonical == input
+                m_inHasher.feed(data, consumed, emit);
+                break;
+        }
+    }
+
+    //=========================================================================
+    // Wire side (getNewStream / SDK worker thread only) - memcpy only
+    //=========================================================================
+
+    void onWire(const uint8_t* data, size_t len) {
+        uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+        while (len > 0) {
+            size_t head = m_slotHead.load(std::memory_order_relaxed);
+            size_t tail = m_slotTail.load(std::memory_order_acquire);
+            if (head - tail >= SLOT_COUNT) {
+                // Verifier fell behind: the rest of this stream can't be aligned
+                m_wireGap = true;
+                m_wireDrops.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            Slot& s = m_slots[head % SLOT_COUNT];
+            size_t n = std::min(len, SLOT_BYTES);
+            std::memcpy(s.data, data, n);
+            s.size = static_cast<uint32_t>(n);
+            s.epoch = epoch;
+            s.gapBefore = m_wireGap;
+            m_wireGap = false;
+            m_slotHead.store(head + 1, std::memory_order_release);
+            data += n;
+            len -= n;
+        }
+    }
+
+    //=========================================================================
+    // Statistics (any thread)
+    //=========================================================================
+
+    struct Stats {
+        uint64_t blocksVerified = 0;
+        uint64_t blocksMismatched = 0;
+        uint64_t blocksUnverified = 0;
+        uint64_t formatErrors = 0;
+        uint64_t wireDrops = 0;
+        uint64_t tracksBitPerfect = 0;
+        uint64_t tracksMismatched = 0;
+    };
+
+    Stats getStats() const {
+        Stats s;
+        s.blocksVerified = m_blocksVerified.load(std::memory_order_relaxed);
+        s.blocksMismatched = m_blocksMismatched.load(std::memory_order_relaxed);
+        s.blocksUnverified = m_blocksUnverified.load(std::memory_order_relaxed);
+        s.formatErrors = m_inFormatErrors.load(std::memory_order_relaxed) +
+                         m_wireFormatErrors.load(std::memory_order_relaxed);
+        s.wireDrops = m_wireDrops.load(std::memory_order_relaxed);
+        s.tracksBitPerfect = m_tracksBitPerfect.load(std::memory_order_relaxed);
+        s.tracksMismatched = m_tracksMismatched.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct Slot {
+        uint32_t epoch = 0;
+        uint32_t size = 0;
+        bool gapBefore = false;
+        uint8_t data[SLOT_BYTES];
+    };
+
+    struct Entry {
+        enum Kind : uint8_t { STREAM, BLOCK } kind = BLOCK;
+        uint32_t epoch = 0;
+        uint32_t track = 0;
+        uint64_t value = 0;     // Block index
+        uint32_t crc = 0;
+        BitPerfect::StreamParams params;
+    };
+
+    struct BlockKey {
+        uint32_t epoch;
+        uint64_t index;
+        bool operator<(const BlockKey& o) const {
+            return epoch != o.epoch ? epoch < o.epoch : index < o.index;
+        }
+        bool operator==(const BlockKey& o) const { return epoch == o.epoch && index == o.index; }
+    };
+
+    void pushEntry(const Entry& e) {
+        size_t head = m_entryHead.load(std::memory_order_relaxed);
+        size_t tail = m_entryTail.load(std::memory_order_acquire);
+        if (head - tail >= ENTRY_COUNT) {
+            // Dropped input block shows up as an unverified wire block
+            return;
+        }
+        m_entries[head % ENTRY_COUNT] = e;
+        m_entryHead.store(head + 1, std::memory_order_release);
+    }
+
+    //=========================================================================
+    // Verifier thread
+    //=========================================================================
+
+    void verifierLoop() {
+        // Low priority: this thread must never compete with decode or the SDK worker
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+
+        std::vector<uint8_t> canon(SLOT_BYTES + 64);
+        std::vector<uint8_t> carry;
+        bool stopping = false;
+
+        while (!stopping) {
+            stopping = m_stop.load(std::memory_order_acquire);
+            drainEntries();
+            drainSlots(canon, carry);
+            drainEntries();
+            matchBlocks();
+            if (!stopping) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        finishTrack();
+    }
+
+    void drainEntries() {
+        size_t tail = m_entryTail.load(std::memory_order_relaxed);
+        size_t head = m_entryHead.load(std::memory_order_acquire);
+        while (tail != head) {
+            const Entry& e = m_entries[tail % ENTRY_COUNT];
+            if (e.kind == Entry::STREAM) {
+                m_streams.push_back(e);
+            } else {
+                m_inputBlocks.push_back(e);
+            }
+            tail++;
+        }
+        m_entryTail.store(tail, std::memory_order_release);
+    }
+
+    void drainSlots(std::vector<uint8_t>& canon, std::vector<uint8_t>& carry) {
+        using namespace BitPerfect;
+        size_t tail = m_slotTail.load(std::memory_order_relaxed);
+        size_t head = m_slotHead.load(std::memory_order_acquire);
+
+        while (tail != head) {
+            const Slot& s = m_slots[tail % SLOT_COUNT];
+
+            if (m_dump) std::fwrite(s.data, 1, s.size, m_dump);
+
+            if (s.epoch != m_wireEpoch) {
+                switchWireStream(s.epoch);
+                carry.clear();
+            }
+            if (s.gapBefore) m_wireSkip = true;
+
+            if (!m_wireSkip) {
+                size_t unit = m_wireParams.wireUnitPerChannel() * static_cast<size_t>(m_wireParams.channels);
+                const uint8_t* in = s.data;
+                size_t len = s.size;
+
+                // Complete a frame split across slots
+                if (!carry.empty()) {
+                    size_t need = std::min(unit - carry.size(), len);
+                    carry.insert(carry.end(), in, in + need);
+                    in += need;
+                    len -= need;
+                    if (carry.size() == unit) {
+                        hashWire(carry.data(), 1, canon);
+                        carry.clear();
+                    }
+                }
+                size_t frames = len / unit;
+                if (frames > 0) hashWire(in, frames, canon);
+                size_t rest = len - frames * unit;
+                if (rest > 0) carry.assign(in + frames * unit, in + len);
+            }
+            tail++;
+        }
+        m_slotTail.store(tail, std::memory_order_release);
+    }
+
+    void switchWireStream(uint32_t epoch) {
+        // STREAM entries are published before their epoch, so one more drain
+        // always finds it unless the entry queue overflowed
+        drainEntries();
+        while (!m_streams.empty() && m_streams.front().epoch < epoch) m_streams.pop_front();
+
+        m_wireEpoch = epoch;
+        m_wireHasher.reset();
+        m_dopMarker = -1;
+        if (m_streams.empty() || m_streams.front().epoch != epoch) {
+            m_wireSkip = true;   // Popped before any beginStream(), or entry lost
+            return;
+        }
+        m_wireParams = m_streams.front().params;
+        m_streams.pop_front();
+        m_wireSkip = false;
+    }
+
+    void hashWire(const uint8_t* in, size_t frames, std::vector<uint8_t>& canon) {
+        size_t unit = m_wireParams.wireUnitPerChannel() * static_cast<size_t>(m_wireParams.channels);
+        size_t maxFrames = std::max<size_t>(1, SLOT_BYTES / unit);
+        uint32_t epoch = m_wireEpoch;
+        auto emit = [this, epoch](uint64_t index, uint32_t crc) {
+            m_wireBlocks.push_back({BlockKey{epoch, index}, crc});
+        };
+        while (frames > 0) {
+            size_t n = std::min(frames, maxFrames);
+            uint64_t errs = 0;
+            size_t out = BitPerfect::canonicalizeWire(m_wireParams, in, n, canon.data(), errs, m_dopMarker);
+            if (errs) m_wireFormatErrors.fetch_add(errs, std::memory_order_relaxed);
+            m_wireHasher.feed(canon.data(), out, emit);
+            in += n * unit;
+            frames -= n;
+        }
+    }
+
+    void matchBlocks() {
+        while (!m_inputBlocks.empty() && !m_wireBlocks.empty()) {
+            const Entry& in = m_inputBlocks.front();
+            BlockKey inKey{in.epoch, in.value};
+            const auto& wire = m_wireBlocks.front();
+
+            if (inKey == wire.first) {
+                account(in.track, in.value, in.crc == wire.second);
+                m_inputBlocks.pop_front();
+                m_wireBlocks.pop_front();
+            } else if (inKey < wire.first) {
+                // Input never reached the wire (ring cleared on stop/seek/format change)
+                m_inputBlocks.pop_front();
+            } else {
+                // Wire block without input CRC (input queue overflow)
+                m_blocksUnverified.fetch_add(1, std::memory_order_relaxed);
+                m_track.blocksUnverified++;
+                m_wireBlocks.pop_front();
+            }
+        }
+        while (m_wireBlocks.size() > MAX_PENDING_WIRE) {
+            m_blocksUnverified.fetch_add(1, std::memory_order_relaxed);
+            m_track.blocksUnverified++;
+            m_wireBlocks.pop_front();
+        }
+    }
+
+    void account(uint32_t track, uint64_t index, bool match) {
+        if (track != m_track.track) {
+            finishTrack();
+            m_track = TrackReport{};
+            m_track.track = track;
+            m_trackFormatErrorBase = currentFormatErrors();
+        }
+        if (match) {
+            m_track.blocksVerified++;
+            m_blocksVerified.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            if (m_track.blocksMismatched == 0) {
+                m_track.firstMismatchByte = index * BitPerfect::BlockHasher::BLOCK_BYTES;
+            }
+            m_track.blocksMismatched++;
+            m_blocksMismatched.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void finishTrack() {
+        if (m_track.blocksVerified + m_track.blocksMismatched == 0) return;
+        m_track.formatErrors = currentFormatErrors() - m_trackFormatErrorBase;
+        if (m_track.blocksMismatched == 0 && m_track.formatErrors == 0) {
+            m_tracksBitPerfect.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_tracksMismatched.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (m_reporter) m_reporter(m_track);
+        m_track = TrackReport{};
+    }
+
+    uint64_t currentFormatErrors() const {
+        return m_inFormatErrors.load(std::memory_order_relaxed) +
+               m_wireFormatErrors.load(std::memory_order_relaxed);
+    }
+
+    bool m_enabled = false;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    Reporter m_reporter;
+    FILE* m_dump = nullptr;
+
+    // Shared
+    std::atomic<uint32_t> m_epoch{0};
+    std::vector<Slot> m_slots;
+    alignas(64) std::atomic<size_t> m_slotHead{0};
+    alignas(64) std::atomic<size_t> m_slotTail{0};
+    std::vector<Entry> m_entries;
+    alignas(64) std::atomic<size_t> m_entryHead{0};
+    alignas(64) std::atomic<size_t> m_entryTail{0};
+
+    // Input side
+    BitPerfect::StreamParams m_params;
+    BitPerfect::BlockHasher m_inHasher;
+    std::vector<uint8_t> m_inScratch;
+    uint32_t m_inTrack = 1;
+
+    // Wire side (worker thread)
+    bool m_wireGap = false;
+
+    // Verifier thread
+    std::deque<Entry> m_streams;
+    std::deque<Entry> m_inputBlocks;
+    std::deque<std::pair<BlockKey, uint32_t>> m_wireBlocks;
+    uint32_t m_wireEpoch = 0;
+    BitPerfect::StreamParams m_wireParams;
+    BitPerfect::BlockHasher m_wireHasher;
+    bool m_wireSkip = true;
+    int m_dopMarker = -1;
+    TrackReport m_track;
+    uint64_t m_trackFormatErrorBase = 0;
+
+    // Statistics
+    std::atomic<uint64_t> m_blocksVerified{0};
+    std::atomic<uint64_t> m_blocksMismatched{0};
+    std::atomic<uint64_t> m_blocksUnverified{0};
+    std::atomic<uint64_t> m_inFormatErrors{0};
+    std::atomic<uint64_t> m_wireFormatErrors{0};
+    std::atomic<uint64_t> m_wireDrops{0};
+    std::atomic<uint64_t> m_tracksBitPerfect{0};
+    std::atomic<uint64_t> m_tracksMismatched{0};
+};
+
+#endif // BIT_PERFECT_TAP_H
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file ClockDriftEstimator.h
+ * @brief Target clock drift and ring fill trend estimation
+ *
+ * getNewStream() is paced by the Diretta target's clock. Sampling the
+ * cumulative bytes it consumed against the callback timestamp gives the
+ * target's effective byte rate; comparing with the nominal rate gives the
+ * drift in ppm. The ring fill level sampled at the same points gives the
+ * fill trend, from which time to underrun/overrun is predicted.
+ *
+ * Both slopes use a paired Theil-Sen estimator: the median of slopes between
+ * point i and point i + n/2 of the sliding window. Every pair has a long
+ * baseline (half the window) and the median ignores scheduling outliers and
+ * SDK callback bursts.
+ *
+ * Single-threaded: owned and driven by one thread (the producer).
+ */
+
+#ifndef CLOCK_DRIFT_ESTIMATOR_H
+#define CLOCK_DRIFT_ESTIMATOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class ClockDriftEstimator {
+public:
+    static constexpr size_t WINDOW_POINTS = 128;
+    static constexpr int64_t POINT_INTERVAL_NS = 250000000;   // 250ms -> 32s window
+    static constexpr int64_t GAP_RESET_NS = 4 * POINT_INTERVAL_NS;
+    static constexpr size_t MIN_POINTS = 16;                  // ~4s before first estimate
+
+    struct Estimate {
+        bool valid = false;
+        double bytesPerSecond = 0.0;      // Measured consumer rate
+        double nominalBytesPerSecond = 0.0;
+        double ppm = 0.0;                 // (measured / nominal - 1) * 1e6
+        double fillSlope = 0.0;           // Ring fill trend in bytes/s (<0 = draining)
+        double secondsToUnderrun = -1.0;  // -1 = not draining
+        double secondsToOverrun = -1.0;   // -1 = not filling
+        double windowSeconds = 0.0;
+        size_t points = 0;
+    };
+
+    /**
+     * @brief Start a new series (format change, ring clear)
+     */
+    void reset(double nominalBytesPerSecond, size_t ringSize) {
+        m_nominal = nominalBytesPerSecond;
+        m_ringSize = ringSize;
+        m_count = 0;
+        m_head = 0;
+        m_estimate = Estimate{};
+        m_estimate.nominalBytesPerSecond = nominalBytesPerSecond;
+    }
+
+    /**
+     * @brief Offer a sample; kept only if POINT_INTERVAL_NS after the last one
+     * @param tNs   Timestamp of the last consumer callback
+     * @param bytes Cumulative bytes consumed up to and including that callback
+     * @param fill  Ring fill level in bytes
+     * @return true if the estimate was recomputed
+     */
+    bool addPoint(int64_t tNs, uint64_t bytes, size_t fill) {
+        if (m_count > 0) {
+            const Point& last = at(m_count - 1);
+            int64_t dt = tNs - last.tNs;
+            if (dt < POINT_INTERVAL_NS) return false;
+            if (dt > GAP_RESET_NS || bytes < last.bytes) {
+                // Consumer stalled (pause, reconnect): slope across the gap is meaningless
+                reset(m_nominal, m_ringSize);
+            }
+        }
+
+        if (m_count < WINDOW_POINTS) {
+            m_points[(m_head + m_count) % WINDOW_POINTS] = Point{tNs, bytes, fill};
+            m_count++;
+        } else {
+            m_points[m_head] = Point{tNs, bytes, fill};
+            m_head = (m_head + 1) % WINDOW_POINTS;
+        }
+
+        if (m_count < MIN_POINTS) return false;
+        recompute();
+        return true;
+    }
+
+    const Estimate& estimate() const { return m_estimate; }
+
+private:
+    struct Point {
+        int64_t tNs;
+        uint64_t bytes;
+        size_t fill;
+    };
+
+    const Point& at(size_t i) const { return m_points[(m_head + i) % WINDOW_POINTS]; }
+
+    template<typename Value>
+    double pairedMedianSlope(Value value) {
+        size_t half = m_count / 2;
+        size_t pairs = m_count - half;
+        for (size_t i = 0; i < pairs; i++) {
+            const Point& a = at(i);
+            const Point& b = at(i + half);
+            double dt = static_cast<double>(b.tNs - a.tNs) * 1e-9;
+            m_slopes[i] = (value(b) - value(a)) / dt;
+        }
+        auto mid = m_slopes.begin() + pairs / 2;
+        std::nth_element(m_slopes.begin(), mid, m_slopes.begin() + pairs);
+        return *mid;
+    }
+
+    void recompute() {
+        Estimate e;
+        e.nominalBytesPerSecond = m_nominal;
+        e.points = m_count;
+        e.windowSeconds = static_cast<double>(at(m_count - 1).tNs - at(0).tNs) * 1e-9;
+
+        e.bytesPerSecond = pairedMedianSlope([](const Point& p) { return static_cast<double>(p.bytes); });
+        e.fillSlope = pairedMedianSlope([](const Point& p) { return static_cast<double>(p.fill); });
+        if (m_nominal > 0.0) {
+            e.ppm = (e.bytesPerSecond / m_nominal - 1.0) * 1e6;
+        }
+
+        // Ignore trends below 1 byte/s - that's days away for any real ring
+        double fill = static_cast<double>(at(m_count - 1).fill);
+        if (e.fillSlope < -1.0) {
+            e.secondsToUnderrun = fill / -e.fillSlope;
+        } else if (e.fillSlope > 1.0 && m_ringSize > 0) {
+            e.secondsToOverrun = std::max(0.0, static_cast<double>(m_ringSize) - fill) / e.fillSlope;
+        }
+        e.valid = true;
+        m_estimate = e;
+    }
+
+    std::array<Point, WINDOW_POINTS> m_points{};
+    std::array<double, WINDOW_POINTS> m_slopes{};
+    size_t m_head = 0;
+    size_t m_count = 0;
+    double m_nominal = 0.0;
+    size_t m_ringSize = 0;
+    Estimate m_estimate;
+};
+
+#endif // CLOCK_DRIFT_ESTIMATOR_H
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file DecodeAhead.h
+ * @brief Decoded-PCM FIFO filled by a background decode worker
+ *
+ * AudioDecoder normally decodes just in time from AudioEngine::process(),
+ * i.e. on the audio thread that --cpu-decode pins and runs SCHED_FIFO. With
+ * decode-ahead the worker thread runs the codec, resampler and their
+ * allocations, and the audio thread only copies finished frames out.
+ *
+ * The worker never inherits the real-time policy: threads are created from
+ * the audio thread (or the preload thread it spawned), so start() resets the
+ * worker to SCHED_OTHER and moves it to @p cores (--cpu-other), or to every
+ * CPU when none are configured.
+ */
+
+#ifndef DECODE_AHEAD_H
+#define DECODE_AHEAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+class DecodeAhead {
+public:
+    static constexpr size_t MIN_CAPACITY = 1 << 20;
+
+    // Decode the next chunk: bytes produced (whole frames) and their location, 0 = end
+    using ProduceFn = std::function<size_t(const uint8_t** data)>;
+
+    struct Stats {
+        uint64_t bytesIn = 0;          // Decoded by the worker
+        uint64_t bytesOut = 0;         // Taken by the audio thread
+        uint64_t waits = 0;            // pop() calls that had to wait for the worker
+        size_t capacity = 0;
+        size_t buffered = 0;
+    };
+
+    DecodeAhead(size_t capacity, size_t frameBytes)
+        : m_frameBytes(frameBytes)
+        , m_capacity(std::max(capacity, MIN_CAPACITY) / frameBytes * frameBytes)
+        , m_buffer(m_capacity) {}
+
+    ~DecodeAhead() { stop(); }
+
+    DecodeAhead(const DecodeAhead&) = delete;
+    DecodeAhead& operator=(const DecodeAhead&) = delete;
+
+    size_t frameBytes() const { return m_frameBytes; }
+
+    void start(ProduceFn produce, std::vector<int> cores = {}) {
+        if (m_thread.joinable()) return;
+        m_produce = std::move(produce);
+        m_stop.store(false, std::memory_order_release);
+        m_thread = std::thread([this, cores]() {
+            applyWorkerPolicy(cores);
+            workerLoop();
+        });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop.store(true, std::memory_order_release);
+        }
+        m_spaceCv.notify_all();
+        m_dataCv.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    /**
+     * @brief Copy up to @p maxBytes, waiting until that much is decoded or the track ended
+     * @return Bytes copied (whole frames); 0 once the worker finished and the FIFO is empty
+     */
+    size_t pop(uint8_t* dst, size_t maxBytes) {
+        maxBytes -= maxBytes % m_frameBytes;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_fill < maxBytes && !m_done && !m_stop) {
+            m_stats.waits++;
+            m_dataCv.wait(lock, [&]() { return m_fill >= maxBytes || m_done || m_stop; });
+        }
+
+        size_t n = std::min(m_fill, maxBytes);
+        size_t first = std::min(n, m_capacity - m_readOff);
+        std::memcpy(dst, m_buffer.data() + m_readOff, first);
+        if (first < n) std::memcpy(dst + first, m_buffer.data(), n - first);
+        m_readOff = (m_readOff + n) % m_capacity;
+        m_fill -= n;
+        m_stats.bytesOut += n;
+        lock.unlock();
+        m_spaceCv.notify_one();
+        return n;
+    }
+
+    /** @brief Worker reached the end of the track and everything was taken */
+    bool drained() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_done && m_fill == 0;
+    }
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats s = m_stats;
+        s.capacity = m_capacity;
+        s.buffered = m_fill;
+        return s;
+    }
+
+    /** @brief SCHED_OTHER on @p cores (every CPU if empty); also used by DstFramePool */
+    static void applyWorkerPolicy(const std::vector<int>& cores) {
+        sched_param param{};
+        pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        if (cores.empty()) {
+            unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned c = 0; c < n && c < CPU_SETSIZE; c++) CPU_SET(c, &cpuset);
+        } else {
+            for (int c : cores) CPU_SET(c, &cpuset);
+        }
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    }
+
+private:
+
+    void workerLoop() {
+        while (!m_stop.load(std::memory_order_acquire)) {
+            const uint8_t* data = nullptr;
+            size_t len = m_produce(&data);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (len == 0) {
+                m_done = true;
+                break;
+            }
+            // Chunks larger than the FIFO are pushed in capacity-sized pieces
+            while (len > 0 && !m_stop) {
+                m_spaceCv.wait(lock, [this]() { return m_fill < m_capacity || m_stop; });
+                if (m_stop) break;
+                size_t n = std::min(len, m_capacity - m_fill);
+                size_t writeOff = (m_readOff + m_fill) % m_capacity;
+                size_t first = std::min(n, m_capacity - writeOff);
+                std::memcpy(m_buffer.data() + writeOff, data, first);
+                if (first < n) std::memcpy(m_buffer.data(), data + first, n - first);
+                m_fill += n;
+                m_stats.bytesIn += n;
+                data += n;
+                len -= n;
+                m_dataCv.notify_one();
+            }
+        }
+        m_dataCv.notify_all();
+    }
+
+    const size_t m_frameBytes;
+    const size_t m_capacity;           // Multiple of m_frameBytes: pieces stay frame-aligned
+    std::vector<uint8_t> m_buffer;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_dataCv;  // Worker -> audio thread: frames, end of track
+    std::condition_variable m_spaceCv; // Audio thread -> worker: space
+
+    // Protected by m_mutex
+    size_t m_readOff = 0;
+    size_t m_fill = 0;
+    bool m_done = false;
+    Stats m_stats;
+
+    ProduceFn m_produce;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+#endif // DECODE_AHEAD_H
@@ -112,6 +112,219 @@ namespace FlowControl {
     constexpr float CRITICAL_BUFFER_LEVEL = 0.10f;                        // Early-return below 10%
 }
 
+// Wire markers: position granularity (markers per second of audio)
+constexpr uint32_t WIRE_POSITION_MARKS_PER_SEC = 20;
+
+//=============================================================================
+// Audio Output - AudioEngine sink feeding DirettaSync
+//=============================================================================
+
+// Everything derived from the track format (AudioFormat, frame size, DSD or
+// PCM path) is worked out in begin(), once per format generation; write()
+// only pushes spans into DirettaSync's ring. The class is final, so the
+// DirettaSync calls below bind statically and the send loops inline here.
+class DirettaRenderer::OutputSink final : public AudioSink {
+public:
+    explicit OutputSink(DirettaRenderer& renderer) : m_renderer(renderer) {}
+
+    bool begin(const Format& format) override;
+    bool write(const uint8_t* data, size_t frames) override;
+
+private:
+    // open() + S24 hint; also the quick resume after stopPlayback()
+    bool openOutput();
+    void writeDSD(const uint8_t* data, size_t samples);
+    void writePCM(const uint8_t* data, size_t frames);
+
+    DirettaRenderer& m_renderer;
+    AudioFormat m_format;
+    TrackInfo::S24Alignment m_s24Alignment = TrackInfo::S24Alignment::Unknown;
+    uint32_t m_wireRate = 0;     // TrackInfo rate, as markWire() expects it
+    size_t m_frameBytes = 0;     // PCM: bytes per frame as sent (24-bit in 32-bit containers)
+};
+
+bool DirettaRenderer::OutputSink::begin(const Format& fmt) {
+    const TrackInfo& trackInfo = fmt.track;
+
+    // Build format
+    AudioFormat format(fmt.sampleRate, fmt.bitDepth, fmt.channels);
+    format.isDSD = trackInfo.isDSD;
+    format.isCompressed = trackInfo.isCompressed;
+    format.isRemoteStream = trackInfo.isRemoteStream;
+
+    if (trackInfo.isDSD) {
+        format.bitDepth = 1;
+        // Use detected source format (from file extension or codec)
+        if (trackInfo.dsdSourceFormat == TrackInfo::DSDSourceFormat::DSF) {
+            format.dsdFormat = AudioFormat::DSDFormat::DSF;
+            DEBUG_LOG("[Callback] DSD format: DSF (LSB first)");
+        } else if (trackInfo.dsdSourceFormat == TrackInfo::DSDSourceFormat::DFF) {
+            format.dsdFormat = AudioFormat::DSDFormat::DFF;
+            DEBUG_LOG("[Callback] DSD format: DFF (MSB first)");
+        } else {
+            // Fallback to codec string if detection failed
+            format.dsdFormat = (trackInfo.codec.find("lsb") != std::string::npos)
+                ? AudioFormat::DSDFormat::DSF
+                : AudioFormat::DSDFormat::DFF;
+            DEBUG_LOG("[Callback] DSD format: "
+                      << (format.dsdFormat == AudioFormat::DSDFormat::DSF ? "DSF" : "DFF")
+                      << " (from codec fallback)");
+        }
+    }
+
+    m_format = format;
+    m_s24Alignment = trackInfo.s24Alignment;
+    m_wireRate = trackInfo.sampleRate;
+    m_frameBytes = (fmt.bitDepth == 24 || fmt.bitDepth == 32)
+        ? 4 * fmt.channels : (fmt.bitDepth / 8) * fmt.channels;
+
+    DirettaSync& sync = *m_renderer.m_direttaSync;
+
+    // CRITICAL FIX: Check for format changes!
+    // When transitioning DSD→PCM (or vice versa), DirettaSync may still be
+    // "playing" but with the wrong format. We must call open() to reconfigure.
+    // (Not playing is handled by write(): open() there also does the quick resume.)
+    if (sync.isPlaying() && sync.isOpen()) {
+        const AudioFormat& currentSyncFormat = sync.getFormat();
+        bool formatChanged = (currentSyncFormat.sampleRate != format.sampleRate ||
+                             currentSyncFormat.bitDepth != format.bitDepth ||
+                             currentSyncFormat.channels != format.channels ||
+                             currentSyncFormat.isDSD != format.isDSD);
+        if (formatChanged) {
+            std::cout << "[Callback] FORMAT CHANGE DETECTED!" << std::endl;
+            std::cout << "[Callback]   Old: " << currentSyncFormat.sampleRate << "Hz/"
+                      << currentSyncFormat.bitDepth << "bit "
+                      << (currentSyncFormat.isDSD ? "DSD" : "PCM") << std::endl;
+            std::cout << "[Callback]   New: " << format.sampleRate << "Hz/"
+                      << format.bitDepth << "bit "
+                      << (format.isDSD ? "DSD" : "PCM") << std::endl;
+
+            // v2.0.1 FIX: Use stopPlayback(false) to send silence before stopping
+            // This flushes the Diretta pipeline and prevents crackling on format transitions
+            // With immediate=true, no silence was sent, causing DAC sync issues
+            sync.stopPlayback(false);
+            return openOutput();
+        }
+    }
+    return true;
+}
+
+bool DirettaRenderer::OutputSink::openOutput() {
+    DirettaSync& sync = *m_renderer.m_direttaSync;
+    if (!sync.open(m_format)) {
+        std::cerr << "[Callback] Failed to open DirettaSync" << std::endl;
+        return false;
+    }
+
+    // Propagate S24 alignment hint to ring buffer for 24-bit PCM
+    // This helps detection when track starts with silence
+    if (!m_format.isDSD && m_format.bitDepth == 24 &&
+        m_s24Alignment != TrackInfo::S24Alignment::Unknown) {
+        DirettaRingBuffer::S24PackMode hint =
+            (m_s24Alignment == TrackInfo::S24Alignment::LsbAligned)
+                ? DirettaRingBuffer::S24PackMode::LsbAligned
+                : DirettaRingBuffer::S24PackMode::MsbAligned;
+        sync.setS24PackModeHint(hint);
+        DEBUG_LOG("[Callback] Set S24 hint: "
+                  << (hint == DirettaRingBuffer::S24PackMode::LsbAligned ? "LSB" : "MSB"));
+    }
+    return true;
+}
+
+bool DirettaRenderer::OutputSink::write(const uint8_t* data, size_t frames) {
+    // Check if shutdown requested (avoid work during teardown)
+    if (m_renderer.m_shutdownRequested.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Lightweight atomic flag (no syscalls in hot path)
+    m_renderer.m_callbackRunning.store(true, std::memory_order_release);
+    struct Guard {
+        std::atomic<bool>& flag;
+        ~Guard() { flag.store(false, std::memory_order_release); }
+    } guard{m_renderer.m_callbackRunning};
+
+    DirettaSync& sync = *m_renderer.m_direttaSync;
+
+    // Open/resume connection if needed
+    // Check isPlaying() not isOpen() - after stopPlayback(), isOpen() is true
+    // but we still need to call open() to trigger quick resume
+    if (!sync.isPlaying() && !openOutput()) {
+        return false;
+    }
+
+    if (sync.wireMarkersEnabled()) {
+        m_renderer.markWire(m_wireRate);
+    }
+
+    // Send audio (DirettaSync handles all format conversions)
+    if (m_format.isDSD) {
+        writeDSD(data, frames);
+    } else {
+        writePCM(data, frames);
+    }
+    return true;
+}
+
+void DirettaRenderer::OutputSink::writeDSD(const uint8_t* data, size_t samples) {
+    DirettaSync& sync = *m_renderer.m_direttaSync;
+
+    // DSD: Atomic send with event-based flow control (G1)
+    // Uses condition variable instead of blocking 5ms sleep
+    // Reduces jitter from ±2.5ms to ±50µs
+    int retryCount = 0;
+    const int maxRetries = 20;  // Reduced: each wait is ~500µs max
+    size_t sent = 0;
+
+    while (sent == 0 && retryCount < maxRetries) {
+        sent = sync.sendAudio(data, samples);
+
+        if (sent == 0) {
+            // Event-based wait: wake on space available or 500µs timeout
+            std::unique_lock<std::mutex> lock(sync.getFlowMutex());
+            sync.waitForSpace(lock, std::chrono::microseconds(500));
+            retryCount++;
+        }
+    }
+
+    if (sent == 0) {
+        std::cerr << "[Callback] DSD timeout after " << retryCount << " retries" << std::endl;
+    }
+}
+
+void DirettaRenderer::OutputSink::writePCM(const uint8_t* data, size_t frames) {
+    DirettaSync& sync = *m_renderer.m_direttaSync;
+
+    // PCM: Incremental send with hybrid flow control
+    size_t remainingSamples = frames;
+
+    // Hybrid flow control: micro-sleep normally, early-return if buffer critical
+    float bufferLevel = sync.getBufferLevel();
+    bool criticalMode = (bufferLevel < FlowControl::CRITICAL_BUFFER_LEVEL);
+
+    int retryCount = 0;
+
+    while (remainingSamples > 0 && retryCount < FlowControl::MAX_RETRIES) {
+        size_t sent = sync.sendAudio(data, remainingSamples);
+
+        if (sent > 0) {
+            size_t samplesConsumed = sent / m_frameBytes;
+            remainingSamples -= samplesConsumed;
+            data += sent;
+            retryCount = 0;
+        } else {
+            if (criticalMode) {
+                // Buffer critically low - return immediately to prioritize refill
+                DEBUG_LOG("[Audio] Early-return, buffer critical: " << bufferLevel);
+                break;
+            }
+            // Normal backpressure: 500µs micro-sleep (was 10ms)
+            std::this_thread::sleep_for(std::chrono::microseconds(FlowControl::MICROSLEEP_US));
+            retryCount++;
+        }
+    }
+}
+
 //=============================================================================
 // Auto-release: free Diretta target after idle for coexistence
 //=============================================================================
@@ -209,6 +422,13 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
         // Create and enable DirettaSync
         m_direttaSync = std::make_unique<DirettaSync>();
         m_direttaSync->setTargetIndex(m_config.targetIndex);
+        m_direttaSync->setWireMarkerHandler([this](const WireMarkers::Event& e) {
+            if (e.kind == WireMarkers::Kind::Track) releaseTrackChange(e.track);
+            if (!e.flushed && e.sampleRate > 0) {
+                m_wirePosition.store(static_cast<double>(e.frame) / e.sampleRate,
+                                     std::memory_order_relaxed);
+            }
+        });
 
         DirettaConfig syncConfig;
 
@@ -239,6 +459,20 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
         }
         if (m_config.targetProfileLimitTime >= 0)
             syncConfig.targetProfileLimitTime = static_cast<unsigned int>(m_config.targetProfileLimitTime);
+        if (!m_config.workerWait.empty()) {
+            if (m_config.workerWait == "abstime")
+                syncConfig.workerWait = DirettaWorkerWait::ABSTIME;
+            else if (m_config.workerWait == "timerfd")
+                syncConfig.workerWait = DirettaWorkerWait::TIMERFD;
+            else
+                syncConfig.workerWait = DirettaWorkerWait::SLEEP;
+        }
+        syncConfig.convertOnPop = m_config.convertOnPop;
+        syncConfig.constantWorkConsumer = m_config.constantWorkConsumer;
+        syncConfig.bitPerfectVerify = m_config.bitPerfectVerify;
+        syncConfig.wireMarkers = m_config.wireMarkers;
+        syncConfig.tapDumpPath = m_config.tapDumpPath;
+        syncConfig.targetCachePath = m_config.targetCachePath;
 
         // CPU affinity (pass full core list to DirettaSync for worker thread pinning)
         syncConfig.cpuAudio = m_config.cpuAudio;
@@ -274,12 +508,24 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
         if (m_config.targetProfileLimitTime >= 0)
             std::cout << "[DirettaRenderer] Target profile limit: " << syncConfig.targetProfileLimitTime
                       << " us (" << (syncConfig.targetProfileLimitTime > 0 ? "TargetProfile" : "SelfProfile") << ")" << std::endl;
+        if (!m_config.workerWait.empty())
+            std::cout << "[DirettaRenderer] Worker wait: " << m_config.workerWait << std::endl;
+        if (m_config.convertOnPop)
+            std::cout << "[DirettaRenderer] Ring mode: convert-on-pop" << std::endl;
+        if (m_config.constantWorkConsumer)
+            std::cout << "[DirettaRenderer] Consumer: constant-work" << std::endl;
+        if (m_config.wireMarkers)
+            std::cout << "[DirettaRenderer] Track change/position: wire markers" << std::endl;
+        if (!m_config.targetCachePath.empty())
+            std::cout << "[DirettaRenderer] Target cache: " << m_config.targetCachePath << std::endl;
         if (!m_config.cpuAudio.empty())
             std::cout << "[DirettaRenderer] CPU audio (Diretta worker): core(s) " << m_config.cpuAudio << std::endl;
         if (!m_config.cpuDecode.empty())
             std::cout << "[DirettaRenderer] CPU decode (Audio decode): core(s) " << m_config.cpuDecode << std::endl;
         if (!m_config.cpuOther.empty())
             std::cout << "[DirettaRenderer] CPU other (UPnP/Position): core(s) " << m_config.cpuOther << std::endl;
+        if (!m_config.cpuDemux.empty())
+            std::cout << "[DirettaRenderer] CPU demux: core(s) " << m_config.cpuDemux << std::endl;
         if (m_config.pcmBufferSeconds > 0)
             std::cout << "[DirettaRenderer] PCM buffer: " << m_config.pcmBufferSeconds << "s" << std::endl;
         if (m_config.pcmRemoteBufferSeconds > 0)
@@ -292,38 +538,40 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
             std::cout << "[DirettaRenderer] PCM remote prefill: " << m_config.pcmRemotePrefillMs << "ms" << std::endl;
         if (m_config.dsdPrefillMs > 0)
             std::cout << "[DirettaRenderer] DSD prefill: " << m_config.dsdPrefillMs << "ms" << std::endl;
-
-        if (!m_direttaSync->enable(syncConfig, stopSignal)) {
-            std::cerr << "[DirettaRenderer] Failed to enable DirettaSync" << std::endl;
-            return false;
-        }
-
-        std::cout << "[DirettaRenderer] Diretta Target ready" << std::endl;
-
-        // Pre-connect with default format to warm up Diretta pipeline
-        // This eliminates the ~5s glitch on first play
-        {
-            AudioFormat warmupFmt;
-            warmupFmt.sampleRate = 44100;
-            warmupFmt.bitDepth = 24;
-            warmupFmt.channels = 2;
-            warmupFmt.isDSD = false;
-            std::cout << "[DirettaRenderer] Pre-connecting Diretta (warmup)..." << std::endl;
-            if (m_direttaSync->open(warmupFmt)) {
-                m_direttaSync->stopPlayback(true);
-
-                // Hold the SDK connection long enough for the Diretta Target to exit
-                // a stale idle-mode before we close, then leave it closed — the first
-                // real play will pay the cold-connect cost again, but the boot ends
-                // with Target in a usable state instead of stuck-claiming.
-                std::this_thread::sleep_for(std::chrono::seconds(6));
-                m_direttaSync->release();
-
-                std::cout << "[DirettaRenderer] Diretta warmup + target reset complete" << std::endl;
-            } else {
-                std::cerr << "[DirettaRenderer] Warmup pre-connect failed (non-fatal)" << std::endl;
-            }
-        }
+        if (m_config.httpBufferMB > 0)
+            std::cout << "[DirettaRenderer] HTTP read-ahead: " << m_config.httpBufferMB << " MB per stream" << std::endl;
+        if (!m_config.trackCacheDir.empty())
+            std::cout << "[DirettaRenderer] Track cache: " << m_config.trackCacheDir
+                      << " (" << m_config.trackCacheMB << " MB)" << std::endl;
+        if (m_config.httpPoolPerHost > 0)
+            std::cout << "[DirettaRenderer] HTTP keep-alive pool: " << m_config.httpPoolPerHost
+                      << " connection(s) per server" << std::endl;
+        if (m_config.httpConnections > 1)
+            std::cout << "[DirettaRenderer] Parallel range download: up to " << m_config.httpConnections
+                      << " connections per track" << std::endl;
+        if (m_config.probeCache)
+            std::cout << "[DirettaRenderer] Probe cache: on" << std::endl;
+        if (m_config.mmapFiles)
+            std::cout << "[DirettaRenderer] Local files: mmap" << std::endl;
+        else if (m_config.ioUring)
+            std::cout << "[DirettaRenderer] Local files: io_uring read-ahead" << std::endl;
+        if (m_config.memoryPlayMB > 0)
+            std::cout << "[DirettaRenderer] Memory play: " << m_config.memoryPlayMB << " MB" << std::endl;
+        if (m_config.decodeAheadMB > 0)
+            std::cout << "[DirettaRenderer] Decode-ahead: " << m_config.decodeAheadMB << " MB per track" << std::endl;
+        if (m_config.prerollMs > 0)
+            std::cout << "[DirettaRenderer] Next-track pre-roll: " << m_config.prerollMs << "ms" << std::endl;
+        if (m_config.dstThreads > 0)
+            std::cout << "[DirettaRenderer] DST decode threads: " << m_config.dstThreads << std::endl;
+        if (m_config.demuxPackets > 0)
+            std::cout << "[DirettaRenderer] Demux thread: " << m_config.demuxPackets << " packet queue" << std::endl;
+
+        // Diretta enable + warmup run in the background (discovery, MTU and the
+        // warmup hold take several seconds). UPnP comes up immediately; actions
+        // that arrive meanwhile are queued by runWhenDirettaReady().
+        m_running = true;
+        m_direttaStartThread = std::thread(&DirettaRenderer::direttaStartupFunc, this,
+                                           syncConfig, stopSignal != nullptr);
 
         // Create UPnP device
         UPnPDevice::Config upnpConfig;
@@ -339,175 +587,58 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
 
         // Create AudioEngine
         m_audioEngine = std::make_unique<AudioEngine>();
+        if (m_config.httpBufferMB > 0) {
+            m_audioEngine->setHttpReadAhead(static_cast<size_t>(m_config.httpBufferMB) << 20);
+        }
+        if (!m_config.trackCacheDir.empty()) {
+            m_trackCache = std::make_unique<TrackCache>(
+                m_config.trackCacheDir, static_cast<uint64_t>(m_config.trackCacheMB) << 20);
+            m_audioEngine->setTrackCache(m_trackCache.get());
+        }
+        // Parallel ranges need the pool: room for the current and the next track
+        int poolPerHost = m_config.httpPoolPerHost > 0 ? m_config.httpPoolPerHost
+                        : (m_config.httpConnections > 1 ? 2 * m_config.httpConnections : 0);
+        if (poolPerHost > 0) {
+            m_httpPool = std::make_unique<HttpConnectionPool>(poolPerHost);
+            m_audioEngine->setHttpPool(m_httpPool.get());
+            m_audioEngine->setParallelRanges(static_cast<unsigned>(std::max(1, m_config.httpConnections)));
+        }
+        m_audioEngine->setProbeCache(m_config.probeCache);
+        m_audioEngine->setIoUring(m_config.ioUring);
+        m_audioEngine->setMmap(m_config.mmapFiles);
+        if (m_config.memoryPlayMB > 0) {
+            m_audioEngine->setMemoryPlay(static_cast<size_t>(m_config.memoryPlayMB) << 20);
+        }
+        if (m_config.decodeAheadMB > 0) {
+            // Workers share the --cpu-other cores, away from the RT audio thread
+            m_audioEngine->setDecodeAhead(static_cast<size_t>(m_config.decodeAheadMB) << 20,
+                                          parseCoreList(m_config.cpuOther));
+        }
+        if (m_config.prerollMs > 0) {
+            m_audioEngine->setPreroll(static_cast<uint32_t>(m_config.prerollMs));
+        }
+        // DST workers, like decode-ahead, stay off the RT audio thread's cores
+        m_audioEngine->setDstDecode(static_cast<unsigned>(std::max(0, m_config.dstThreads)),
+                                    parseCoreList(m_config.cpuOther));
+        if (m_config.demuxPackets > 0) {
+            // Reads (network-bound) off the decode thread: --cpu-demux, else the --cpu-other cores
+            m_audioEngine->setDemuxThread(static_cast<size_t>(m_config.demuxPackets),
+                                          parseCoreList(m_config.cpuDemux.empty() ? m_config.cpuOther
+                                                                                  : m_config.cpuDemux));
+        }
 
         // Set real-time position callback for accurate GetPositionInfo responses
         // (bypasses 1s position thread cache - fixes UAPP compatibility)
         m_upnp->setPositionCallback([this]() -> double {
-            if (m_audioEngine) return m_audioEngine->getPosition();
-            return 0.0;
+            return currentPosition();
         });
 
         //=====================================================================
-        // Audio Callback - Simplified
+        // Audio Output
         //=====================================================================
 
-        m_audioEngine->setAudioCallback(
-            [this](const AudioBuffer& buffer, size_t samples,
-                   uint32_t sampleRate, uint32_t bitDepth, uint32_t channels) -> bool {
-
-                // Check if shutdown requested (avoid work during teardown)
-                if (m_shutdownRequested.load(std::memory_order_acquire)) {
-                    return false;
-                }
-
-                // Lightweight atomic flag (no syscalls in hot path)
-                m_callbackRunning.store(true, std::memory_order_release);
-                struct Guard {
-                    std::atomic<bool>& flag;
-                    ~Guard() { flag.store(false, std::memory_order_release); }
-                } guard{m_callbackRunning};
-
-                const TrackInfo& trackInfo = m_audioEngine->getCurrentTrackInfo();
-
-                // Build format
-                AudioFormat format(sampleRate, bitDepth, channels);
-                format.isDSD = trackInfo.isDSD;
-                format.isCompressed = trackInfo.isCompressed;
-                format.isRemoteStream = trackInfo.isRemoteStream;
-
-                if (trackInfo.isDSD) {
-                    format.bitDepth = 1;
-                    // Use detected source format (from file extension or codec)
-                    if (trackInfo.dsdSourceFormat == TrackInfo::DSDSourceFormat::DSF) {
-                        format.dsdFormat = AudioFormat::DSDFormat::DSF;
-                        DEBUG_LOG("[Callback] DSD format: DSF (LSB first)");
-                    } else if (trackInfo.dsdSourceFormat == TrackInfo::DSDSourceFormat::DFF) {
-                        format.dsdFormat = AudioFormat::DSDFormat::DFF;
-                        DEBUG_LOG("[Callback] DSD format: DFF (MSB first)");
-                    } else {
-                        // Fallback to codec string if detection failed
-                        format.dsdFormat = (trackInfo.codec.find("lsb") != std::string::npos)
-                            ? AudioFormat::DSDFormat::DSF
-                            : AudioFormat::DSDFormat::DFF;
-                        DEBUG_LOG("[Callback] DSD format: "
-                                  << (format.dsdFormat == AudioFormat::DSDFormat::DSF ? "DSF" : "DFF")
-                                  << " (from codec fallback)");
-                    }
-                }
-
-                // Open/resume connection if needed
-                // Check isPlaying() not isOpen() - after stopPlayback(), isOpen() is true
-                // but we still need to call open() to trigger quick resume
-                //
-                // CRITICAL FIX: Also check for format changes!
-                // When transitioning DSD→PCM (or vice versa), DirettaSync may still be
-                // "playing" but with the wrong format. We must call open() to reconfigure.
-                bool needsOpen = !m_direttaSync->isPlaying();
-
-                if (!needsOpen && m_direttaSync->isOpen()) {
-                    // Check if format has changed
-                    const AudioFormat& currentSyncFormat = m_direttaSync->getFormat();
-                    bool formatChanged = (currentSyncFormat.sampleRate != format.sampleRate ||
-                                         currentSyncFormat.bitDepth != format.bitDepth ||
-                                         currentSyncFormat.channels != format.channels ||
-                                         currentSyncFormat.isDSD != format.isDSD);
-                    if (formatChanged) {
-                        std::cout << "[Callback] FORMAT CHANGE DETECTED!" << std::endl;
-                        std::cout << "[Callback]   Old: " << currentSyncFormat.sampleRate << "Hz/"
-                                  << currentSyncFormat.bitDepth << "bit "
-                                  << (currentSyncFormat.isDSD ? "DSD" : "PCM") << std::endl;
-                        std::cout << "[Callback]   New: " << format.sampleRate << "Hz/"
-                                  << format.bitDepth << "bit "
-                                  << (format.isDSD ? "DSD" : "PCM") << std::endl;
-
-                        // v2.0.1 FIX: Use stopPlayback(false) to send silence before stopping
-                        // This flushes the Diretta pipeline and prevents crackling on format transitions
-                        // With immediate=true, no silence was sent, causing DAC sync issues
-                        m_direttaSync->stopPlayback(false);
-                        needsOpen = true;
-                    }
-                }
-
-                if (needsOpen) {
-                    if (!m_direttaSync->open(format)) {
-                        std::cerr << "[Callback] Failed to open DirettaSync" << std::endl;
-                        return false;
-                    }
-
-                    // Propagate S24 alignment hint to ring buffer for 24-bit PCM
-                    // This helps detection when track starts with silence
-                    if (!format.isDSD && bitDepth == 24 &&
-                        trackInfo.s24Alignment != TrackInfo::S24Alignment::Unknown) {
-                        DirettaRingBuffer::S24PackMode hint =
-                            (trackInfo.s24Alignment == TrackInfo::S24Alignment::LsbAligned)
-                                ? DirettaRingBuffer::S24PackMode::LsbAligned
-                                : DirettaRingBuffer::S24PackMode::MsbAligned;
-                        m_direttaSync->setS24PackModeHint(hint);
-                        DEBUG_LOG("[Callback] Set S24 hint: "
-                                  << (hint == DirettaRingBuffer::S24PackMode::LsbAligned ? "LSB" : "MSB"));
-                    }
-                }
-
-                // Send audio (DirettaSync handles all format conversions)
-                if (trackInfo.isDSD) {
-                    // DSD: Atomic send with event-based flow control (G1)
-                    // Uses condition variable instead of blocking 5ms sleep
-                    // Reduces jitter from ±2.5ms to ±50µs
-                    int retryCount = 0;
-                    const int maxRetries = 20;  // Reduced: each wait is ~500µs max
-                    size_t sent = 0;
-
-                    while (sent == 0 && retryCount < maxRetries) {
-                        sent = m_direttaSync->sendAudio(buffer.data(), samples);
-
-                        if (sent == 0) {
-                            // Event-based wait: wake on space available or 500µs timeout
-                            std::unique_lock<std::mutex> lock(m_direttaSync->getFlowMutex());
-                            m_direttaSync->waitForSpace(lock, std::chrono::microseconds(500));
-                            retryCount++;
-                        }
-                    }
-
-                    if (sent == 0) {
-                        std::cerr << "[Callback] DSD timeout after " << retryCount << " retries" << std::endl;
-                    }
-                } else {
-                    // PCM: Incremental send with hybrid flow control
-                    const uint8_t* audioData = buffer.data();
-                    size_t remainingSamples = samples;
-                    size_t bytesPerSample = (bitDepth == 24 || bitDepth == 32)
-                        ? 4 * channels : (bitDepth / 8) * channels;
-
-                    // Hybrid flow control: micro-sleep normally, early-return if buffer critical
-                    float bufferLevel = m_direttaSync->getBufferLevel();
-                    bool criticalMode = (bufferLevel < FlowControl::CRITICAL_BUFFER_LEVEL);
-
-                    int retryCount = 0;
-
-                    while (remainingSamples > 0 && retryCount < FlowControl::MAX_RETRIES) {
-                        size_t sent = m_direttaSync->sendAudio(audioData, remainingSamples);
-
-                        if (sent > 0) {
-                            size_t samplesConsumed = sent / bytesPerSample;
-                            remainingSamples -= samplesConsumed;
-                            audioData += sent;
-                            retryCount = 0;
-                        } else {
-                            if (criticalMode) {
-                                // Buffer critically low - return immediately to prioritize refill
-                                DEBUG_LOG("[Audio] Early-return, buffer critical: " << bufferLevel);
-                                break;
-                            }
-                            // Normal backpressure: 500µs micro-sleep (was 10ms)
-                            std::this_thread::sleep_for(std::chrono::microseconds(FlowControl::MICROSLEEP_US));
-                            retryCount++;
-                        }
-                    }
-                }
-
-                return true;
-            }
-        );
+        m_outputSink = std::make_unique<OutputSink>(*this);
+        m_audioEngine->setAudioSink(m_outputSink.get());
 
         //=====================================================================
         // Track Change Callback
@@ -544,10 +675,29 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
                 // Uses epoch counter to prevent position thread from overwriting
                 // with stale values (fixes Audirvana UI not updating on track change)
                 int durationSec = (info.sampleRate > 0) ? static_cast<int>(info.duration / info.sampleRate) : 0;
-                m_upnp->notifyGaplessTransition(uri, metadata, durationSec);
+                if (m_direttaSync && m_direttaSync->wireMarkersEnabled()) {
+                    // Deferred until the track's first byte reaches the SDK (releaseTrackChange)
+                    std::lock_guard<std::mutex> lock(m_wireMutex);
+                    uint32_t seq = m_trackSeq.load(std::memory_order_relaxed) + 1;
+                    m_pendingTrackChanges.push_back({seq, uri, metadata, durationSec});
+                    m_trackSeq.store(seq, std::memory_order_release);
+                    if (!m_direttaSync->isPlaying()) {
+                        resetWirePosition();
+                    }
+                } else {
+                    m_upnp->notifyGaplessTransition(uri, metadata, durationSec);
+                }
+
+                // Per-track bit-perfect reports (no-op unless the tap is enabled)
+                if (m_direttaSync) m_direttaSync->markTrackBoundary();
             }
         );
 
+        // Seek: drop the audio still queued from the old position (audio thread)
+        m_audioEngine->setSeekCallback([this](std::chrono::steady_clock::time_point requestedAt) {
+            if (m_direttaSync) m_direttaSync->flushForSeek(requestedAt);
+        });
+
         m_audioEngine->setTrackEndCallback([this]() {
             std::cout << "[DirettaRenderer] Track ended naturally" << std::endl;
 
@@ -632,6 +782,7 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
                 m_upnp->notifyStateChange("STOPPED");
             }
 
+            resetWirePosition();
             m_currentURI = uri;
             m_currentMetadata = metadata;
             m_audioEngine->setCurrentURI(uri, metadata);
@@ -724,6 +875,7 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
 
             m_audioEngine->stop();
             waitForCallbackComplete();
+            resetWirePosition();
 
             if (!m_currentURI.empty()) {
                 m_audioEngine->setCurrentURI(m_currentURI, m_currentMetadata, true);
@@ -748,11 +900,29 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
             std::cout << "[DirettaRenderer] Seek: " << target << std::endl;
 
             double seconds = parseTimeString(target);
+            resetWirePosition();
             if (m_audioEngine) {
                 m_audioEngine->seek(seconds);
             }
         };
 
+        // Actions received while Diretta is still starting are queued and
+        // replayed in arrival order once enable + warmup have finished
+        callbacks.onSetURI = [this, fn = callbacks.onSetURI](const std::string& uri,
+                                                             const std::string& metadata) {
+            runWhenDirettaReady("SetURI", [fn, uri, metadata]() { fn(uri, metadata); });
+        };
+        callbacks.onSetNextURI = [this, fn = callbacks.onSetNextURI](const std::string& uri,
+                                                                     const std::string& metadata) {
+            runWhenDirettaReady("SetNextURI", [fn, uri, metadata]() { fn(uri, metadata); });
+        };
+        callbacks.onPlay = [this, fn = callbacks.onPlay]() { runWhenDirettaReady("Play", fn); };
+        callbacks.onPause = [this, fn = callbacks.onPause]() { runWhenDirettaReady("Pause", fn); };
+        callbacks.onStop = [this, fn = callbacks.onStop]() { runWhenDirettaReady("Stop", fn); };
+        callbacks.onSeek = [this, fn = callbacks.onSeek](const std::string& target) {
+            runWhenDirettaReady("Seek", [fn, target]() { fn(target); });
+        };
+
         m_upnp->setCallbacks(callbacks);
 
         // Start UPnP server (retry until network is ready or cancelled)
@@ -770,12 +940,14 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
                 // No stop signal = no retry (legacy behavior)
                 if (!stopSignal) {
                     std::cerr << "[DirettaRenderer] Failed to start UPnP server" << std::endl;
+                    stop();
                     return false;
                 }
 
-                // Check if shutdown requested
-                if (!stopSignal->load(std::memory_order_acquire)) {
+                // Check if shutdown requested (or Diretta startup failed)
+                if (!stopSignal->load(std::memory_order_acquire) || !m_running) {
                     std::cerr << "[DirettaRenderer] UPnP startup cancelled" << std::endl;
+                    stop();
                     return false;
                 }
 
@@ -792,6 +964,7 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
                 // Wait 2s before retry, checking stop signal
                 for (int waited = 0; waited < 2000; waited += 100) {
                     if (stopSignal && !stopSignal->load(std::memory_order_acquire)) {
+                        stop();
                         return false;
                     }
                     std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -802,7 +975,6 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
         DEBUG_LOG("[DirettaRenderer] UPnP: " << m_upnp->getDeviceURL());
 
         // Start threads
-        m_running = true;
         m_upnpThread = std::thread(&DirettaRenderer::upnpThreadFunc, this);
         m_audioThread = std::thread(&DirettaRenderer::audioThreadFunc, this);
         if (!g_minimalUPnP) {
@@ -811,7 +983,8 @@ bool DirettaRenderer::start(std::atomic<bool>* stopSignal) {
             DEBUG_LOG("[DirettaRenderer] Minimal UPnP: position thread disabled");
         }
 
-        std::cout << "[DirettaRenderer] Started" << std::endl;
+        std::cout << "[DirettaRenderer] Started"
+                  << (m_direttaReady ? "" : " (Diretta target still starting)") << std::endl;
         return true;
 
     } catch (const std::exception& e) {
@@ -829,14 +1002,49 @@ void DirettaRenderer::dumpStats() const {
     if (m_direttaSync) {
         m_direttaSync->dumpStats();
     }
+    if (m_audioEngine && m_config.memoryPlayMB > 0) {
+        AudioEngine::MemoryPlayStatus mem = m_audioEngine->getMemoryPlayStatus();
+        auto progress = [](const MemoryTrack::Progress& p) {
+            if (!p.inMemory) return std::string("streaming");
+            return std::to_string(p.downloaded >> 20) + "/" + std::to_string(p.size >> 20) + " MB (" +
+                   std::to_string(p.size > 0 ? p.downloaded * 100 / p.size : 0) + "%)";
+        };
+        std::cout << "[DirettaRenderer] Memory play: current " << progress(mem.current)
+                  << ", next " << progress(mem.next) << ", budget "
+                  << (mem.used >> 20) << "/" << (mem.limit >> 20) << " MB" << std::endl;
+    }
+    if (m_httpPool) {
+        HttpConnectionPool::Stats hp = m_httpPool->getStats();
+        std::cout << "[DirettaRenderer] HTTP keep-alive: " << hp.connects << " connect(s), "
+                  << hp.reuses << " reuse(s), " << hp.waits << " slot wait(s), "
+                  << hp.idle << " idle" << std::endl;
+    }
+    if (m_audioEngine && m_config.probeCache) {
+        StreamProbeCache::Stats pc = m_audioEngine->getProbeCacheStats();
+        std::cout << "[DirettaRenderer] Probe cache: " << pc.hits << " hit(s), " << pc.misses
+                  << " miss(es), " << pc.stale << " stale, " << pc.entries << " entries" << std::endl;
+    }
+    if (m_audioEngine && m_config.demuxPackets > 0) {
+        AudioEngine::DemuxStatus dm = m_audioEngine->getDemuxStatus();
+        std::cout << "[DirettaRenderer] Demux queue: " << dm.depth << "/" << dm.capacity
+                  << " packets, decoder waited " << dm.decoderWaits << "x, demux waited "
+                  << dm.demuxWaits << "x (queue full)" << std::endl;
+    }
+    if (m_audioEngine && m_config.prerollMs > 0) {
+        AudioEngine::PrerollStatus pr = m_audioEngine->getPrerollStatus();
+        std::cout << "[DirettaRenderer] Pre-roll: next " << pr.nextReadyMs << "/" << pr.targetMs
+                  << " ms decoded, last transition " << pr.lastTransitionMs << " ms" << std::endl;
+    }
 }
 
 void DirettaRenderer::stop() {
-    if (!m_running) return;
+    // A failed Diretta startup clears m_running itself and leaves the teardown here
+    if (!m_running.exchange(false) && !m_startupFailed.exchange(false)) return;
 
     DEBUG_LOG("[DirettaRenderer] Stopping...");
 
-    m_running = false;
+    // Cancels discovery / the warmup hold (both watch m_running)
+    if (m_direttaStartThread.joinable()) m_direttaStartThread.join();
 
     if (m_audioEngine) {
         m_audioEngine->stop();
@@ -861,6 +1069,89 @@ void DirettaRenderer::stop() {
 // Thread Functions
 //=============================================================================
 
+void DirettaRenderer::direttaStartupFunc(const DirettaConfig& syncConfig, bool retry) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    // m_running doubles as the discovery stop signal (cleared by stop())
+    if (!m_direttaSync->enable(syncConfig, retry ? &m_running : nullptr)) {
+        std::lock_guard<std::mutex> lock(m_startupMutex);
+        m_startupQueue.clear();
+        if (m_running) {
+            std::cerr << "[DirettaRenderer] Failed to enable DirettaSync" << std::endl;
+            m_startupFailed = true;
+            m_running = false;
+        }
+        return;
+    }
+
+    std::cout << "[DirettaRenderer] Diretta Target ready" << std::endl;
+
+    // Pre-connect with default format to warm up Diretta pipeline
+    // This eliminates the ~5s glitch on first play
+    {
+        AudioFormat warmupFmt;
+        warmupFmt.sampleRate = 44100;
+        warmupFmt.bitDepth = 24;
+        warmupFmt.channels = 2;
+        warmupFmt.isDSD = false;
+        std::cout << "[DirettaRenderer] Pre-connecting Diretta (warmup)..." << std::endl;
+        if (m_direttaSync->open(warmupFmt)) {
+            m_direttaSync->stopPlayback(true);
+
+            // Hold the SDK connection long enough for the Diretta Target to exit
+            // a stale idle-mode before we close, then leave it closed — the first
+            // real play will pay the cold-connect cost again, but the boot ends
+            // with Target in a usable state instead of stuck-claiming.
+            for (int waited = 0; waited < 6000 && m_running; waited += 100) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            m_direttaSync->release();
+
+            std::cout << "[DirettaRenderer] Diretta warmup + target reset complete" << std::endl;
+        } else {
+            std::cerr << "[DirettaRenderer] Warmup pre-connect failed (non-fatal)" << std::endl;
+        }
+    }
+
+    // Replay queued actions in order. Actions arriving during the replay are
+    // appended to the queue, so ordering holds until the queue is empty.
+    size_t replayed = 0;
+    while (m_running) {
+        std::function<void()> action;
+        {
+            std::lock_guard<std::mutex> lock(m_startupMutex);
+            if (m_startupQueue.empty()) {
+                m_direttaReady = true;
+                break;
+            }
+            action = std::move(m_startupQueue.front());
+            m_startupQueue.pop_front();
+        }
+        action();
+        replayed++;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    std::cout << "[DirettaRenderer] Diretta startup complete in " << elapsed.count() << "ms";
+    if (replayed > 0) std::cout << " (" << replayed << " queued action(s) replayed)";
+    std::cout << std::endl;
+}
+
+void DirettaRenderer::runWhenDirettaReady(const char* name, std::function<void()> action) {
+    if (!m_direttaReady.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(m_startupMutex);
+        // Re-check under the lock: the startup thread sets ready with the queue empty
+        if (!m_direttaReady.load(std::memory_order_relaxed)) {
+            std::cout << "[DirettaRenderer] " << name << " queued until Diretta target is ready"
+                      << std::endl;
+            m_startupQueue.push_back(std::move(action));
+            return;
+        }
+    }
+    action();
+}
+
 void DirettaRenderer::upnpThreadFunc() {
     auto cores = parseCoreList(m_config.cpuOther);
     if (!cores.empty()) pinThreadToCores(cores, "UPnP Thread");
@@ -892,6 +1183,14 @@ void DirettaRenderer::audioThreadFunc() {
     constexpr float BUFFER_HIGH_THRESHOLD = 0.5f;  // Throttle when >50% full
     constexpr float BUFFER_LOW_THRESHOLD = 0.25f;  // Warn when <25% full
 
+    // Clock drift feed-forward: a sustained fill trend means source and target
+    // clocks disagree (e.g. long live radio streams). Move the throttle point
+    // before the trend turns into an underrun (or a permanently full ring).
+    constexpr float BUFFER_HIGH_THRESHOLD_DRAINING = 0.75f;  // Build headroom
+    constexpr float BUFFER_HIGH_THRESHOLD_FILLING = 0.40f;   // Yield earlier
+    constexpr double DRIFT_HORIZON_S = 60.0;                 // Act on predictions within 1 min
+    int driftTrend = 0;  // -1 draining, 0 steady, +1 filling (for transition logging)
+
     uint32_t lastSampleRate = 0;
     size_t currentSamplesPerCall = 8192;
 
@@ -936,11 +1235,37 @@ void DirettaRenderer::audioThreadFunc() {
             // If not playing (after stop), bufferLevel stays 0 so we call process()
             // which triggers the open/quick-resume path in the audio callback
             float bufferLevel = 0.0f;
+            float highThreshold = BUFFER_HIGH_THRESHOLD;
             if (m_direttaSync && m_direttaSync->isPlaying()) {
                 bufferLevel = m_direttaSync->getBufferLevel();
+
+                auto drift = m_direttaSync->updateClockDrift();
+                int trend = 0;
+                if (drift.valid && drift.secondsToUnderrun >= 0 && drift.secondsToUnderrun < DRIFT_HORIZON_S) {
+                    trend = -1;
+                    highThreshold = BUFFER_HIGH_THRESHOLD_DRAINING;
+                } else if (drift.valid && drift.secondsToOverrun >= 0 && drift.secondsToOverrun < DRIFT_HORIZON_S &&
+                           bufferLevel > BUFFER_HIGH_THRESHOLD) {
+                    // Above the normal throttle point: not just the post-prefill ramp-up
+                    trend = 1;
+                    highThreshold = BUFFER_HIGH_THRESHOLD_FILLING;
+                }
+                if (trend != driftTrend) {
+                    if (trend < 0) {
+                        LOG_WARN("[Audio Thread] Ring draining (" << static_cast<int>(drift.fillSlope)
+                                 << " B/s, target clock " << drift.ppm << " ppm) - underrun predicted in "
+                                 << static_cast<int>(drift.secondsToUnderrun) << "s");
+                    } else if (trend > 0) {
+                        LOG_INFO("[Audio Thread] Ring filling (+" << static_cast<int>(drift.fillSlope)
+                                 << " B/s, target clock " << drift.ppm << " ppm) - throttling earlier");
+                    } else {
+                        LOG_INFO("[Audio Thread] Ring fill trend steady (target clock " << drift.ppm << " ppm)");
+                    }
+                    driftTrend = trend;
+                }
             }
 
-            if (bufferLevel > BUFFER_HIGH_THRESHOLD) {
+            if (bufferLevel > highThreshold) {
                 // Buffer is healthy - throttle to avoid wasting CPU
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
             } else {
@@ -981,6 +1306,55 @@ void DirettaRenderer::audioThreadFunc() {
     DEBUG_LOG("[Audio Thread] Stopped");
 }
 
+void DirettaRenderer::markWire(uint32_t sampleRate) {
+    uint32_t seq = m_trackSeq.load(std::memory_order_acquire);
+    uint64_t frame = m_audioEngine->getSamplesPlayed();
+
+    if (seq != m_markedTrackSeq) {
+        if (m_direttaSync->markWire(WireMarkers::Kind::Track, seq, frame, sampleRate)) {
+            m_markedTrackSeq = seq;
+            m_lastPositionMark = frame;
+        }
+    } else if (frame < m_lastPositionMark ||
+               frame - m_lastPositionMark >= sampleRate / WIRE_POSITION_MARKS_PER_SEC) {
+        // Seek moves backwards; otherwise one position marker per 50ms of audio
+        if (m_direttaSync->markWire(WireMarkers::Kind::Position, seq, frame, sampleRate)) {
+            m_lastPositionMark = frame;
+        }
+    }
+}
+
+void DirettaRenderer::releaseTrackChange(uint32_t seq) {
+    PendingTrackChange change;
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(m_wireMutex);
+        while (!m_pendingTrackChanges.empty() &&
+               static_cast<int32_t>(m_pendingTrackChanges.front().seq - seq) <= 0) {
+            change = std::move(m_pendingTrackChanges.front());
+            m_pendingTrackChanges.pop_front();
+            found = true;
+        }
+    }
+    if (found && m_upnp) {
+        m_wireDuration.store(change.durationSec, std::memory_order_relaxed);
+        m_upnp->notifyGaplessTransition(change.uri, change.metadata, change.durationSec);
+    }
+}
+
+void DirettaRenderer::resetWirePosition() {
+    m_wirePosition.store(-1.0, std::memory_order_relaxed);
+    m_wireDuration.store(-1, std::memory_order_relaxed);
+}
+
+double DirettaRenderer::currentPosition() const {
+    if (m_direttaReady && m_direttaSync && m_direttaSync->wireMarkersEnabled()) {
+        double wire = m_wirePosition.load(std::memory_order_relaxed);
+        if (wire >= 0.0) return wire;
+    }
+    return m_audioEngine ? m_audioEngine->getPosition() : 0.0;
+}
+
 void DirettaRenderer::positionThreadFunc() {
     auto cores = parseCoreList(m_config.cpuOther);
     if (!cores.empty()) pinThreadToCores(cores, "Position Thread");
@@ -998,7 +1372,7 @@ void DirettaRenderer::positionThreadFunc() {
             // Read epoch BEFORE reading audio engine state
             uint32_t epochBefore = m_upnp->getTrackEpoch();
 
-            double positionSeconds = m_audioEngine->getPosition();
+            double positionSeconds = currentPosition();
             int position = static_cast<int>(positionSeconds);
 
             const auto& trackInfo = m_audioEngine->getCurrentTrackInfo();
@@ -1006,10 +1380,17 @@ void DirettaRenderer::positionThreadFunc() {
             if (trackInfo.sampleRate > 0) {
                 duration = trackInfo.duration / trackInfo.sampleRate;
             }
+            // Wire markers: until the next track's first byte is audible, the
+            // decoder's track info is already the next track's
+            int wireDuration = m_wireDuration.load(std::memory_order_relaxed);
+            if (wireDuration >= 0 && m_direttaSync && m_direttaSync->wireMarkersEnabled()) {
+                duration = wireDuration;
+            }
 
             // Cap reported position to (duration - 1) while PLAYING.
             // Prevents control points from seeing RelTime >= TrackDuration
-            // due to decoded samples running ahead of DAC output by ~300ms.
+            // due to decoded samples running ahead of DAC output by ~300ms
+            // (no-op with wire markers, kept as a guard).
             if (duration > 0 && position >= duration) {
                 position = duration - 1;
             }
@@ -19,6 +19,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <iostream>
 
 // Forward declarations
@@ -26,6 +28,9 @@ class UPnPDevice;
 class AudioEngine;
 class DirettaSync;
 struct AudioFormat;
+struct DirettaConfig;
+class TrackCache;
+class HttpConnectionPool;
 
 class DirettaRenderer {
 public:
@@ -45,12 +50,20 @@ public:
         std::string transferMode;  // Transfer mode: auto|varmax|varauto|fixauto|random
         int mtu = -1;             // MTU override in bytes (default: auto-detect)
         int targetProfileLimitTime = -1;  // 0=SelfProfile (stable, default), >0=TargetProfile limit in µs (experimental)
+        std::string workerWait;    // Worker idle wait: sleep|abstime|timerfd (default: sleep)
+        bool convertOnPop = false; // Ring stores source PCM, conversion in getNewStream()
+        bool constantWorkConsumer = false;  // Identical callback work for audio and silence
+        bool bitPerfectVerify = false;  // Bit-perfect verification tap (diagnostic)
+        bool wireMarkers = false;  // Track change/position follow the wire, not the decoder
+        std::string tapDumpPath;   // Raw output dump file for the tap (empty = none)
+        std::string targetCachePath;  // Cached target/MTU file (empty = discover every start)
 
         // CPU affinity (empty = no pinning, default)
         // Accept one or more cores (comma-separated), e.g. "6" or "6,7,8"
         std::string cpuAudio;     // Cores for DirettaSync worker thread (critical hot path)
         std::string cpuDecode;    // Cores for DirettaRenderer audio thread (decode)
         std::string cpuOther;     // Cores for other threads (UPnP, position)
+        std::string cpuDemux;     // Cores for the demux thread (empty = cpuOther)
 
         // Buffer configuration (-1 = use defaults)
         float pcmBufferSeconds = -1.0f;        // Default 0.5s
@@ -59,6 +72,19 @@ public:
         int pcmPrefillMs = -1;                 // Default 80ms
         int pcmRemotePrefillMs = -1;           // Default 150ms
         int dsdPrefillMs = -1;                 // Default 200ms
+        int httpBufferMB = 0;                  // HTTP read-ahead ring per decoder (0 = off)
+        std::string trackCacheDir;             // On-disk track cache (empty = off)
+        int trackCacheMB = 2048;               // Track cache size cap
+        int httpPoolPerHost = 0;               // Keep-alive connections per media server (0 = off)
+        int httpConnections = 1;               // Concurrent range requests per track (1 = single stream)
+        bool probeCache = false;               // Reuse probed stream parameters on reopen
+        bool ioUring = false;                  // io_uring read-ahead for local files
+        bool mmapFiles = false;                // mmap local files (over io_uring)
+        int memoryPlayMB = 0;                  // RAM for current + next track (0 = off)
+        int decodeAheadMB = 0;                 // Decoded-PCM FIFO per track (0 = decode on audio thread)
+        int prerollMs = 0;                     // Decoded at next-track preload (0 = open only)
+        int dstThreads = 0;                    // DST frame decode workers (0 = auto)
+        int demuxPackets = 0;                  // Demux thread packet queue (0 = demux on the decode thread)
 
         Config();
     };
@@ -71,23 +97,46 @@ public:
 
     bool isRunning() const { return m_running; }
 
+    /** @brief True if the background Diretta startup failed (renderer stopped itself) */
+    bool startupFailed() const { return m_startupFailed.load(std::memory_order_acquire); }
+
     /** @brief Dump runtime statistics (called by SIGUSR1 handler) */
     void dumpStats() const;
 
 private:
+    // AudioEngine output: DirettaSync, configured once per format (DirettaRenderer.cpp)
+    class OutputSink;
+
     // Thread functions
     void audioThreadFunc();
     void upnpThreadFunc();
     void positionThreadFunc();
 
+    // Diretta enable + warmup, run concurrently with UPnP bring-up
+    void direttaStartupFunc(const DirettaConfig& syncConfig, bool retry);
+    // Run a UPnP action now, or queue it until Diretta startup has finished
+    void runWhenDirettaReady(const char* name, std::function<void()> action);
+
     // Helper to wait for audio callback completion
     void waitForCallbackComplete();
 
+    // Wire markers: attach track/position to the audio about to be sent (audio thread)
+    void markWire(uint32_t sampleRate);
+    // Send the deferred track change whose first byte just reached the SDK
+    void releaseTrackChange(uint32_t seq);
+    // Position in seconds: wire position when available, else decoded position
+    double currentPosition() const;
+    // Forget the wire position until a new marker reaches the SDK
+    void resetWirePosition();
+
     // Configuration
     Config m_config;
 
     // Components
+    std::unique_ptr<TrackCache> m_trackCache;  // Declared first: outlives the decoders
+    std::unique_ptr<HttpConnectionPool> m_httpPool;  // Likewise
     std::unique_ptr<UPnPDevice> m_upnp;
+    std::unique_ptr<OutputSink> m_outputSink;  // Declared before the engine that writes to it
     std::unique_ptr<AudioEngine> m_audioEngine;
     std::unique_ptr<DirettaSync> m_direttaSync;
 
@@ -95,11 +144,18 @@ private:
     std::thread m_audioThread;
     std::thread m_upnpThread;
     std::thread m_positionThread;
+    std::thread m_direttaStartThread;
 
     // State
     std::atomic<bool> m_running{false};
     std::mutex m_mutex;
 
+    // Startup: UPnP actions received before Diretta is ready, replayed in order
+    std::mutex m_startupMutex;
+    std::deque<std::function<void()>> m_startupQueue;  // Protected by m_startupMutex
+    std::atomic<bool> m_direttaReady{false};
+    std::atomic<bool> m_startupFailed{false};
+
     // Current track info
     std::string m_currentURI;
     std::string m_currentMetadata;
@@ -108,6 +164,21 @@ private:
     std::atomic<bool> m_callbackRunning{false};
     std::atomic<bool> m_shutdownRequested{false};
 
+    // Wire markers (DirettaConfig::wireMarkers)
+    struct PendingTrackChange {
+        uint32_t seq;
+        std::string uri;
+        std::string metadata;
+        int durationSec;
+    };
+    std::mutex m_wireMutex;
+    std::deque<PendingTrackChange> m_pendingTrackChanges;  // Protected by m_wireMutex
+    std::atomic<uint32_t> m_trackSeq{0};
+    uint32_t m_markedTrackSeq = 0;          // Audio thread only
+    uint64_t m_lastPositionMark = 0;        // Audio thread only
+    std::atomic<double> m_wirePosition{-1.0};  // Seconds, <0 = not known yet
+    std::atomic<int> m_wireDuration{-1};       // Duration of the audible track, <0 = not known
+
     // DAC stabilization timing
     std::chrono::steady_clock::time_point m_lastStopTime;
 
@@ -149,13 +149,16 @@ public:
     void resize(size_t newSize, uint8_t silenceByte) {
         size_ = roundUpPow2(newSize);
         mask_ = size_ - 1;
-        buffer_.resize(size_);
+        mirror_ = std::min(mirrorRequest_, size_);
+        buffer_.resize(size_ + mirror_);
         silenceByte_.store(silenceByte, std::memory_order_release);
         clear();  // Resets all S24 state - hint will be set by caller via setS24PackModeHint()
         fillWithSilence();
     }
 
     size_t size() const { return size_; }
+    /// Producer-side write offset (ring bytes written = delta & (size() - 1))
+    size_t writeCursor() const { return writePos_.load(std::memory_order_relaxed); }
     uint8_t silenceByte() const { return silenceByte_.load(std::memory_order_acquire); }
 
     size_t getAvailable() const {
@@ -186,12 +189,29 @@ public:
         m_s24DetectionConfirmed = false;
         m_deferredSampleCount = 0;
         m_dopMarkerState = false;  // Reset DoP marker to 0x05
+        clearCount_.fetch_add(1, std::memory_order_release);
     }
 
+    /**
+     * @brief Number of clear()/resize() calls - lets observers detect stream restarts
+     */
+    uint32_t clearCount() const { return clearCount_.load(std::memory_order_acquire); }
+
     void fillWithSilence() {
-        std::memset(buffer_.data(), silenceByte_.load(std::memory_order_relaxed), size_);
+        std::memset(buffer_.data(), silenceByte_.load(std::memory_order_relaxed), size_ + mirror_);
     }
 
+    /**
+     * @brief Mirror the first @p bytes of the ring past its end
+     *
+     * Any read of up to @p bytes starting anywhere in the ring is then one
+     * contiguous region (see popConstantWork()). Writes into the head of the
+     * ring are duplicated into the mirror. Takes effect at the next resize().
+     */
+    void setReadMirror(size_t bytes) { mirrorRequest_ = bytes; }
+    /// Mirror currently allocated (0 until a resize() after setReadMirror())
+    size_t readMirror() const { return mirror_; }
+
     const uint8_t* getStaging24BitPack() const { return m_staging24BitPack; }
     const uint8_t* getStaging16To32() const { return m_staging16To32; }
     const uint8_t* getStagingDSD() const { return m_stagingDSD; }
@@ -272,6 +292,7 @@ public:
     void commitDirectWrite(size_t written) {
         if (written == 0 || size_ == 0) return;
         size_t wp = writePos_.load(std::memory_order_relaxed);
+        syncMirror(wp, written);
         writePos_.store((wp + written) & mask_, std::memory_order_release);
     }
 
@@ -329,6 +350,7 @@ public:
         if (firstChunk < len) {
             memcpy_audio(buffer_.data(), data + firstChunk, len - firstChunk);
         }
+        syncMirror(wp, len);
 
         writePos_.store((wp + len) & mask_, std::memory_order_release);
         return len;
@@ -362,39 +384,8 @@ public:
 
         prefetch_audio_buffer(data, numSamples * 4);
 
-        // S24 mode selection - trust FFmpeg hint when available
-        // Only run sample detection when hint is Unknown (rare/exotic formats)
-        if (m_s24PackMode == S24PackMode::Unknown || m_s24PackMode == S24PackMode::Deferred) {
-            // No hint from FFmpeg - try sample-based detection
-            S24PackMode detected = detectS24PackMode(data, numSamples);
-            if (detected != S24PackMode::Deferred) {
-                // Sample detection found result - use it
-                m_s24PackMode = detected;
-                m_s24DetectionConfirmed = true;
-                m_deferredSampleCount = 0;
-            } else {
-                // Still silence - accumulate count for timeout
-                m_deferredSampleCount += numSamples;
-                // Timeout: if still silent after threshold, default to LSB (most common)
-                if (m_deferredSampleCount > DEFERRED_TIMEOUT_SAMPLES) {
-                    m_s24PackMode = S24PackMode::LsbAligned;
-                    m_s24DetectionConfirmed = true;
-                }
-            }
-        }
-        // When hint is set (LsbAligned/MsbAligned from FFmpeg), trust it completely
-
-        // Use effective mode for conversion (Deferred/Unknown use LSB as fallback)
-        S24PackMode effectiveMode = m_s24PackMode;
-        if (effectiveMode == S24PackMode::Deferred || effectiveMode == S24PackMode::Unknown) {
-            effectiveMode = S24PackMode::LsbAligned;  // Safe default for standard formats
-        }
-
-        // ARM64 fix: FFmpeg on ARM produces MSB-aligned S24 data (byte 0 = padding)
-        // while x86 FFmpeg produces LSB-aligned (byte 3 = padding)
-        #if defined(__aarch64__) || defined(_M_ARM64)
-        effectiveMode = S24PackMode::MsbAligned;  // Force MSB for ARM
-        #endif
+        updateS24Detection(data, numSamples);
+        S24PackMode effectiveMode = getEffectiveS24PackMode();
 
         size_t stagedBytes = (effectiveMode == S24PackMode::MsbAligned)
             ? convert24BitPackedShifted_AVX2(m_staging24BitPack, data, numSamples)
@@ -466,6 +457,11 @@ public:
      * Uses specialized conversion functions with no per-iteration branch checks.
      * Mode should be determined at track open and cached in DirettaSync.
      *
+     * Converts straight into the ring's free region (no staging buffer): up
+     * to the end of the ring, one 4-byte group set that straddles the wrap
+     * through a small temporary, then the rest at the ring start. If not all
+     * input fits, whole groups from the start of every plane are taken.
+     *
      * @param data Planar DSD data
      * @param inputSize Total input size in bytes
      * @param numChannels Number of audio channels
@@ -475,41 +471,39 @@ public:
     size_t pushDSDPlanarOptimized(const uint8_t* data, size_t inputSize,
                                    int numChannels, DSDConversionMode mode) {
         if (size_ == 0) return 0;
-        if (numChannels == 0) return 0;
-
-        size_t maxBytes = inputSize;
-        if (maxBytes > STAGING_SIZE) maxBytes = STAGING_SIZE;
-        size_t free = getFreeSpace();
-        if (maxBytes > free) maxBytes = free;
+        if (numChannels <= 0 || numChannels > MAX_DSD_CHANNELS) return 0;
 
-        size_t bytesPerChannel = maxBytes / static_cast<size_t>(numChannels);
-        size_t completeGroups = bytesPerChannel / 4;
-        size_t usableInput = completeGroups * 4 * static_cast<size_t>(numChannels);
-        if (usableInput == 0) return 0;
+        const size_t channels = static_cast<size_t>(numChannels);
+        const size_t planeStride = inputSize / channels;
+        const size_t groupBytes = 4 * channels;    // One 4-byte group per channel
+        size_t groups = std::min(planeStride / 4, getFreeSpace() / groupBytes);
+        if (groups == 0) return 0;
+        size_t len = groups * groupBytes;
 
-        prefetch_audio_buffer(data, usableInput);
+        prefetch_audio_buffer(data, planeStride * channels);
 
-        size_t stagedBytes;
-        switch (mode) {
-            case DSDConversionMode::Passthrough:
-                stagedBytes = convertDSD_Passthrough(m_stagingDSD, data, usableInput, numChannels);
-                break;
-            case DSDConversionMode::BitReverseOnly:
-                stagedBytes = convertDSD_BitReverse(m_stagingDSD, data, usableInput, numChannels);
-                break;
-            case DSDConversionMode::ByteSwapOnly:
-                stagedBytes = convertDSD_ByteSwap(m_stagingDSD, data, usableInput, numChannels);
-                break;
-            case DSDConversionMode::BitReverseAndSwap:
-                stagedBytes = convertDSD_BitReverseSwap(m_stagingDSD, data, usableInput, numChannels);
-                break;
-            default:
-                // Fallback to passthrough if unknown mode
-                stagedBytes = convertDSD_Passthrough(m_stagingDSD, data, usableInput, numChannels);
-                break;
+        uint8_t* ring = buffer_.data();
+        size_t wp = writePos_.load(std::memory_order_relaxed);
+        size_t headGroups = std::min(groups, (size_ - wp) / groupBytes);
+        convertDSDGroups(ring + wp, data, headGroups, numChannels, planeStride, mode);
+
+        if (headGroups < groups) {
+            size_t g = headGroups;
+            size_t tail = size_ - wp - g * groupBytes;  // < groupBytes
+            size_t out = 0;
+            if (tail > 0) {
+                uint8_t straddle[4 * MAX_DSD_CHANNELS];
+                convertDSDGroups(straddle, data + 4 * g, 1, numChannels, planeStride, mode);
+                std::memcpy(ring + wp + g * groupBytes, straddle, tail);
+                std::memcpy(ring, straddle + tail, groupBytes - tail);
+                out = groupBytes - tail;
+                g++;
+            }
+            convertDSDGroups(ring + out, data + 4 * g, groups - g, numChannels, planeStride, mode);
         }
-
-        return writeToRing(m_stagingDSD, stagedBytes);
+        syncMirror(wp, len);
+        writePos_.store((wp + len) & mask_, std::memory_order_release);
+        return len;
     }
 
     /**
@@ -909,6 +903,8 @@ public:
     //=========================================================================
     // Specialized DSD conversion functions - no per-iteration branch checks
     // Mode is determined at track open, eliminating runtime conditionals
+    // planeStride: distance between channel planes in src (0 = contiguous
+    // planes of totalInputBytes / numChannels), to convert part of a buffer
     //=========================================================================
 
     /**
@@ -917,14 +913,16 @@ public:
      * NO bit reversal, NO byte swap
      */
     size_t convertDSD_Passthrough(uint8_t* dst, const uint8_t* src,
-                                   size_t totalInputBytes, int numChannels) {
+                                   size_t totalInputBytes, int numChannels,
+                                   size_t planeStride = 0) {
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = planeStride ? planeStride : bytesPerChannel;  // Input plane spacing
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 32 <= bytesPerChannel; i += 32) {
@@ -964,7 +962,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -999,7 +997,7 @@ public:
         // Scalar fallback for non-SIMD or non-stereo
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = src[chOffset + i + 0];
                 dst[outputBytes++] = src[chOffset + i + 1];
                 dst[outputBytes++] = src[chOffset + i + 2];
@@ -1014,14 +1012,16 @@ public:
      * Used for DSF→MSB or DFF→LSB target conversions
      */
     size_t convertDSD_BitReverse(uint8_t* dst, const uint8_t* src,
-                                  size_t totalInputBytes, int numChannels) {
+                                  size_t totalInputBytes, int numChannels,
+                                  size_t planeStride = 0) {
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = planeStride ? planeStride : bytesPerChannel;  // Input plane spacing
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 32 <= bytesPerChannel; i += 32) {
@@ -1064,7 +1064,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -1103,7 +1103,7 @@ public:
         // Scalar fallback with bit reversal (using class-scope LUT)
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 0]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 1]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 2]];
@@ -1118,14 +1118,16 @@ public:
      * Used for endianness conversion
      */
     size_t convertDSD_ByteSwap(uint8_t* dst, const uint8_t* src,
-                                size_t totalInputBytes, int numChannels) {
+                                size_t totalInputBytes, int numChannels,
+                                size_t planeStride = 0) {
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = planeStride ? planeStride : bytesPerChannel;  // Input plane spacing
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             static const __m256i byteswap_mask = _mm256_setr_epi8(
                 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
@@ -1173,7 +1175,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -1212,7 +1214,7 @@ public:
         // Scalar fallback with byte swap
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = src[chOffset + i + 3];
                 dst[outputBytes++] = src[chOffset + i + 2];
                 dst[outputBytes++] = src[chOffset + i + 1];
@@ -1227,14 +1229,16 @@ public:
      * Used when both bit reversal and endianness conversion are needed
      */
     size_t convertDSD_BitReverseSwap(uint8_t* dst, const uint8_t* src,
-                                      size_t totalInputBytes, int numChannels) {
+                                      size_t totalInputBytes, int numChannels,
+                                      size_t planeStride = 0) {
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = planeStride ? planeStride : bytesPerChannel;  // Input plane spacing
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             static const __m256i byteswap_mask = _mm256_setr_epi8(
                 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
@@ -1284,7 +1288,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -1327,7 +1331,7 @@ public:
         // Scalar fallback with bit reversal + byte swap (using class-scope LUT)
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 3]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 2]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 1]];
@@ -1337,6 +1341,131 @@ public:
         return outputBytes;
     }
 
+    //=========================================================================
+    // Convert-on-pop mode (ring holds source-format samples)
+    //=========================================================================
+
+    // Conversion applied by popConverted() - source sample -> wire sample
+    enum class PopConversion {
+        None,       // Ring already holds wire format
+        Pack24,     // S24_P32 (4 bytes) -> packed 24-bit (3 bytes)
+        Pad16To32,  // 16-bit (2 bytes) -> 32-bit (4 bytes)
+        Pad16To24   // 16-bit (2 bytes) -> 24-bit (3 bytes)
+    };
+
+    static constexpr size_t popSourceBytes(PopConversion conv) {
+        return conv == PopConversion::Pack24 ? 4 : 2;
+    }
+
+    static constexpr size_t popWireBytes(PopConversion conv) {
+        return conv == PopConversion::Pad16To32 ? 4 : 3;
+    }
+
+    /**
+     * @brief Push whole source frames unconverted
+     * @param frameBytes Source bytes per frame (keeps the ring sample-aligned)
+     * @return Input bytes consumed
+     */
+    size_t pushSamples(const uint8_t* data, size_t inputSize, size_t frameBytes) {
+        if (size_ == 0 || frameBytes == 0) return 0;
+        size_t len = std::min(inputSize, getFreeSpace());
+        len -= len % frameBytes;
+        return push(data, len);
+    }
+
+    /**
+     * @brief Push S24_P32 source samples unconverted
+     *
+     * Runs the same alignment detection as push24BitPacked() and publishes
+     * the result for popConverted(). A mode change (Deferred -> detected)
+     * applies to samples still in the ring, which were silence.
+     */
+    size_t pushS24Source(const uint8_t* data, size_t inputSize, size_t frameBytes) {
+        if (size_ == 0 || frameBytes == 0) return 0;
+        size_t len = std::min(inputSize, getFreeSpace());
+        size_t numSamples = (len - len % frameBytes) / 4;
+        if (numSamples == 0) return 0;
+
+        updateS24Detection(data, numSamples);
+        m_popS24Msb.store(getEffectiveS24PackMode() == S24PackMode::MsbAligned,
+                          std::memory_order_release);
+        return push(data, numSamples * 4);
+    }
+
+    /**
+     * @brief Pop and convert to wire format in one pass (consumer side)
+     *
+     * Converts straight out of ring memory with the same SIMD kernels as the
+     * push path. Ring size is a power of two and every push is sample-aligned,
+     * so a sample never straddles the wrap point.
+     *
+     * @param outputBytes Wire bytes wanted (whole wire samples)
+     * @return Wire bytes written to dest
+     */
+    size_t popConverted(uint8_t* dest, size_t outputBytes, PopConversion conv) {
+        if (conv == PopConversion::None) return pop(dest, outputBytes);
+        if (size_ == 0) return 0;
+
+        size_t inBps = popSourceBytes(conv);
+        size_t outBps = popWireBytes(conv);
+        size_t samples = std::min(outputBytes / outBps, getAvailable() / inBps);
+        if (samples == 0) return 0;
+
+        size_t rp = readPos_.load(std::memory_order_acquire);
+        size_t firstSamples = std::min(samples, (size_ - rp) / inBps);
+
+        size_t out = convertFromRing(dest, buffer_.data() + rp, firstSamples, conv);
+        if (firstSamples < samples) {
+            out += convertFromRing(dest + out, buffer_.data(), samples - firstSamples, conv);
+        }
+
+        readPos_.store((rp + samples * inBps) & mask_, std::memory_order_release);
+        return out;
+    }
+
+    //=========================================================================
+    // Constant-work pop (requires setReadMirror() >= ring bytes per call)
+    //=========================================================================
+
+    /**
+     * @brief Serve one consumer buffer with identical work for audio and silence
+     *
+     * The source is either the (contiguous, mirrored) ring region at the read
+     * position or a caller-provided silence page of the same format; both go
+     * through the same copy/convert call with the same size. Only the read
+     * pointer update depends on @p fromRing.
+     *
+     * @param outputBytes Wire bytes to produce
+     * @param silence     Silence page (at least the ring bytes for outputBytes)
+     * @param fromRing    true = consume audio, false = serve silence
+     * @return Wire bytes written to dest
+     */
+    size_t popConstantWork(uint8_t* dest, size_t outputBytes, const uint8_t* silence,
+                           bool fromRing, PopConversion conv = PopConversion::None) {
+        size_t inBytes = outputBytes;
+        if (conv != PopConversion::None) {
+            inBytes = outputBytes / popWireBytes(conv) * popSourceBytes(conv);
+        }
+
+        size_t rp = readPos_.load(std::memory_order_acquire);
+        const uint8_t* sources[2] = { silence, buffer_.data() + rp };
+        const uint8_t* src = sources[fromRing];
+
+        size_t out;
+        if (conv == PopConversion::None) {
+            memcpy_audio_fixed(dest, src, outputBytes);
+            out = outputBytes;
+        } else {
+            out = convertFromRing(dest, src, inBytes / popSourceBytes(conv), conv);
+        }
+
+        // Never store readPos for silence: clear() may be resetting it concurrently
+        if (fromRing) {
+            readPos_.store((rp + inBytes) & mask_, std::memory_order_release);
+        }
+        return out;
+    }
+
     //=========================================================================
     // Pop method (read from buffer)
     //=========================================================================
@@ -1366,12 +1495,52 @@ public:
     const uint8_t* data() const { return buffer_.data(); }
 
 private:
+    size_t convertFromRing(uint8_t* dst, const uint8_t* src, size_t numSamples, PopConversion conv) {
+        switch (conv) {
+            case PopConversion::Pack24:
+                return m_popS24Msb.load(std::memory_order_acquire)
+                    ? convert24BitPackedShifted_AVX2(dst, src, numSamples)
+                    : convert24BitPacked_AVX2(dst, src, numSamples);
+            case PopConversion::Pad16To32:
+                return convert16To32_AVX2(dst, src, numSamples);
+            case PopConversion::Pad16To24:
+                return convert16To24(dst, src, numSamples);
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * Convert @p groups 4-byte groups per channel from planes @p planeStride
+     * apart, starting at @p src, into @p dst in the target's DSD layout
+     */
+    void convertDSDGroups(uint8_t* dst, const uint8_t* src, size_t groups, int numChannels,
+                          size_t planeStride, DSDConversionMode mode) {
+        if (groups == 0) return;
+        size_t bytes = groups * 4 * static_cast<size_t>(numChannels);
+        switch (mode) {
+            case DSDConversionMode::BitReverseOnly:
+                convertDSD_BitReverse(dst, src, bytes, numChannels, planeStride);
+                break;
+            case DSDConversionMode::ByteSwapOnly:
+                convertDSD_ByteSwap(dst, src, bytes, numChannels, planeStride);
+                break;
+            case DSDConversionMode::BitReverseAndSwap:
+                convertDSD_BitReverseSwap(dst, src, bytes, numChannels, planeStride);
+                break;
+            case DSDConversionMode::Passthrough:
+            default:
+                convertDSD_Passthrough(dst, src, bytes, numChannels, planeStride);
+                break;
+        }
+    }
+
     /**
      * Write staged data to ring buffer with efficient wraparound handling
      * Uses memcpy_audio_fixed for consistent timing
      */
     size_t writeToRing(const uint8_t* staged, size_t len) {
-        size_t size = buffer_.size();
+        size_t size = size_;
         if (size == 0 || len == 0) return 0;
 
         size_t writePos = writePos_.load(std::memory_order_relaxed);
@@ -1397,6 +1566,7 @@ private:
         if (secondChunk > 0) {
             memcpy_audio_fixed(ring, staged + firstChunk, secondChunk);
         }
+        syncMirror(writePos, len);
 
         size_t newWritePos = (writePos + len) & mask_;
         writePos_.store(newWritePos, std::memory_order_release);
@@ -1404,6 +1574,21 @@ private:
         return len;
     }
 
+    /**
+     * Duplicate bytes written at [wp, wp + len) that land in the ring head
+     * into the read mirror past the end of the ring
+     */
+    void syncMirror(size_t wp, size_t len) {
+        if (mirror_ == 0) return;
+        uint8_t* ring = buffer_.data();
+        if (wp < mirror_) {
+            std::memcpy(ring + size_ + wp, ring + wp, std::min(len, mirror_ - wp));
+        }
+        if (wp + len > size_) {
+            std::memcpy(ring + size_, ring, std::min(wp + len - size_, mirror_));
+        }
+    }
+
 #if DIRETTA_HAS_AVX2
     static __m256i simd_bit_reverse(__m256i x) {
         static const __m256i nibble_reverse = _mm256_setr_epi8(
@@ -1460,6 +1645,7 @@ private:
     }
 
     static constexpr size_t STAGING_SIZE = 65536;
+    static constexpr int MAX_DSD_CHANNELS = 16;   // Bounds the wrap-straddling group
     alignas(64) uint8_t m_staging24BitPack[STAGING_SIZE];
     alignas(64) uint8_t m_staging16To32[STAGING_SIZE];
     alignas(64) uint8_t m_stagingDSD[STAGING_SIZE];
@@ -1469,9 +1655,13 @@ private:
     std::vector<uint8_t, AlignedAllocator<uint8_t, kRingAlignment>> buffer_;
     size_t size_ = 0;
     size_t mask_ = 0;
+    size_t mirror_ = 0;     // Read mirror bytes past size_ (constant-work mode)
+    size_t mirrorRequest_ = 0;
     alignas(64) std::atomic<size_t> writePos_{0};
     alignas(64) std::atomic<size_t> readPos_{0};
     std::atomic<uint8_t> silenceByte_{0};
+    std::atomic<uint32_t> clearCount_{0};
+    std::atomic<bool> m_popS24Msb{false};  // Convert-on-pop: S24 alignment for popConverted()
 
 public:
     // S24 pack mode detection - determines byte alignment of 24-bit samples in 32-bit containers
@@ -1498,7 +1688,52 @@ public:
     S24PackMode getS24PackMode() const { return m_s24PackMode; }
     S24PackMode getS24Hint() const { return m_s24Hint; }
 
+    /**
+     * @brief Alignment push24BitPacked() actually packs with (never Unknown/Deferred)
+     */
+    S24PackMode getEffectiveS24PackMode() const {
+        // Deferred/Unknown use LSB as fallback (safe default for standard formats)
+        S24PackMode effectiveMode = m_s24PackMode;
+        if (effectiveMode == S24PackMode::Deferred || effectiveMode == S24PackMode::Unknown) {
+            effectiveMode = S24PackMode::LsbAligned;
+        }
+
+        // ARM64 fix: FFmpeg on ARM produces MSB-aligned S24 data (byte 0 = padding)
+        // while x86 FFmpeg produces LSB-aligned (byte 3 = padding)
+        #if defined(__aarch64__) || defined(_M_ARM64)
+        effectiveMode = S24PackMode::MsbAligned;  // Force MSB for ARM
+        #endif
+        return effectiveMode;
+    }
+
 private:
+    /**
+     * @brief S24 mode selection - trust FFmpeg hint when available
+     *
+     * Only runs sample detection when hint is Unknown (rare/exotic formats).
+     */
+    void updateS24Detection(const uint8_t* data, size_t numSamples) {
+        if (m_s24PackMode == S24PackMode::Unknown || m_s24PackMode == S24PackMode::Deferred) {
+            // No hint from FFmpeg - try sample-based detection
+            S24PackMode detected = detectS24PackMode(data, numSamples);
+            if (detected != S24PackMode::Deferred) {
+                // Sample detection found result - use it
+                m_s24PackMode = detected;
+                m_s24DetectionConfirmed = true;
+                m_deferredSampleCount = 0;
+            } else {
+                // Still silence - accumulate count for timeout
+                m_deferredSampleCount += numSamples;
+                // Timeout: if still silent after threshold, default to LSB (most common)
+                if (m_deferredSampleCount > DEFERRED_TIMEOUT_SAMPLES) {
+                    m_s24PackMode = S24PackMode::LsbAligned;
+                    m_s24DetectionConfirmed = true;
+                }
+            }
+        }
+        // When hint is set (LsbAligned/MsbAligned from FFmpeg), trust it completely
+    }
+
     /**
      * Detect S24 pack mode by examining sample data
      *
@@ -17,6 +17,11 @@
 #include <sched.h>
 #include <vector>
 #include <sstream>
+#include <cerrno>
+#include <ctime>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
 
 namespace {
 
@@ -77,6 +82,34 @@ bool setRealtimePriority(int priority = 50) {
     return true;
 }
 
+// CLOCK_MONOTONIC in nanoseconds (same clock as clock_nanosleep/timerfd below)
+int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+struct timespec nsToTimespec(int64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+    return ts;
+}
+
+// Next point on the grid anchor + k*period strictly after now
+int64_t nextGridPoint(int64_t anchor, int64_t period, int64_t now) {
+    return anchor + ((now - anchor) / period + 1) * period;
+}
+
+const char* workerWaitName(DirettaWorkerWait mode) {
+    switch (mode) {
+        case DirettaWorkerWait::ABSTIME: return "abstime";
+        case DirettaWorkerWait::TIMERFD: return "timerfd";
+        case DirettaWorkerWait::SLEEP:
+        default: return "sleep";
+    }
+}
+
 class RingAccessGuard {
 public:
     RingAccessGuard(std::atomic<int>& users, const std::atomic<bool>& reconfiguring)
@@ -108,6 +141,32 @@ private:
     std::atomic<int>& users_;
     bool active_;
 };
+
+// Records getNewStream() execution time on every exit path (single writer)
+class CallbackTimer {
+public:
+    CallbackTimer(int64_t entryNs, std::atomic<uint64_t>& count, std::atomic<int64_t>& sumNs,
+                  std::atomic<double>& sumSqNs, std::atomic<int64_t>& maxNs)
+        : entryNs_(entryNs), count_(count), sumNs_(sumNs), sumSqNs_(sumSqNs), maxNs_(maxNs) {}
+
+    ~CallbackTimer() {
+        int64_t ns = monotonicNs() - entryNs_;
+        count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sumNs_.store(sumNs_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        double d = static_cast<double>(ns);
+        sumSqNs_.store(sumSqNs_.load(std::memory_order_relaxed) + d * d, std::memory_order_relaxed);
+        if (ns > maxNs_.load(std::memory_order_relaxed)) {
+            maxNs_.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    int64_t entryNs_;
+    std::atomic<uint64_t>& count_;
+    std::atomic<int64_t>& sumNs_;
+    std::atomic<double>& sumSqNs_;
+    std::atomic<int64_t>& maxNs_;
+};
 } // namespace
 
 //=============================================================================
@@ -138,13 +197,38 @@ bool DirettaSync::enable(const DirettaConfig& config,
     m_config = config;
     DIRETTA_LOG("Enabling...");
 
-    if (!discoverTarget(stopSignal)) {
-        DIRETTA_LOG("Failed to discover target");
-        return false;
-    }
+    // Read mirror is allocated by the next ring resize (open/format change)
+    m_ringBuffer.setReadMirror(m_config.constantWorkConsumer ? DirettaBuffer::CONSTANT_WORK_MIRROR_BYTES : 0);
+
+    // Cached target: one discovery pass instead of the retry loop, cached MTU
+    // instead of measureMTU() (explicit --mtu still wins; a cache without a
+    // measured MTU measures again)
+    TargetCache cache;
+    bool cached = !m_config.targetCachePath.empty() &&
+                  cache.load(m_config.targetCachePath) &&
+                  cache.targetIndex == m_targetIndex &&
+                  findCachedTarget(cache);
+
+    if (cached) {
+        m_measuredMTU = cache.mtu;
+        if (m_mtuOverride > 0 || m_config.mtu > 0) {
+            measureMTU();
+        } else if (cache.mtu > 0) {
+            m_effectiveMTU = cache.mtu;
+        } else if (!measureMTU()) {
+            DIRETTA_LOG("No measured MTU cached and measurement failed, using fallback");
+        }
+        std::cout << "[DirettaSync] Using cached target " << cache.targetName
+                  << " (" << cache.address << "), MTU=" << m_effectiveMTU << std::endl;
+    } else {
+        if (!discoverTarget(stopSignal)) {
+            DIRETTA_LOG("Failed to discover target");
+            return false;
+        }
 
-    if (!measureMTU()) {
-        DIRETTA_LOG("MTU measurement failed, using fallback");
+        if (!measureMTU()) {
+            DIRETTA_LOG("MTU measurement failed, using fallback");
+        }
     }
 
     m_calculator = std::make_unique<DirettaCycleCalculator>(m_effectiveMTU);
@@ -156,6 +240,35 @@ bool DirettaSync::enable(const DirettaConfig& config,
 
     m_enabled = true;
     std::cout << "[DirettaSync] Enabled, MTU=" << m_effectiveMTU << std::endl;
+    saveTargetCache();
+
+    if (m_config.bitPerfectVerify || !m_config.tapDumpPath.empty()) {
+        auto report = [](const BitPerfectTap::TrackReport& r) {
+            if (r.blocksMismatched == 0 && r.formatErrors == 0) {
+                LOG_INFO("[BitPerfect] Track " << r.track << ": BIT-PERFECT ("
+                         << r.blocksVerified << " blocks verified"
+                         << (r.blocksUnverified ? ", " + std::to_string(r.blocksUnverified) + " unverified" : "")
+                         << ")");
+            } else {
+                LOG_WARN("[BitPerfect] Track " << r.track << ": MISMATCH "
+                         << r.blocksMismatched << "/" << (r.blocksVerified + r.blocksMismatched)
+                         << " blocks, first at byte " << r.firstMismatchByte
+                         << ", format errors " << r.formatErrors);
+            }
+        };
+        if (!m_tap.start(m_config.tapDumpPath, report)) {
+            LOG_WARN("[DirettaSync] Cannot open tap dump file: " << m_config.tapDumpPath);
+        } else {
+            std::cout << "[DirettaSync] Bit-perfect verification tap enabled"
+                      << (m_config.tapDumpPath.empty() ? "" : " (dump: " + m_config.tapDumpPath + ")")
+                      << std::endl;
+        }
+    }
+
+    if (m_config.wireMarkers) {
+        m_wireMarkers.start(m_wireMarkerHandler);
+        std::cout << "[DirettaSync] Wire markers enabled (track/position at SDK handoff)" << std::endl;
+    }
     return true;
 }
 
@@ -178,6 +291,8 @@ void DirettaSync::disable() {
         DIRETTA::Sync::close();
         m_sdkOpen = false;
         m_calculator.reset();
+        m_tap.stop();
+        m_wireMarkers.stop();
         m_enabled = false;
     }
 
@@ -279,20 +394,18 @@ bool DirettaSync::discoverTarget(std::atomic<bool>* stopSignal) {
             }
             DIRETTA_LOG("Found " << results.size() << " target(s)");
 
+            auto it = results.begin();
             if (results.size() == 1 || m_targetIndex == 0) {
-                auto it = results.begin();
-                m_targetAddress = it->first;
                 DIRETTA_LOG("Selected: " << it->second.targetName);
             } else if (m_targetIndex > 0 && m_targetIndex < static_cast<int>(results.size())) {
-                auto it = results.begin();
                 std::advance(it, m_targetIndex);
-                m_targetAddress = it->first;
                 DIRETTA_LOG("Selected target #" << (m_targetIndex + 1));
             } else {
-                auto it = results.begin();
-                m_targetAddress = it->first;
                 DIRETTA_LOG("Selected first target: " << it->second.targetName);
             }
+            m_targetAddress = it->first;
+            m_targetName = it->second.targetName;
+            m_targetOutputName = it->second.outputName;
             return true;
         }
 
@@ -355,6 +468,7 @@ bool DirettaSync::measureMTU() {
 
     if (ok && measuredMTU > 0) {
         m_effectiveMTU = measuredMTU;
+        m_measuredMTU = measuredMTU;
         DIRETTA_LOG("Measured MTU=" << m_effectiveMTU);
         return true;
     }
@@ -364,6 +478,61 @@ bool DirettaSync::measureMTU() {
     return false;
 }
 
+bool DirettaSync::findCachedTarget(const TargetCache& cache) {
+    DIRETTA::Find::Setting findSettings;
+    findSettings.Loopback = false;
+    findSettings.ProductID = 0;
+    findSettings.Name = "DirettaRenderer";
+    findSettings.MyID = 0x44525400;
+
+    DIRETTA::Find find(findSettings);
+    if (!find.open()) return false;
+
+    DIRETTA::Find::PortResalts results;
+    bool found = find.findOutput(results) && !results.empty();
+    find.close();
+    if (!found) {
+        DIRETTA_LOG("Cached target " << cache.address << " not found, running discovery");
+        return false;
+    }
+
+    for (const auto& target : results) {
+        // Same address and same output port (multiport targets list one entry per output)
+        if (target.first.get_str() == cache.address &&
+            target.second.outputName == cache.outputName) {
+            m_targetAddress = target.first;
+            m_targetName = target.second.targetName;
+            m_targetOutputName = target.second.outputName;
+            return true;
+        }
+    }
+    DIRETTA_LOG("Cached target " << cache.address << " not in discovery results");
+    return false;
+}
+
+void DirettaSync::saveTargetCache() {
+    if (m_config.targetCachePath.empty()) return;
+
+    TargetCache cache;
+    cache.address = m_targetAddress.get_str();
+    cache.targetName = m_targetName;
+    cache.outputName = m_targetOutputName;
+    cache.targetIndex = m_targetIndex;
+    // Only a measured MTU is persisted; --mtu, config and fallback values are
+    // not, so a later start without them still measures the link
+    cache.mtu = m_measuredMTU;
+    const auto& info = getSinkInfo();
+    cache.supportPCM = info.checkSinkSupportPCM();
+    cache.supportDSD = info.checkSinkSupportDSD();
+    cache.supportDSDlsb = info.checkSinkSupportDSDlsb();
+    cache.supportDSDmsb = info.checkSinkSupportDSDmsb();
+    cache.msModes = info.supportMSmode;
+
+    if (!cache.save(m_config.targetCachePath)) {
+        LOG_WARN("[DirettaSync] Cannot write target cache: " << m_config.targetCachePath);
+    }
+}
+
 bool DirettaSync::verifyTargetAvailable() {
     DIRETTA::Find::Setting findSettings;
     findSettings.Loopback = false;
@@ -766,6 +935,7 @@ bool DirettaSync::open(const AudioFormat& format) {
 
     unsigned int cycleTimeUs = calculateCycleTime(effectiveSampleRate, effectiveChannels, bitsPerSample);
     ACQUA::Clock cycleTime = ACQUA::Clock::MicroSeconds(cycleTimeUs);
+    m_cycleTimeUs.store(cycleTimeUs, std::memory_order_relaxed);  // Worker wake grid
 
     // Initial delay - Target needs time to prepare for new format
     // Longer delay for first open/reconnect, shorter for reconfigure
@@ -1216,12 +1386,24 @@ void DirettaSync::configureRingPCM(int rate, int channels, int direttaBps, int i
     m_isLowBitrate.store(direttaBps <= 2 && rate <= 48000, std::memory_order_release);
     m_dsdConversionMode.store(DirettaRingBuffer::DSDConversionMode::Passthrough, std::memory_order_release);
 
+    // Convert-on-pop: keep source samples in the ring (16->32 halves its footprint)
+    using PopConversion = DirettaRingBuffer::PopConversion;
+    PopConversion popConversion = PopConversion::None;
+    if (m_config.convertOnPop && !isDoPMode) {
+        if (direttaBps == 3 && inputBps == 4) popConversion = PopConversion::Pack24;
+        else if (direttaBps == 4 && inputBps == 2) popConversion = PopConversion::Pad16To32;
+        else if (direttaBps == 3 && inputBps == 2) popConversion = PopConversion::Pad16To24;
+    }
+    m_popConversion.store(popConversion, std::memory_order_release);
+
     // Increment format generation to invalidate cached values in sendAudio
     m_formatGeneration.fetch_add(1, std::memory_order_release);
     // C1: Also increment consumer generation for getNewStream
     m_consumerStateGen.fetch_add(1, std::memory_order_release);
 
-    size_t bytesPerSecond = static_cast<size_t>(rate) * channels * direttaBps;
+    // Ring size and prefill are in ring bytes: source format when converting on pop
+    int ringBps = (popConversion != PopConversion::None) ? inputBps : direttaBps;
+    size_t bytesPerSecond = static_cast<size_t>(rate) * channels * ringBps;
     bool remoteStream = m_isRemoteStream.load(std::memory_order_acquire);
     float bufferSeconds;
     // Use config override if provided, else default
@@ -1237,45 +1419,21 @@ void DirettaSync::configureRingPCM(int rate, int channels, int direttaBps, int i
     m_ringBuffer.resize(ringSize, 0x00);
     ringSize = m_ringBuffer.size();
 
-    int bytesPerFrame = channels * direttaBps;
-
-    // Calculate bytesPerBuffer to match DirettaCycleCalculator
-    // The cycle time is calculated as: cycleTimeUs = (efficientMTU / bytesPerSecond) * 1000000
-    // SDK's m_effectiveMTU already accounts for IP/UDP headers, only Diretta overhead (~3 bytes)
-    // Tested by Hoorna: OVERHEAD=3 works at MTU 1500
-    constexpr int OVERHEAD = 3;
-    int efficientMTU = static_cast<int>(m_effectiveMTU) - OVERHEAD;
-    if (efficientMTU < 64) efficientMTU = 1497;  // Fallback (1500 - 3)
-
-    // Align to frame boundary for clean audio
-    int framesPerBuffer = efficientMTU / bytesPerFrame;
-    int bytesPerBuffer = framesPerBuffer * bytesPerFrame;
-
-    // For low sample rates (<=96kHz), 1ms worth of data fits in MTU, use that instead
-    // This gives better timing resolution and matches original behavior
-    int bytesPerMs = (rate / 1000) * bytesPerFrame;
-    if (bytesPerMs <= efficientMTU) {
-        // Low sample rate: use 1ms buffers with drift correction for 44.1kHz family
-        int framesBase = rate / 1000;
-        int framesRemainder = rate % 1000;
-        bytesPerBuffer = framesBase * bytesPerFrame;
-
-        m_bytesPerFrame.store(bytesPerFrame, std::memory_order_release);
-        m_framesPerBufferRemainder.store(static_cast<uint32_t>(framesRemainder), std::memory_order_release);
-        m_framesPerBufferAccumulator.store(0, std::memory_order_release);
-        m_bytesPerBuffer.store(bytesPerBuffer, std::memory_order_release);
+    // Buffer layout from the format table (1ms buffers with drift correction for
+    // low rates, frame-aligned MTU-sized buffers above; matches DirettaCycleCalculator)
+    const DirettaFormat::Layout layout = DirettaFormat::pcm(
+        static_cast<uint32_t>(rate), channels, direttaBps, isDoPMode, m_effectiveMTU);
+    int bytesPerBuffer = layout.bytesPerBuffer;
 
-        DIRETTA_LOG("PCM buffer (1ms): " << bytesPerBuffer << " bytes (" << framesBase << " frames)");
-    } else {
-        // High sample rate: use MTU-sized buffers, no drift correction needed
-        // Cycle time and buffer size are matched via DirettaCycleCalculator
-        m_bytesPerFrame.store(bytesPerFrame, std::memory_order_release);
-        m_framesPerBufferRemainder.store(0, std::memory_order_release);
-        m_framesPerBufferAccumulator.store(0, std::memory_order_release);
-        m_bytesPerBuffer.store(bytesPerBuffer, std::memory_order_release);
+    m_bytesPerFrame.store(layout.bytesPerFrame, std::memory_order_release);
+    m_framesPerBufferRemainder.store(layout.framesRemainder, std::memory_order_release);
+    m_framesPerBufferAccumulator.store(0, std::memory_order_release);
+    m_bytesPerBuffer.store(bytesPerBuffer, std::memory_order_release);
+    m_stabilizationTarget.store(layout.stabilizationBuffers, std::memory_order_release);
+    m_firstConnectStabilizationTarget.store(layout.firstConnectStabilizationBuffers, std::memory_order_release);
 
-        DIRETTA_LOG("PCM buffer (MTU): " << bytesPerBuffer << " bytes (" << framesPerBuffer << " frames)");
-    }
+    DIRETTA_LOG("PCM buffer (" << (layout.oneMsBuffers ? "1ms" : "MTU") << "): " << bytesPerBuffer
+                << " bytes (" << (bytesPerBuffer / layout.bytesPerFrame) << " frames)");
 
     bool highRate = static_cast<uint32_t>(rate) > DirettaBuffer::HIGHRATE_THRESHOLD;
     // Use config override if provided, else default
@@ -1294,10 +1452,14 @@ void DirettaSync::configureRingPCM(int rate, int channels, int direttaBps, int i
             static_cast<uint32_t>(rate));
     }
     m_prefillTarget = std::min(m_prefillTarget, ringSize / (highRate ? 2 : 4));
+    m_seekPrefillTarget = std::min(m_prefillTarget, std::max(DirettaBuffer::MIN_PREFILL_BYTES,
+        bytesPerSecond * DirettaBuffer::SEEK_PREFILL_MS / 1000));
     m_prefillComplete = false;
+    m_seekRefill = false;
 
     DIRETTA_LOG("Ring PCM: " << rate << "Hz " << channels << "ch "
-                << direttaBps << "bps, buffer=" << ringSize
+                << direttaBps << "bps" << (popConversion != PopConversion::None ? " (convert-on-pop)" : "")
+                << ", buffer=" << ringSize
                 << ", bytesPerBuffer=" << bytesPerBuffer
                 << ", prefill=" << m_prefillTarget);
 }
@@ -1311,6 +1473,7 @@ void DirettaSync::configureRingDSD(uint32_t byteRate, int channels) {
     m_need24BitPack.store(false, std::memory_order_release);
     m_need16To32Upsample.store(false, std::memory_order_release);
     m_need16To24Upsample.store(false, std::memory_order_release);
+    m_popConversion.store(DirettaRingBuffer::PopConversion::None, std::memory_order_release);
     m_channels.store(channels, std::memory_order_release);
     m_sampleRate.store(static_cast<int>(byteRate * 8), std::memory_order_release);
     m_bytesPerSample.store(1, std::memory_order_release);
@@ -1332,31 +1495,17 @@ void DirettaSync::configureRingDSD(uint32_t byteRate, int channels) {
     m_ringBuffer.resize(ringSize, 0x69);  // DSD silence
     ringSize = m_ringBuffer.size();
 
-    // Calculate bytesPerBuffer to match DirettaCycleCalculator
-    // SDK's m_effectiveMTU already accounts for IP/UDP headers, only Diretta overhead (~3 bytes)
-    // Tested by Hoorna: OVERHEAD=3 works at MTU 1500
-    constexpr int OVERHEAD = 3;
-    int efficientMTU = static_cast<int>(m_effectiveMTU) - OVERHEAD;
-    if (efficientMTU < 64) efficientMTU = 1497;  // Fallback (1500 - 3)
-
-    size_t blockSize = 4 * channels;
-    size_t bytesPerBuffer = (efficientMTU / blockSize) * blockSize;
-    if (bytesPerBuffer < 64) bytesPerBuffer = 64;
-
-    // For low DSD rates where 1ms fits in MTU, use 1ms buffers
-    uint32_t inputBytesPerMs = (byteRate / 1000) * channels;
-    size_t bytesPerMsAligned = ((inputBytesPerMs + blockSize - 1) / blockSize) * blockSize;
-    if (bytesPerMsAligned <= static_cast<size_t>(efficientMTU)) {
-        bytesPerBuffer = bytesPerMsAligned;
-        DIRETTA_LOG("DSD buffer (1ms): " << bytesPerBuffer << " bytes");
-    } else {
-        DIRETTA_LOG("DSD buffer (MTU): " << bytesPerBuffer << " bytes");
-    }
+    // Buffer layout from the format table (4-byte channel groups, 1ms when it fits the MTU)
+    const DirettaFormat::Layout layout = DirettaFormat::dsd(byteRate, channels, m_effectiveMTU);
+    size_t bytesPerBuffer = static_cast<size_t>(layout.bytesPerBuffer);
+    DIRETTA_LOG("DSD buffer (" << (layout.oneMsBuffers ? "1ms" : "MTU") << "): " << bytesPerBuffer << " bytes");
 
     m_bytesPerBuffer.store(static_cast<int>(bytesPerBuffer), std::memory_order_release);
     m_bytesPerFrame.store(0, std::memory_order_release);
     m_framesPerBufferRemainder.store(0, std::memory_order_release);
     m_framesPerBufferAccumulator.store(0, std::memory_order_release);
+    m_stabilizationTarget.store(layout.stabilizationBuffers, std::memory_order_release);
+    m_firstConnectStabilizationTarget.store(layout.firstConnectStabilizationBuffers, std::memory_order_release);
 
     if (m_config.dsdPrefillMs > 0) {
         m_prefillTarget = (static_cast<size_t>(bytesPerSecond) * m_config.dsdPrefillMs) / 1000;
@@ -1365,7 +1514,10 @@ void DirettaSync::configureRingDSD(uint32_t byteRate, int channels) {
         m_prefillTarget = DirettaBuffer::calculatePrefill(bytesPerSecond, true, false);
     }
     m_prefillTarget = std::min(m_prefillTarget, ringSize / 4);
+    m_seekPrefillTarget = std::min(m_prefillTarget, std::max(DirettaBuffer::MIN_PREFILL_BYTES,
+        static_cast<size_t>(bytesPerSecond) * DirettaBuffer::SEEK_PREFILL_MS / 1000));
     m_prefillComplete = false;
+    m_seekRefill = false;
 
     DIRETTA_LOG("Ring DSD: byteRate=" << byteRate << " ch=" << channels
                 << " buffer=" << ringSize << " bytesPerBuffer=" << bytesPerBuffer
@@ -1454,6 +1606,7 @@ void DirettaSync::resumePlayback() {
     // Clear stale buffer data and require fresh prefill
     m_ringBuffer.clear();
     m_prefillComplete = false;
+    m_seekRefill = false;
 
     play();
     m_paused = false;
@@ -1462,6 +1615,24 @@ void DirettaSync::resumePlayback() {
     DIRETTA_LOG("Resumed - buffer cleared, waiting for prefill");
 }
 
+void DirettaSync::flushForSeek(std::chrono::steady_clock::time_point requestedAt) {
+    std::lock_guard<std::recursive_mutex> lifecycleLock(m_lifecycleMutex);
+    if (!m_open || !m_playing || m_paused) return;
+
+    {
+        // The worker serves silence until the short refill completes
+        ReconfigureGuard guard(*this);
+        DirettaRingBuffer::S24PackMode s24 = m_ringBuffer.getS24PackMode();
+        if (s24 == DirettaRingBuffer::S24PackMode::Unknown) s24 = m_ringBuffer.getS24Hint();
+        m_ringBuffer.clear();
+        if (s24 != DirettaRingBuffer::S24PackMode::Unknown) m_ringBuffer.setS24PackModeHint(s24);
+        m_seekRequestedAt = requestedAt;
+        m_seekRefill = true;
+        m_prefillComplete = false;
+    }
+    DIRETTA_LOG("Seek: ring flushed, refill " << m_seekPrefillTarget << " bytes");
+}
+
 void DirettaSync::sendPreTransitionSilence() {
     // Pre-transition silence disabled - was causing issues during format switching
     // The stopPlayback() silence mechanism handles this case adequately
@@ -1495,6 +1666,8 @@ size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
         m_cachedPack24bit = m_need24BitPack.load(std::memory_order_acquire);
         m_cachedUpsample16to32 = m_need16To32Upsample.load(std::memory_order_acquire);
         m_cachedUpsample16to24 = m_need16To24Upsample.load(std::memory_order_acquire);
+        m_cachedConvertOnPop = m_popConversion.load(std::memory_order_acquire) !=
+                               DirettaRingBuffer::PopConversion::None;
         m_cachedChannels = m_channels.load(std::memory_order_acquire);
         m_cachedBytesPerSample = m_bytesPerSample.load(std::memory_order_acquire);
         m_cachedDsdConversionMode = m_dsdConversionMode.load(std::memory_order_acquire);
@@ -1514,6 +1687,11 @@ size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
     size_t totalBytes;
     const char* formatLabel;
 
+    // Wire markers count ring bytes (not input bytes) - conversions change the size
+    bool wireMarkers = m_wireMarkers.enabled();
+    uint32_t ringEpoch = wireMarkers ? m_ringBuffer.clearCount() : 0;
+    size_t writeCursor = wireMarkers ? m_ringBuffer.writeCursor() : 0;
+
     if (doPMode) {
         // DoP: DSD planar data encoded as 24-bit PCM frames with alternating markers
         // numSamples encoding from AudioEngine: numSamples = (totalBytes * 8) / channels
@@ -1553,7 +1731,8 @@ size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
         size_t bytesPerFrame = 4 * numChannels;  // S24_P32
         totalBytes = numSamples * bytesPerFrame;
 
-        written = m_ringBuffer.push24BitPacked(data, totalBytes);
+        written = m_cachedConvertOnPop ? m_ringBuffer.pushS24Source(data, totalBytes, bytesPerFrame)
+                                       : m_ringBuffer.push24BitPacked(data, totalBytes);
         formatLabel = "PCM24";
 
     } else if (upsample16to32) {
@@ -1561,7 +1740,8 @@ size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
         size_t bytesPerFrame = 2 * numChannels;
         totalBytes = numSamples * bytesPerFrame;
 
-        written = m_ringBuffer.push16To32(data, totalBytes);
+        written = m_cachedConvertOnPop ? m_ringBuffer.pushSamples(data, totalBytes, bytesPerFrame)
+                                       : m_ringBuffer.push16To32(data, totalBytes);
         formatLabel = "PCM16->32";
 
     } else if (upsample16to24) {
@@ -1569,7 +1749,8 @@ size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
         size_t bytesPerFrame = 2 * numChannels;
         totalBytes = numSamples * bytesPerFrame;
 
-        written = m_ringBuffer.push16To24(data, totalBytes);
+        written = m_cachedConvertOnPop ? m_ringBuffer.pushSamples(data, totalBytes, bytesPerFrame)
+                                       : m_ringBuffer.push16To24(data, totalBytes);
         formatLabel = "PCM16->24";
 
     } else {
@@ -1581,12 +1762,36 @@ size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
         formatLabel = "PCM";
     }
 
+    if (wireMarkers && written > 0) {
+        size_t ringBytes = (m_ringBuffer.writeCursor() - writeCursor) & (m_ringBuffer.size() - 1);
+        m_wireMarkers.onRingWrite(ringBytes, ringEpoch);
+    }
+
+    // Bit-perfect tap: hash exactly what the ring accepted, before the consumer can pop it
+    if (written > 0 && m_tap.enabled()) {
+        tapInput(data, written, totalBytes);
+    }
+
     // Check prefill completion
     if (written > 0) {
         if (!m_prefillComplete.load(std::memory_order_acquire)) {
-            if (m_ringBuffer.getAvailable() >= m_prefillTarget) {
+            bool seekRefill = m_seekRefill.load(std::memory_order_acquire);
+            if (m_ringBuffer.getAvailable() >= (seekRefill ? m_seekPrefillTarget : m_prefillTarget)) {
                 m_prefillComplete = true;
-                DIRETTA_LOG(formatLabel << " prefill complete: " << m_ringBuffer.getAvailable() << " bytes");
+                if (seekRefill) {
+                    m_seekRefill = false;
+                    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - m_seekRequestedAt).count();
+                    m_seekCount.fetch_add(1, std::memory_order_relaxed);
+                    m_seekLastUs.store(us, std::memory_order_relaxed);
+                    if (us > m_seekMaxUs.load(std::memory_order_relaxed)) {
+                        m_seekMaxUs.store(us, std::memory_order_relaxed);
+                    }
+                    DIRETTA_LOG(formatLabel << " seek refill complete: " << m_ringBuffer.getAvailable()
+                                << " bytes, " << (us / 1000) << "ms after the request");
+                } else {
+                    DIRETTA_LOG(formatLabel << " prefill complete: " << m_ringBuffer.getAvailable() << " bytes");
+                }
             }
         }
 
@@ -1639,6 +1844,9 @@ void DirettaSync::dumpStats() const {
     std::cout << "  Buffer:      " << avail << "/" << ringSize
               << " bytes (" << std::fixed << std::setprecision(1) << fillPct << "%)"
               << std::endl;
+    if (m_popConversion.load(std::memory_order_relaxed) != DirettaRingBuffer::PopConversion::None) {
+        std::cout << "  Ring mode:   convert-on-pop (source format samples)" << std::endl;
+    }
     std::cout << "  MTU:         " << m_effectiveMTU << std::endl;
 
     // Counters
@@ -1646,6 +1854,59 @@ void DirettaSync::dumpStats() const {
     std::cout << "  Pushes:      " << m_pushCount.load(std::memory_order_relaxed) << std::endl;
     std::cout << "  Underruns:   " << m_underrunCount.load(std::memory_order_relaxed) << std::endl;
 
+    // Worker wake-up error
+    WorkerWakeStats wake = getWorkerWakeStats();
+    std::cout << "  Worker wait: " << workerWaitName(wake.mode)
+              << " (poll " << wake.pollPeriodUs << "us)" << std::endl;
+    std::cout << "  Wake error:  mean " << std::setprecision(1) << (wake.meanErrorNs / 1000.0)
+              << "us, max " << (wake.maxErrorNs / 1000.0) << "us, late "
+              << wake.lateWakeups << "/" << wake.wakeups << std::endl;
+
+    // Consumer callback execution time
+    CallbackTimeStats cb = getCallbackTimeStats();
+    std::cout << "  Callback:    mean " << std::setprecision(2) << (cb.meanNs / 1000.0)
+              << "us, stddev " << (cb.stddevNs / 1000.0) << "us, CV " << std::setprecision(3) << cb.cv
+              << ", max " << std::setprecision(1) << (cb.maxNs / 1000.0) << "us"
+              << (cb.constantWork ? " [constant-work]" : "") << std::endl;
+
+    // Target clock drift
+    ClockDriftEstimator::Estimate drift = getClockDrift();
+    if (drift.valid) {
+        std::cout << "  Clock drift: " << std::showpos << std::setprecision(1) << drift.ppm
+                  << std::noshowpos << " ppm (" << drift.windowSeconds << "s window)" << std::endl;
+        std::cout << "  Fill trend:  " << std::showpos << drift.fillSlope << std::noshowpos << " B/s";
+        if (drift.secondsToUnderrun >= 0) {
+            std::cout << ", underrun in " << drift.secondsToUnderrun << "s";
+        } else if (drift.secondsToOverrun >= 0) {
+            std::cout << ", overrun in " << drift.secondsToOverrun << "s";
+        }
+        std::cout << std::endl;
+    }
+
+    SeekStats seek = getSeekStats();
+    if (seek.seeks > 0) {
+        std::cout << "  Seek:        " << seek.seeks << " seek(s), last " << std::setprecision(1)
+                  << seek.lastMs << "ms, max " << seek.maxMs << "ms (request -> ring refilled)" << std::endl;
+    }
+
+    if (m_wireMarkers.enabled()) {
+        WireMarkers::Stats wm = m_wireMarkers.getStats();
+        std::cout << "  Decode->wire: last " << std::setprecision(1) << (wm.lastLatencyNs / 1e6)
+                  << "ms, mean " << (wm.meanLatencyNs / 1e6) << "ms, max " << (wm.maxLatencyNs / 1e6)
+                  << "ms (" << wm.released << " markers, " << wm.flushed << " flushed, "
+                  << wm.dropped << " dropped)" << std::endl;
+    }
+
+    if (m_tap.enabled()) {
+        BitPerfectTap::Stats tap = m_tap.getStats();
+        std::cout << "  Bit-perfect: " << tap.tracksBitPerfect << " tracks OK, "
+                  << tap.tracksMismatched << " mismatched" << std::endl;
+        std::cout << "  Tap blocks:  " << tap.blocksVerified << " ok, "
+                  << tap.blocksMismatched << " bad, " << tap.blocksUnverified
+                  << " unverified, " << tap.formatErrors << " format errors, "
+                  << tap.wireDrops << " drops" << std::endl;
+    }
+
     std::cout << "════════════════════════════════════════\n" << std::endl;
 }
 
@@ -1660,6 +1921,9 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
     // (Confirmed by Yu Harada: memory management is application's responsibility)
 
     m_workerActive = true;
+    int64_t entryNs = monotonicNs();
+    CallbackTimer callbackTimer(entryNs, m_callbackCount, m_callbackSumNs,
+                                m_callbackSumSqNs, m_callbackMaxNs);
 
     // C1: Generation counter optimization for stable state
     // Single atomic load in common case (format rarely changes during playback)
@@ -1675,7 +1939,17 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
         // PCM buffer rounding drift fix values (stable per-track)
         m_cachedBytesPerFrame = m_bytesPerFrame.load(std::memory_order_acquire);
         m_cachedFramesPerBufferRemainder = m_framesPerBufferRemainder.load(std::memory_order_acquire);
+        m_cachedPopConversion = m_popConversion.load(std::memory_order_acquire);
+        m_cachedStabilizationTarget = m_stabilizationTarget.load(std::memory_order_acquire);
+        m_cachedFirstConnectStabilizationTarget = m_firstConnectStabilizationTarget.load(std::memory_order_acquire);
         m_cachedConsumerGen = gen;
+
+        // Constant-work mode: silence page in ring format, one max-size buffer worth
+        size_t mirror = m_ringBuffer.readMirror();
+        m_cachedConstantWork = mirror > 0;
+        if (m_cachedConstantWork) {
+            m_silencePage.assign(mirror, m_cachedSilenceByte);
+        }
     }
 
     // Hot path: use cached values
@@ -1720,6 +1994,17 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
         m_framesPerBufferAccumulator.store(acc, std::memory_order_relaxed);
     }
 
+    // Target clock sample: every callback consumes a buffer, silence or audio
+    {
+        uint32_t seq = m_clockSeq.load(std::memory_order_relaxed);
+        m_clockSeq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_clockBytes.store(m_clockBytes.load(std::memory_order_relaxed) + currentBytesPerBuffer,
+                           std::memory_order_relaxed);
+        m_clockLastNs.store(entryNs, std::memory_order_relaxed);
+        m_clockSeq.store(seq + 2, std::memory_order_release);
+    }
+
     // SDK 148 WORKAROUND: Use our own buffer instead of Stream::resize()
     // Resize our persistent buffer if needed
     if (m_streamData.size() != static_cast<size_t>(currentBytesPerBuffer)) {
@@ -1735,18 +2020,37 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
 
     RingAccessGuard ringGuard(m_ringUsers, m_reconfiguring);
     if (!ringGuard.active()) {
+        // Ring is being reconfigured: the only path that can't go through it
         fillSilence(dest, currentBytesPerBuffer);
         m_workerActive = false;
         return true;
     }
 
+    // Ring bytes this callback needs (source format when converting on pop)
+    size_t ringBytesNeeded = static_cast<size_t>(currentBytesPerBuffer);
+    if (m_cachedPopConversion != DirettaRingBuffer::PopConversion::None) {
+        ringBytesNeeded = ringBytesNeeded / DirettaRingBuffer::popWireBytes(m_cachedPopConversion)
+                          * DirettaRingBuffer::popSourceBytes(m_cachedPopConversion);
+    }
+
+    // Constant-work consumer: silence and audio both go through the same
+    // fixed-size copy from ring memory or the silence page (see popConstantWork)
+    bool constantWork = m_cachedConstantWork && ringBytesNeeded <= m_silencePage.size();
+    auto serveSilence = [&](uint8_t* buf, int size) {
+        if (constantWork) {
+            m_ringBuffer.popConstantWork(buf, size, m_silencePage.data(), false, m_cachedPopConversion);
+        } else {
+            fillSilence(buf, size);
+        }
+    };
+
     bool currentIsDsd = m_cachedConsumerIsDsd;
     size_t currentRingSize = m_ringBuffer.size();
 
     // Shutdown silence
     int silenceRemaining = m_silenceBuffersRemaining.load(std::memory_order_acquire);
     if (silenceRemaining > 0) {
-        fillSilence(dest, currentBytesPerBuffer);
+        serveSilence(dest, currentBytesPerBuffer);
         m_silenceBuffersRemaining.fetch_sub(1, std::memory_order_acq_rel);
         m_workerActive = false;
         return true;
@@ -1754,14 +2058,14 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
 
     // Stop requested
     if (m_stopRequested.load(std::memory_order_acquire)) {
-        fillSilence(dest, currentBytesPerBuffer);
+        serveSilence(dest, currentBytesPerBuffer);
         m_workerActive = false;
         return true;
     }
 
     // Prefill not complete
     if (!m_prefillComplete.load(std::memory_order_acquire)) {
-        fillSilence(dest, currentBytesPerBuffer);
+        serveSilence(dest, currentBytesPerBuffer);
         m_workerActive = false;
         return true;
     }
@@ -1772,51 +2076,12 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
     // With large MTU (9000+), calls are less frequent (longer cycle time)
     // We need to scale buffer count to achieve target warmup duration
     if (!m_postOnlineDelayDone.load(std::memory_order_acquire)) {
-        int stabilizationTarget = static_cast<int>(DirettaBuffer::POST_ONLINE_SILENCE_BUFFERS);
-
-        // Calculate cycle time based on MTU and data rate for time-based scaling
-        int efficientMTU = static_cast<int>(m_effectiveMTU) - 3;
-        int currentSampleRate = m_cachedConsumerSampleRate;
-
-        if (currentIsDsd) {
-            // Target warmup time scales with DSD rate:
-            // DSD64: 50ms, DSD128: 100ms, DSD256: 200ms, DSD512: 400ms
-            int dsdMultiplier = currentSampleRate / 2822400;  // DSD64 = 1
-            int targetWarmupMs = 50 * std::max(1, dsdMultiplier);  // 50ms baseline
-
-            double bytesPerSecond = static_cast<double>(currentSampleRate) * 2 / 8.0;  // 2ch, 1bit
-            // Use actual buffer size for cycle time (not MTU); avoids 10x overcount on 1ms-buffer paths
-            double cycleTimeUs = (bytesPerSecond > 0)
-                ? (static_cast<double>(currentBytesPerBuffer) / bytesPerSecond) * 1000000.0
-                : 1000.0;  // fallback: assume 1ms cycle if rate unknown
-
-            double buffersNeeded = (targetWarmupMs * 1000.0) / cycleTimeUs;
-            stabilizationTarget = static_cast<int>(std::ceil(buffersNeeded));
-            stabilizationTarget = std::max(50, std::min(stabilizationTarget, 3000));
-        } else {
-            // PCM (including DoP): Scale stabilization with actual buffer size
-            // First connect needs extra time for target clock sync
-            int targetWarmupMs = m_isFirstConnect
-                ? static_cast<int>(DirettaBuffer::FIRST_CONNECT_STABILIZATION_MS)
-                : static_cast<int>(DirettaBuffer::DAC_STABILIZATION_MS);
-
-            int channels = m_channels.load(std::memory_order_acquire);
-            int bps = m_bytesPerSample.load(std::memory_order_acquire);
-            if (channels <= 0) channels = 2;
-            if (bps <= 0) bps = 4;
-            double bytesPerSecond = static_cast<double>(currentSampleRate) * channels * bps;
-            // Bug fix: was using efficientMTU instead of actual buffer size; for DoP at 176.4kHz
-            // that gave cycleTimeUs=1.4µs (wrong) instead of 1ms, causing 3000 buffers of silence
-            // (3 seconds) instead of the intended 100ms — enough to prevent DAC DoP lock.
-            double cycleTimeUs = (bytesPerSecond > 0)
-                ? (static_cast<double>(currentBytesPerBuffer) / bytesPerSecond) * 1000000.0
-                : 1000.0;  // fallback: assume 1ms cycle if rate unknown
-
-            double buffersNeeded = (targetWarmupMs * 1000.0) / cycleTimeUs;
-            stabilizationTarget = static_cast<int>(std::ceil(buffersNeeded));
-            stabilizationTarget = std::max(static_cast<int>(DirettaBuffer::POST_ONLINE_SILENCE_BUFFERS),
-                                           std::min(stabilizationTarget, 3000));
-        }
+        // Precomputed per format (DirettaFormat::Layout): DSD warmup scales with
+        // rate (DSD64 50ms ... DSD512 400ms), PCM uses DAC_STABILIZATION_MS or
+        // FIRST_CONNECT_STABILIZATION_MS, both converted to buffer counts
+        int stabilizationTarget = m_isFirstConnect
+            ? m_cachedFirstConnectStabilizationTarget
+            : m_cachedStabilizationTarget;
 
         int count = m_stabilizationCount.fetch_add(1, std::memory_order_relaxed) + 1;
         if (count >= stabilizationTarget) {
@@ -1829,7 +2094,7 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
                 DIRETTA_LOG("Post-online stabilization complete (" << count << " buffers)");
             }
         }
-        fillSilence(dest, currentBytesPerBuffer);
+        serveSilence(dest, currentBytesPerBuffer);
         m_workerActive = false;
         return true;
     }
@@ -1860,29 +2125,37 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
                      << avail << ", threshold=" << threshold << ")");
             // Fall through to normal pop below
         } else {
-            fillSilence(dest, currentBytesPerBuffer);
+            serveSilence(dest, currentBytesPerBuffer);
             m_workerActive = false;
             return true;
         }
     }
 
     // Underrun detection — enter rebuffering mode for clean silence
-    if (avail < static_cast<size_t>(currentBytesPerBuffer)) {
+    if (avail < ringBytesNeeded) {
         m_underrunCount.fetch_add(1, std::memory_order_relaxed);
         if (!m_rebuffering.load(std::memory_order_relaxed)) {
             m_rebuffering.store(true, std::memory_order_release);
             LOG_WARN("[DirettaSync] Buffer underrun — entering rebuffering mode (avail=" << avail << ")");
         }
-        fillSilence(dest, currentBytesPerBuffer);
+        serveSilence(dest, currentBytesPerBuffer);
         m_workerActive = false;
         return true;
     }
 
-    // Pop from ring buffer directly into SDK stream
-    m_ringBuffer.pop(dest, currentBytesPerBuffer);
+    // Pop from ring buffer directly into SDK stream (converting if the ring holds source format)
+    uint32_t ringEpoch = m_ringBuffer.clearCount();
+    if (constantWork) {
+        m_ringBuffer.popConstantWork(dest, currentBytesPerBuffer, m_silencePage.data(), true, m_cachedPopConversion);
+    } else {
+        m_ringBuffer.popConverted(dest, currentBytesPerBuffer, m_cachedPopConversion);
+    }
+    if (m_tap.enabled()) m_tap.onWire(dest, currentBytesPerBuffer);
+    if (m_wireMarkers.enabled()) m_wireMarkers.onRingRead(ringBytesNeeded, ringEpoch, entryNs);
 
     // Diagnostic: log first 5 pops in DoP mode so we can verify marker bytes and DSD content
-    if (g_verbose && currentIsDoP) {
+    // (skipped in constant-work mode: printf in the callback defeats its purpose)
+    if (g_verbose && currentIsDoP && !constantWork) {
         int popIdx = m_popCount.fetch_add(1, std::memory_order_relaxed) + 1;
         if (popIdx <= 5) {
             int show = std::min(currentBytesPerBuffer, 12);  // 2 stereo DoP frames
@@ -1931,6 +2204,11 @@ bool DirettaSync::startSyncWorker() {
     m_running = true;
     m_stopRequested = false;
 
+    m_wakeCount.store(0, std::memory_order_relaxed);
+    m_wakeLateCount.store(0, std::memory_order_relaxed);
+    m_wakeErrorSumNs.store(0, std::memory_order_relaxed);
+    m_wakeErrorMaxNs.store(0, std::memory_order_relaxed);
+
     m_workerThread = std::thread([this]() {
         // F1: Elevate worker thread priority for reduced jitter
         // SCHED_FIFO priority 50 (mid-range real-time) - requires root/CAP_SYS_NICE
@@ -1958,11 +2236,70 @@ bool DirettaSync::startSyncWorker() {
             }
         }
 
+        // Default timer slack (50µs) is added to every sleep of a non-RT-class
+        // thread; 1ns makes the wakeup land on the requested deadline
+        if (prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL) != 0) {
+            DIRETTA_LOG("PR_SET_TIMERSLACK failed (errno " << errno << ")");
+        }
+
+        DirettaWorkerWait mode = m_config.workerWait;
+        int tfd = -1;
+        if (mode == DirettaWorkerWait::TIMERFD) {
+            tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+            if (tfd < 0) {
+                std::cerr << "[DirettaSync] WARNING: timerfd_create failed (errno " << errno
+                          << "), using abstime worker loop" << std::endl;
+                mode = DirettaWorkerWait::ABSTIME;
+            }
+        }
+        m_activeWorkerWait.store(mode, std::memory_order_relaxed);
+        DIRETTA_LOG("Worker wait mode: " << workerWaitName(mode));
+
+        // Grid anchored at worker start; re-anchored when the cycle time changes
+        int64_t anchorNs = monotonicNs();
+        unsigned int gridCycleUs = 0;
+        int64_t periodNs = 0;
+
         while (m_running.load(std::memory_order_acquire)) {
-            if (!syncWorker()) {
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            if (syncWorker()) continue;
+
+            if (mode == DirettaWorkerWait::SLEEP) {
+                int64_t deadlineNs = monotonicNs() + DirettaWorker::LEGACY_POLL_US * 1000LL;
+                std::this_thread::sleep_for(std::chrono::microseconds(DirettaWorker::LEGACY_POLL_US));
+                recordWakeError(monotonicNs() - deadlineNs);
+                continue;
+            }
+
+            unsigned int cycleUs = m_cycleTimeUs.load(std::memory_order_relaxed);
+            if (cycleUs == 0) cycleUs = m_config.cycleTime;
+            if (cycleUs != gridCycleUs) {
+                gridCycleUs = cycleUs;
+                periodNs = DirettaWorker::pollPeriodUs(cycleUs) * 1000LL;
+                anchorNs = monotonicNs();
+                if (tfd >= 0) {
+                    struct itimerspec its;
+                    its.it_value = nsToTimespec(anchorNs + periodNs);
+                    its.it_interval = nsToTimespec(periodNs);
+                    timerfd_settime(tfd, TFD_TIMER_ABSTIME, &its, nullptr);
+                }
+            }
+
+            if (tfd >= 0) {
+                uint64_t expirations = 0;
+                ssize_t n = read(tfd, &expirations, sizeof(expirations));
+                if (n != static_cast<ssize_t>(sizeof(expirations))) continue;  // EINTR
+                // Error is measured against the most recent expiry (grid point <= now)
+                int64_t now = monotonicNs();
+                recordWakeError(now - (nextGridPoint(anchorNs, periodNs, now) - periodNs));
+            } else {
+                int64_t deadlineNs = nextGridPoint(anchorNs, periodNs, monotonicNs());
+                struct timespec ts = nsToTimespec(deadlineNs);
+                while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+                recordWakeError(monotonicNs() - deadlineNs);
             }
         }
+
+        if (tfd >= 0) ::close(tfd);
     });
 
     return true;
@@ -2012,6 +2349,144 @@ bool DirettaSync::joinWorkerWithTimeout(int timeoutMs) {
     return !m_workerActive.load(std::memory_order_acquire);
 }
 
+void DirettaSync::recordWakeError(int64_t errorNs) {
+    // Single writer (worker thread): plain load/store, no RMW needed
+    if (errorNs < 0) errorNs = 0;
+    m_wakeCount.store(m_wakeCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_wakeErrorSumNs.store(m_wakeErrorSumNs.load(std::memory_order_relaxed) + errorNs,
+                           std::memory_order_relaxed);
+    if (errorNs > m_wakeErrorMaxNs.load(std::memory_order_relaxed)) {
+        m_wakeErrorMaxNs.store(errorNs, std::memory_order_relaxed);
+    }
+    if (errorNs > DirettaWorker::LATE_WAKE_NS) {
+        m_wakeLateCount.store(m_wakeLateCount.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+    }
+}
+
+bool DirettaSync::markWire(WireMarkers::Kind kind, uint32_t track, uint64_t frame, uint32_t sampleRate) {
+    if (!m_wireMarkers.enabled()) return false;
+    return m_wireMarkers.mark(kind, track, frame, sampleRate, monotonicNs(), m_ringBuffer.clearCount());
+}
+
+DirettaSync::CallbackTimeStats DirettaSync::getCallbackTimeStats() const {
+    CallbackTimeStats stats;
+    stats.callbacks = m_callbackCount.load(std::memory_order_relaxed);
+    stats.maxNs = m_callbackMaxNs.load(std::memory_order_relaxed);
+    stats.constantWork = m_config.constantWorkConsumer;
+    if (stats.callbacks > 0) {
+        double n = static_cast<double>(stats.callbacks);
+        stats.meanNs = static_cast<double>(m_callbackSumNs.load(std::memory_order_relaxed)) / n;
+        double var = m_callbackSumSqNs.load(std::memory_order_relaxed) / n - stats.meanNs * stats.meanNs;
+        stats.stddevNs = var > 0.0 ? std::sqrt(var) : 0.0;
+        stats.cv = stats.meanNs > 0.0 ? stats.stddevNs / stats.meanNs : 0.0;
+    }
+    return stats;
+}
+
+DirettaSync::WorkerWakeStats DirettaSync::getWorkerWakeStats() const {
+    WorkerWakeStats stats;
+    stats.wakeups = m_wakeCount.load(std::memory_order_relaxed);
+    stats.lateWakeups = m_wakeLateCount.load(std::memory_order_relaxed);
+    stats.maxErrorNs = m_wakeErrorMaxNs.load(std::memory_order_relaxed);
+    int64_t sum = m_wakeErrorSumNs.load(std::memory_order_relaxed);
+    stats.meanErrorNs = stats.wakeups > 0 ? sum / static_cast<int64_t>(stats.wakeups) : 0;
+    stats.mode = m_activeWorkerWait.load(std::memory_order_relaxed);
+    unsigned int cycleUs = m_cycleTimeUs.load(std::memory_order_relaxed);
+    stats.pollPeriodUs = (stats.mode == DirettaWorkerWait::SLEEP)
+        ? DirettaWorker::LEGACY_POLL_US
+        : DirettaWorker::pollPeriodUs(cycleUs > 0 ? cycleUs : m_config.cycleTime);
+    return stats;
+}
+
+DirettaSync::SeekStats DirettaSync::getSeekStats() const {
+    SeekStats stats;
+    stats.seeks = m_seekCount.load(std::memory_order_relaxed);
+    stats.lastMs = m_seekLastUs.load(std::memory_order_relaxed) / 1000.0;
+    stats.maxMs = m_seekMaxUs.load(std::memory_order_relaxed) / 1000.0;
+    return stats;
+}
+
+ClockDriftEstimator::Estimate DirettaSync::updateClockDrift() {
+    // Consistent (timestamp, bytes) pair from the worker's last callback
+    uint32_t s1, s2;
+    uint64_t bytes;
+    int64_t tNs;
+    do {
+        s1 = m_clockSeq.load(std::memory_order_acquire);
+        bytes = m_clockBytes.load(std::memory_order_relaxed);
+        tNs = m_clockLastNs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        s2 = m_clockSeq.load(std::memory_order_relaxed);
+    } while (s1 != s2 || (s1 & 1));
+
+    if (bytes == 0) return getClockDrift();
+
+    RingAccessGuard ringGuard(m_ringUsers, m_reconfiguring);
+    if (!ringGuard.active()) return getClockDrift();
+
+    // New series on format change or ring clear (fill level discontinuity)
+    uint32_t gen = m_consumerStateGen.load(std::memory_order_acquire);
+    uint32_t clears = m_ringBuffer.clearCount();
+    bool restarted = gen != m_driftConsumerGen || clears != m_driftClearCount;
+    if (restarted) {
+        double nominal;
+        int rate = m_sampleRate.load(std::memory_order_acquire);
+        int channels = m_channels.load(std::memory_order_acquire);
+        if (m_isDsdMode.load(std::memory_order_acquire)) {
+            nominal = static_cast<double>(rate) / 8.0 * channels;
+        } else {
+            nominal = static_cast<double>(rate) * channels * m_bytesPerSample.load(std::memory_order_acquire);
+        }
+        m_drift.reset(nominal, m_ringBuffer.size());
+        m_driftConsumerGen = gen;
+        m_driftClearCount = clears;
+    }
+
+    if (m_drift.addPoint(tNs, bytes, m_ringBuffer.getAvailable()) || restarted) {
+        std::lock_guard<std::mutex> lock(m_driftMutex);
+        m_driftEstimate = m_drift.estimate();
+    }
+    return getClockDrift();
+}
+
+ClockDriftEstimator::Estimate DirettaSync::getClockDrift() const {
+    std::lock_guard<std::mutex> lock(m_driftMutex);
+    return m_driftEstimate;
+}
+
+void DirettaSync::tapInput(const uint8_t* data, size_t consumed, size_t totalBytes) {
+    // A ring clear/resize or format change starts a new tap stream. Both happen
+    // with prefill reset, so nothing of the new stream was popped yet.
+    uint32_t clears = m_ringBuffer.clearCount();
+    if (clears != m_tapClearCount || m_cachedFormatGen != m_tapFormatGen) {
+        BitPerfect::StreamParams params;
+        params.channels = m_cachedChannels;
+        params.wireBytesPerSample = m_cachedBytesPerSample;
+        params.dsdMode = m_cachedDsdConversionMode;
+        params.dopBitReverse = g_dopMsb;
+        if (m_cachedDoPMode) params.transform = BitPerfect::Transform::DoP;
+        else if (m_cachedDsdMode) params.transform = BitPerfect::Transform::DsdNative;
+        else if (m_cachedPack24bit) params.transform = BitPerfect::Transform::Pack24;
+        else if (m_cachedUpsample16to32) params.transform = BitPerfect::Transform::Pad16To32;
+        else if (m_cachedUpsample16to24) params.transform = BitPerfect::Transform::Pad16To24;
+        else params.transform = BitPerfect::Transform::Direct;
+        m_tap.beginStream(params);
+        m_tapClearCount = clears;
+        m_tapFormatGen = m_cachedFormatGen;
+    }
+
+    uint32_t marks = m_tapTrackMarks.load(std::memory_order_acquire);
+    while (m_tapTrackMarksSeen != marks) {
+        m_tap.markTrack();
+        m_tapTrackMarksSeen++;
+    }
+
+    bool s24Msb = m_cachedPack24bit &&
+        m_ringBuffer.getEffectiveS24PackMode() == DirettaRingBuffer::S24PackMode::MsbAligned;
+    m_tap.onInput(data, consumed, totalBytes, s24Msb);
+}
+
 void DirettaSync::requestShutdownSilence(int buffers) {
     // N7: Scale silence buffers with DSD rate for consistent flush timing
     // Higher DSD rates have deeper pipelines requiring more buffers
@@ -14,6 +14,10 @@
 #define DIRETTA_SYNC_H
 
 #include "DirettaRingBuffer.h"
+#include "BitPerfectTap.h"
+#include "ClockDriftEstimator.h"
+#include "WireMarkers.h"
+#include "TargetCache.h"
 
 #include <Sync.hpp>
 #include <Find.hpp>
@@ -34,6 +38,8 @@
 #include <cstring>
 #include <sstream>
 #include <condition_variable>
+#include <array>
+#include <iterator>
 
 //=============================================================================
 // Lock-free Log Ring Buffer (for non-blocking logging in hot paths)
@@ -195,6 +201,29 @@ namespace DirettaRetry {
     constexpr int DISCOVER_LOG_INTERVAL_MS = 5000; // Log status every 5 seconds
 }
 
+//=============================================================================
+// Worker Loop Timing
+//=============================================================================
+
+namespace DirettaWorker {
+    // Legacy poll interval when syncWorker() has nothing to send
+    constexpr int LEGACY_POLL_US = 100;
+
+    // Deadline modes wake on a grid of cycleTime / POLL_DIVISOR so every
+    // cycle boundary falls on a tick; clamped to keep idle wakeups bounded
+    constexpr unsigned int POLL_DIVISOR = 8;
+    constexpr unsigned int MIN_POLL_US = 50;
+    constexpr unsigned int MAX_POLL_US = 500;
+
+    // Wakeups later than this are counted as "late" in stats
+    constexpr int64_t LATE_WAKE_NS = 50000;
+
+    inline unsigned int pollPeriodUs(unsigned int cycleTimeUs) {
+        unsigned int period = cycleTimeUs / POLL_DIVISOR;
+        return std::max(MIN_POLL_US, std::min(period, MAX_POLL_US));
+    }
+}
+
 //=============================================================================
 // Buffer Configuration
 //=============================================================================
@@ -212,6 +241,8 @@ namespace DirettaBuffer {
     constexpr size_t PCM_LOWRATE_PREFILL_MS = 100;
     // High sample rates (>192kHz): source delivers at ~1x real-time, need more margin
     constexpr size_t PCM_HIGHRATE_PREFILL_MS = 1000;
+    // After a seek: the target is already streaming, only the ring is refilled
+    constexpr size_t SEEK_PREFILL_MS = 100;
 
     constexpr float REBUFFER_THRESHOLD_PCT = 0.20f;      // Resume playback after 20% buffer refill (local)
     constexpr float REBUFFER_THRESHOLD_REMOTE_PCT = 0.50f; // Remote: 50% for more resilience against CDN hiccups
@@ -227,24 +258,28 @@ namespace DirettaBuffer {
     constexpr size_t MIN_BUFFER_BYTES = 65536;  // Was 3072000
     constexpr size_t MAX_BUFFER_BYTES = 33554432;  // 32MB: accommodates 1536kHz/32bit/2ch @ 2s
     constexpr size_t MIN_PREFILL_BYTES = 1024;
+    // Constant-work consumer read mirror: largest getNewStream() ring read served
+    // by the constant-work path (larger buffers fall back to the normal pop).
+    // Must not exceed MIN_BUFFER_BYTES.
+    constexpr size_t CONSTANT_WORK_MIRROR_BYTES = 65536;
 
-    inline size_t calculateBufferSize(size_t bytesPerSecond, float seconds) {
+    constexpr size_t calculateBufferSize(size_t bytesPerSecond, float seconds) {
         size_t size = static_cast<size_t>(bytesPerSecond * seconds);
         size = std::max(size, MIN_BUFFER_BYTES);
         size = std::min(size, MAX_BUFFER_BYTES);
         return size;
     }
 
-    inline float pcmBufferSeconds(uint32_t sampleRate, bool isRemote) {
+    constexpr float pcmBufferSeconds(uint32_t sampleRate, bool isRemote) {
         if (sampleRate > HIGHRATE_THRESHOLD) return PCM_HIGHRATE_BUFFER_SECONDS;
         if (isRemote) return PCM_REMOTE_BUFFER_SECONDS;
         return PCM_BUFFER_SECONDS;
     }
 
-    inline size_t calculatePrefill(size_t bytesPerSecond, bool isDsd,
+    constexpr size_t calculatePrefill(size_t bytesPerSecond, bool isDsd,
                                    bool isLowBitrate, bool isRemote = false,
                                    uint32_t sampleRate = 0) {
-        size_t prefillMs;
+        size_t prefillMs = 0;
         if (isDsd) {
             prefillMs = DSD_PREFILL_MS;
         } else if (sampleRate > HIGHRATE_THRESHOLD) {
@@ -263,9 +298,9 @@ namespace DirettaBuffer {
     // Calculate DSD samples per call based on rate
     // Target: ~10-12ms chunks for consistent scheduling granularity
     // Returns DSD samples (1-bit), which convert to bytes via: bytes = samples * channels / 8
-    inline size_t calculateDsdSamplesPerCall(uint32_t dsdSampleRate) {
+    constexpr size_t calculateDsdSamplesPerCall(uint32_t dsdSampleRate) {
         // Target chunk duration in milliseconds
-        constexpr double TARGET_CHUNK_MS = 12.0;
+        constexpr size_t TARGET_CHUNK_MS = 12;
 
         // Limits
         constexpr size_t MIN_DSD_SAMPLES = 8192;   // ~3ms at DSD64
@@ -273,7 +308,7 @@ namespace DirettaBuffer {
 
         // Calculate samples for target duration
         // DSD sample rate is the 1-bit rate (e.g., 2822400 for DSD64)
-        size_t samplesPerCall = static_cast<size_t>(dsdSampleRate * TARGET_CHUNK_MS / 1000.0);
+        size_t samplesPerCall = static_cast<size_t>(dsdSampleRate) * TARGET_CHUNK_MS / 1000;
 
         // Round to multiple of 256 for alignment (32 bytes per channel minimum)
         samplesPerCall = ((samplesPerCall + 255) / 256) * 256;
@@ -301,9 +336,16 @@ public:
         : m_mtu(mtu), m_efficientMTU(mtu - OVERHEAD) {}
 
     unsigned int calculate(uint32_t sampleRate, int channels, int bitsPerSample) const {
-        double bytesPerSecond = static_cast<double>(sampleRate) * channels * bitsPerSample / 8.0;
-        double cycleTimeUs = (static_cast<double>(m_efficientMTU) / bytesPerSecond) * 1000000.0;
-        unsigned int result = static_cast<unsigned int>(std::round(cycleTimeUs));
+        return cycleTimeUs(m_efficientMTU, sampleRate, channels, bitsPerSample);
+    }
+
+    // Time to send one efficient-MTU packet at the format's bit rate, rounded to µs
+    static constexpr unsigned int cycleTimeUs(int efficientMTU, uint32_t sampleRate,
+                                              int channels, int bitsPerSample) {
+        uint64_t bitsPerSecond = static_cast<uint64_t>(sampleRate) * channels * bitsPerSample;
+        if (bitsPerSecond == 0) return 50000u;
+        uint64_t num = static_cast<uint64_t>(efficientMTU) * 8 * 1000000;
+        unsigned int result = static_cast<unsigned int>((num + bitsPerSecond / 2) / bitsPerSecond);
         return std::max(100u, std::min(result, 50000u));
     }
 
@@ -312,12 +354,227 @@ private:
     int m_efficientMTU;
 };
 
+//=============================================================================
+// Format Descriptor Table
+//=============================================================================
+
+// Per-format transport layout: bytes per getNewStream() buffer, 44.1k-family
+// drift correction, cycle time and post-online stabilization length.
+// Computed at compile time for every supported format and common MTUs, with
+// the layout invariants checked by static_assert below. configureRingPCM/DSD
+// look formats up here; anything outside the table (unusual MTU or channel
+// count) goes through the same constexpr functions at runtime.
+namespace DirettaFormat {
+    struct Layout {
+        uint32_t rate = 0;             // PCM frame rate; DSD bit rate per channel
+        int channels = 0;
+        int bytesPerSample = 0;        // Wire bytes per sample (DSD: 0)
+        bool dsd = false;
+        bool dop = false;
+        uint32_t mtu = 0;
+        uint64_t bytesPerSecond = 0;   // Wire bytes per second, all channels
+        int bytesPerFrame = 0;         // PCM/DoP frame; 0 for native DSD
+        int bytesPerBuffer = 0;
+        uint32_t framesRemainder = 0;  // 1ms buffers: rate % 1000 (drift accumulator)
+        bool oneMsBuffers = false;
+        unsigned int cycleTimeUs = 0;
+        int stabilizationBuffers = 0;
+        int firstConnectStabilizationBuffers = 0;
+    };
+
+    constexpr int efficientMTU(uint32_t mtu) {
+        int eff = static_cast<int>(mtu) - DirettaCycleCalculator::OVERHEAD;
+        return eff < 64 ? 1497 : eff;  // Fallback (1500 - 3)
+    }
+
+    // Buffers of silence covering warmupMs, clamped to [minBuffers, 3000]
+    constexpr int stabilizationBuffers(unsigned int warmupMs, uint64_t bytesPerSecond,
+                                       int bytesPerBuffer, int minBuffers) {
+        if (bytesPerBuffer <= 0 || bytesPerSecond == 0) return minBuffers;
+        uint64_t den = 1000 * static_cast<uint64_t>(bytesPerBuffer);
+        uint64_t buffers = (warmupMs * bytesPerSecond + den - 1) / den;
+        return std::max(minBuffers, static_cast<int>(std::min<uint64_t>(buffers, 3000)));
+    }
+
+    constexpr Layout pcmLayout(uint32_t rate, int channels, int bytesPerSample, bool dop, uint32_t mtu) {
+        Layout l;
+        l.rate = rate;
+        l.channels = channels;
+        l.bytesPerSample = bytesPerSample;
+        l.dop = dop;
+        l.mtu = mtu;
+        l.bytesPerFrame = channels * bytesPerSample;
+        l.bytesPerSecond = static_cast<uint64_t>(rate) * l.bytesPerFrame;
+        int eff = efficientMTU(mtu);
+
+        int bytesPerMs = static_cast<int>(rate / 1000) * l.bytesPerFrame;
+        if (bytesPerMs <= eff) {
+            // Low rates: 1ms buffers, 44.1k family corrected by the frame accumulator
+            l.oneMsBuffers = true;
+            l.bytesPerBuffer = bytesPerMs;
+            l.framesRemainder = rate % 1000;
+            if (dop && (rate / 1000) % 2 != 0) {
+                // DoP pops must stay even (accumulator adds 2 frames per 2000 units):
+                // drop one frame from the base and carry it in the remainder
+                l.bytesPerBuffer -= l.bytesPerFrame;
+                l.framesRemainder += 1000;
+            }
+        } else {
+            // High rates: MTU-sized, frame aligned. DoP: even frame count so every
+            // buffer starts on a 0x05 marker frame (see getNewStream)
+            int frames = eff / l.bytesPerFrame;
+            if (dop) frames &= ~1;
+            l.bytesPerBuffer = frames * l.bytesPerFrame;
+        }
+
+        l.cycleTimeUs = DirettaCycleCalculator::cycleTimeUs(eff, rate, channels, bytesPerSample * 8);
+        int minBuffers = static_cast<int>(DirettaBuffer::POST_ONLINE_SILENCE_BUFFERS);
+        l.stabilizationBuffers = stabilizationBuffers(DirettaBuffer::DAC_STABILIZATION_MS,
+            l.bytesPerSecond, l.bytesPerBuffer, minBuffers);
+        l.firstConnectStabilizationBuffers = stabilizationBuffers(DirettaBuffer::FIRST_CONNECT_STABILIZATION_MS,
+            l.bytesPerSecond, l.bytesPerBuffer, minBuffers);
+        return l;
+    }
+
+    // byteRate: DSD bytes per second per channel (bit rate / 8)
+    constexpr Layout dsdLayout(uint32_t byteRate, int channels, uint32_t mtu) {
+        Layout l;
+        l.rate = byteRate * 8;
+        l.channels = channels;
+        l.dsd = true;
+        l.mtu = mtu;
+        l.bytesPerSecond = static_cast<uint64_t>(byteRate) * channels;
+        int eff = efficientMTU(mtu);
+
+        // 4-byte channel groups (ring DSD interleave)
+        int blockSize = 4 * channels;
+        int bytesPerBuffer = (eff / blockSize) * blockSize;
+        if (bytesPerBuffer < 64) bytesPerBuffer = 64;
+
+        // For low DSD rates where 1ms fits in MTU, use 1ms buffers
+        int bytesPerMs = static_cast<int>(byteRate / 1000) * channels;
+        int bytesPerMsAligned = ((bytesPerMs + blockSize - 1) / blockSize) * blockSize;
+        if (bytesPerMsAligned <= eff) {
+            bytesPerBuffer = bytesPerMsAligned;
+            l.oneMsBuffers = true;
+        }
+        l.bytesPerBuffer = bytesPerBuffer;
+
+        l.cycleTimeUs = DirettaCycleCalculator::cycleTimeUs(eff, l.rate, channels, 1);
+        // Warmup scales with DSD rate: DSD64 50ms ... DSD512 400ms
+        unsigned int warmupMs = 50 * static_cast<unsigned int>(std::max<uint32_t>(1, l.rate / 2822400));
+        l.stabilizationBuffers = stabilizationBuffers(warmupMs, l.bytesPerSecond, l.bytesPerBuffer, 50);
+        l.firstConnectStabilizationBuffers = l.stabilizationBuffers;
+        return l;
+    }
+
+    constexpr uint32_t PCM_RATES[] = {
+        44100, 48000, 88200, 96000, 176400, 192000, 352800, 384000,
+        705600, 768000, 1411200, 1536000
+    };
+    constexpr int PCM_BYTES_PER_SAMPLE[] = {2, 3, 4};
+    constexpr uint32_t DOP_RATES[] = {176400, 352800, 705600, 1411200};   // DSD64..DSD512
+    constexpr uint32_t DSD_BYTE_RATES[] = {
+        352800, 384000, 705600, 768000, 1411200, 1536000,                   // DSD64..DSD256
+        2822400, 3072000, 5644800, 6144000                                  // DSD512, DSD1024
+    };
+    constexpr uint32_t MTUS[] = {1500, 4000, 9000, 16128};
+    constexpr int CHANNELS = 2;
+
+    constexpr size_t PCM_COUNT = std::size(PCM_RATES) * std::size(PCM_BYTES_PER_SAMPLE) * std::size(MTUS);
+    constexpr size_t DOP_COUNT = std::size(DOP_RATES) * std::size(MTUS);
+    constexpr size_t DSD_COUNT = std::size(DSD_BYTE_RATES) * std::size(MTUS);
+    constexpr size_t TABLE_SIZE = PCM_COUNT + DOP_COUNT + DSD_COUNT;
+
+    constexpr std::array<Layout, TABLE_SIZE> buildTable() {
+        std::array<Layout, TABLE_SIZE> t{};
+        size_t i = 0;
+        for (uint32_t mtu : MTUS) {
+            for (uint32_t rate : PCM_RATES)
+                for (int bps : PCM_BYTES_PER_SAMPLE) t[i++] = pcmLayout(rate, CHANNELS, bps, false, mtu);
+            for (uint32_t rate : DOP_RATES) t[i++] = pcmLayout(rate, CHANNELS, 3, true, mtu);
+            for (uint32_t byteRate : DSD_BYTE_RATES) t[i++] = dsdLayout(byteRate, CHANNELS, mtu);
+        }
+        return t;
+    }
+
+    inline constexpr std::array<Layout, TABLE_SIZE> TABLE = buildTable();
+
+    constexpr bool layoutValid(const Layout& l) {
+        int eff = efficientMTU(l.mtu);
+        if (l.bytesPerBuffer <= 0 || l.bytesPerBuffer > eff) return false;
+        if (l.cycleTimeUs < 100 || l.cycleTimeUs > 50000) return false;
+        if (l.stabilizationBuffers <= 0 || l.stabilizationBuffers > 3000) return false;
+        if (l.dsd) {
+            return l.bytesPerBuffer % (4 * l.channels) == 0;
+        }
+        // Frame-aligned buffers; the drift accumulator adds 1 frame (DoP: 2)
+        if (l.bytesPerBuffer % l.bytesPerFrame != 0) return false;
+        if (l.framesRemainder != 0 && !l.oneMsBuffers) return false;
+        if (l.framesRemainder >= (l.dop ? 2000u : 1000u)) return false;
+        int extraFrames = l.framesRemainder ? (l.dop ? 2 : 1) : 0;
+        if (l.bytesPerBuffer + extraFrames * l.bytesPerFrame > eff) return false;
+        // DoP: even frame count so marker phase is preserved across buffers
+        if (l.dop && (l.bytesPerBuffer / l.bytesPerFrame) % 2 != 0) return false;
+        return true;
+    }
+
+    constexpr bool tableValid() {
+        for (const Layout& l : TABLE) {
+            if (!layoutValid(l)) return false;
+        }
+        return true;
+    }
+
+    static_assert(tableValid(), "Format table: buffer layout invariant violated");
+    static_assert(pcmLayout(44100, 2, 2, false, 1500).bytesPerBuffer == 176 &&
+                  pcmLayout(44100, 2, 2, false, 1500).framesRemainder == 100,
+                  "44.1kHz/16: 1ms buffers of 44 frames + drift correction");
+    static_assert(pcmLayout(176400, 2, 3, true, 1500).bytesPerBuffer == 176 * 6,
+                  "DoP64: 1ms buffers of 176 frames");
+    static_assert(pcmLayout(352800, 2, 3, true, 1500).bytesPerBuffer == 248 * 6,
+                  "DoP128 at MTU 1500: 248 frames (249 rounded down to even)");
+    static_assert(pcmLayout(705600, 2, 3, true, 9000).bytesPerBuffer == 704 * 6 &&
+                  pcmLayout(705600, 2, 3, true, 9000).framesRemainder == 1600,
+                  "DoP256 1ms buffers: 704/706 frames averaging 705.6");
+
+    // Table lookup, computed on a miss (same functions, same result)
+    constexpr Layout pcm(uint32_t rate, int channels, int bytesPerSample, bool dop, uint32_t mtu) {
+        for (const Layout& l : TABLE) {
+            if (!l.dsd && l.rate == rate && l.channels == channels &&
+                l.bytesPerSample == bytesPerSample && l.dop == dop && l.mtu == mtu) {
+                return l;
+            }
+        }
+        return pcmLayout(rate, channels, bytesPerSample, dop, mtu);
+    }
+
+    constexpr Layout dsd(uint32_t byteRate, int channels, uint32_t mtu) {
+        for (const Layout& l : TABLE) {
+            if (l.dsd && l.rate == byteRate * 8 && l.channels == channels && l.mtu == mtu) {
+                return l;
+            }
+        }
+        return dsdLayout(byteRate, channels, mtu);
+    }
+}
+
 //=============================================================================
 // Transfer Mode
 //=============================================================================
 
 enum class DirettaTransferMode { FIX_AUTO, VAR_AUTO, VAR_MAX, RANDOM, AUTO };
 
+//=============================================================================
+// Worker Wait Mode
+//=============================================================================
+
+// How the sync worker waits when syncWorker() has nothing to send:
+//   SLEEP   - relative sleep_for(100µs) (legacy)
+//   ABSTIME - clock_nanosleep(TIMER_ABSTIME) on a cycle-aligned grid
+//   TIMERFD - periodic timerfd armed on the same grid
+enum class DirettaWorkerWait { SLEEP, ABSTIME, TIMERFD };
+
 //=============================================================================
 // Configuration
 //=============================================================================
@@ -335,6 +592,19 @@ struct DirettaConfig {
     unsigned int dacStabilizationMs = DirettaBuffer::DAC_STABILIZATION_MS;
     unsigned int onlineWaitMs = DirettaBuffer::ONLINE_WAIT_MS;
     unsigned int formatSwitchDelayMs = DirettaBuffer::FORMAT_SWITCH_DELAY_MS;
+    DirettaWorkerWait workerWait = DirettaWorkerWait::SLEEP;
+    bool convertOnPop = false;  // PCM: ring stores source samples, getNewStream() converts
+    bool constantWorkConsumer = false;  // getNewStream() does the same copy for audio and silence
+
+    // Bit-perfect verification tap (diagnostic, off by default)
+    bool bitPerfectVerify = false;
+    std::string tapDumpPath;  // Raw wire dump file (empty = none), implies verify
+
+    // Track/position markers released when the marked bytes reach the SDK
+    bool wireMarkers = false;
+
+    // Persisted target/MTU/capabilities file (empty = always discover + measure)
+    std::string targetCachePath;
 
     // CPU affinity (empty = no pinning). Accepts comma-separated cores: "6" or "6,7,8"
     std::string cpuAudio;
@@ -414,6 +684,14 @@ public:
     void pausePlayback();
     void resumePlayback();
 
+    /**
+     * @brief Drop buffered audio after a seek and refill with a short prefill
+     * @param requestedAt When the seek was requested (latency statistics)
+     *
+     * Call from the sendAudio thread, before the first audio of the new position.
+     */
+    void flushForSeek(std::chrono::steady_clock::time_point requestedAt);
+
     /**
      * @brief Send silence buffers before format transition
      *
@@ -449,6 +727,82 @@ public:
      */
     void dumpStats() const;
 
+    /**
+     * @brief Worker wake-up error, measured against the intended deadline
+     *
+     * Lets the legacy sleep loop and the deadline-based loops be compared
+     * on the same machine. Reset each time the worker thread starts.
+     */
+    struct WorkerWakeStats {
+        uint64_t wakeups = 0;
+        uint64_t lateWakeups = 0;     // Error above DirettaWorker::LATE_WAKE_NS
+        int64_t meanErrorNs = 0;
+        int64_t maxErrorNs = 0;
+        unsigned int pollPeriodUs = 0;
+        DirettaWorkerWait mode = DirettaWorkerWait::SLEEP;
+    };
+    WorkerWakeStats getWorkerWakeStats() const;
+
+    /**
+     * @brief getNewStream() execution time (every callback, audio or silence)
+     */
+    struct CallbackTimeStats {
+        uint64_t callbacks = 0;
+        double meanNs = 0.0;
+        double stddevNs = 0.0;
+        double cv = 0.0;              // stddev / mean
+        int64_t maxNs = 0;
+        bool constantWork = false;
+    };
+    CallbackTimeStats getCallbackTimeStats() const;
+
+    /**
+     * @brief Seek latency: request until the ring is refilled with the new position
+     */
+    struct SeekStats {
+        uint64_t seeks = 0;
+        double lastMs = 0.0;
+        double maxMs = 0.0;
+    };
+    SeekStats getSeekStats() const;
+
+    /**
+     * @brief Sample the consumer clock and refresh the drift estimate
+     *
+     * Call periodically from the producer thread (cheap when no new point is
+     * due). Returns the latest estimate, also available via getClockDrift().
+     */
+    ClockDriftEstimator::Estimate updateClockDrift();
+    ClockDriftEstimator::Estimate getClockDrift() const;
+
+    /**
+     * @brief Gapless track boundary for per-track bit-perfect reports
+     *
+     * Any thread; applied by sendAudio() at the next push. No-op unless
+     * the verification tap is enabled.
+     */
+    void markTrackBoundary() {
+        m_tapTrackMarks.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Handler for wire markers (set before enable(); dispatcher thread)
+     */
+    void setWireMarkerHandler(WireMarkers::Handler handler) {
+        m_wireMarkerHandler = std::move(handler);
+    }
+
+    /**
+     * @brief Attach a track/position marker to the next audio pushed
+     *
+     * Call from the sendAudio thread, right before sendAudio(). The handler
+     * receives it once that audio is handed to the SDK. No-op unless
+     * DirettaConfig::wireMarkers is set.
+     */
+    bool markWire(WireMarkers::Kind kind, uint32_t track, uint64_t frame, uint32_t sampleRate);
+    bool wireMarkersEnabled() const { return m_wireMarkers.enabled(); }
+    WireMarkers::Stats getWireMarkerStats() const { return m_wireMarkers.getStats(); }
+
     /**
      * @brief Set S24 pack mode hint for 24-bit audio
      *
@@ -518,6 +872,8 @@ private:
 
     bool discoverTarget(std::atomic<bool>* stopSignal = nullptr);
     bool measureMTU();
+    bool findCachedTarget(const TargetCache& cache);
+    void saveTargetCache();
     bool openSyncConnection();
     bool openSDK();  // Helper: calls DIRETTA::Sync::open() with config params
     bool reopenForFormatChange();
@@ -537,6 +893,8 @@ private:
     void requestShutdownSilence(int buffers);
     bool waitForOnline(unsigned int timeoutMs);
     void logSinkCapabilities();
+    void recordWakeError(int64_t errorNs);
+    void tapInput(const uint8_t* data, size_t consumed, size_t totalBytes);
 
     class ReconfigureGuard {
     public:
@@ -560,7 +918,10 @@ private:
     ACQUA::IPAddress m_targetAddress;
     int m_targetIndex = -1;
     uint32_t m_mtuOverride = 0;
+    std::string m_targetName;
+    std::string m_targetOutputName;
     uint32_t m_effectiveMTU = 1500;
+    uint32_t m_measuredMTU = 0;      // Persisted to the target cache (0 = not measured)
 
     // Connection state
     std::atomic<bool> m_enabled{false};      // Target discovered, ready to use
@@ -579,6 +940,8 @@ private:
     std::atomic<bool> m_stopRequested{false};
     std::atomic<bool> m_draining{false};
     std::atomic<bool> m_workerActive{false};
+    std::atomic<unsigned int> m_cycleTimeUs{0};   // Last cycle time passed to setSink (worker grid)
+    std::atomic<DirettaWorkerWait> m_activeWorkerWait{DirettaWorkerWait::SLEEP};
 
     // SDK 148 API: Application-managed buffer for getNewStream()
     // SDK 148 changed getNewStream(Stream&) to getNewStream(diretta_stream&)
@@ -621,6 +984,8 @@ private:
     std::atomic<int> m_bytesPerFrame{0};
     std::atomic<uint32_t> m_framesPerBufferRemainder{0};
     std::atomic<uint32_t> m_framesPerBufferAccumulator{0};
+    std::atomic<int> m_stabilizationTarget{static_cast<int>(DirettaBuffer::POST_ONLINE_SILENCE_BUFFERS)};
+    std::atomic<int> m_firstConnectStabilizationTarget{static_cast<int>(DirettaBuffer::POST_ONLINE_SILENCE_BUFFERS)};
     std::atomic<bool> m_need24BitPack{false};
     std::atomic<bool> m_need16To32Upsample{false};
     std::atomic<bool> m_need16To24Upsample{false};
@@ -631,6 +996,9 @@ private:
     std::atomic<bool> m_isLowBitrate{false};
     std::atomic<bool> m_isRemoteStream{false};  // Remote streaming source (larger buffer)
 
+    // Convert-on-pop: conversion getNewStream() applies (None = ring holds wire format)
+    std::atomic<DirettaRingBuffer::PopConversion> m_popConversion{DirettaRingBuffer::PopConversion::None};
+
     // Cached DSD conversion mode - set at track open, eliminates per-iteration branch checks
     // G2 fix: Made atomic to ensure proper visibility across threads
     std::atomic<DirettaRingBuffer::DSDConversionMode> m_dsdConversionMode{DirettaRingBuffer::DSDConversionMode::Passthrough};
@@ -647,6 +1015,7 @@ private:
     bool m_cachedPack24bit{false};
     bool m_cachedUpsample16to32{false};
     bool m_cachedUpsample16to24{false};
+    bool m_cachedConvertOnPop{false};
     int m_cachedChannels{2};
     int m_cachedBytesPerSample{2};
     DirettaRingBuffer::DSDConversionMode m_cachedDsdConversionMode{DirettaRingBuffer::DSDConversionMode::Passthrough};
@@ -665,10 +1034,18 @@ private:
     int m_cachedConsumerSampleRate{44100};
     int m_cachedBytesPerFrame{0};
     uint32_t m_cachedFramesPerBufferRemainder{0};
+    DirettaRingBuffer::PopConversion m_cachedPopConversion{DirettaRingBuffer::PopConversion::None};
+    int m_cachedStabilizationTarget{static_cast<int>(DirettaBuffer::POST_ONLINE_SILENCE_BUFFERS)};
+    int m_cachedFirstConnectStabilizationTarget{static_cast<int>(DirettaBuffer::POST_ONLINE_SILENCE_BUFFERS)};
+    bool m_cachedConstantWork{false};
+    std::vector<uint8_t> m_silencePage;  // Constant-work silence source (ring format)
 
     // Prefill and stabilization
     size_t m_prefillTarget = 0;
+    size_t m_seekPrefillTarget = 0;           // Shorter refill after flushForSeek()
     std::atomic<bool> m_prefillComplete{false};
+    std::atomic<bool> m_seekRefill{false};    // Prefill after a seek (m_seekPrefillTarget)
+    std::chrono::steady_clock::time_point m_seekRequestedAt;  // sendAudio thread only
     std::atomic<bool> m_postOnlineDelayDone{false};
     bool m_isFirstConnect = true;  // Extra stabilization on very first connect after startup
     std::atomic<int> m_silenceBuffersRemaining{0};
@@ -680,6 +1057,46 @@ private:
     std::atomic<int> m_popCount{0};
     std::atomic<uint32_t> m_underrunCount{0};
     std::atomic<bool> m_rebuffering{false};              // Rebuffering after sustained underrun
+
+    // Worker wake-up error (written by worker thread only)
+    std::atomic<uint64_t> m_wakeCount{0};
+    std::atomic<uint64_t> m_wakeLateCount{0};
+    std::atomic<int64_t> m_wakeErrorSumNs{0};
+    std::atomic<int64_t> m_wakeErrorMaxNs{0};
+
+    // Seek latency (written by the sendAudio thread)
+    std::atomic<uint64_t> m_seekCount{0};
+    std::atomic<int64_t> m_seekLastUs{0};
+    std::atomic<int64_t> m_seekMaxUs{0};
+
+    // Callback execution time (written by worker thread in getNewStream)
+    std::atomic<uint64_t> m_callbackCount{0};
+    std::atomic<int64_t> m_callbackSumNs{0};
+    std::atomic<double> m_callbackSumSqNs{0.0};
+    std::atomic<int64_t> m_callbackMaxNs{0};
+
+    // Target clock sampling (seqlock: written by worker thread in getNewStream)
+    std::atomic<uint32_t> m_clockSeq{0};
+    std::atomic<uint64_t> m_clockBytes{0};
+    std::atomic<int64_t> m_clockLastNs{0};
+
+    // Drift estimation (driven by producer thread via updateClockDrift)
+    ClockDriftEstimator m_drift;
+    uint32_t m_driftConsumerGen{0};
+    uint32_t m_driftClearCount{0};
+    mutable std::mutex m_driftMutex;
+    ClockDriftEstimator::Estimate m_driftEstimate;
+
+    // Bit-perfect verification tap (input side state owned by sendAudio thread)
+    BitPerfectTap m_tap;
+    uint32_t m_tapFormatGen{0};
+    uint32_t m_tapClearCount{0};
+    uint32_t m_tapTrackMarksSeen{0};
+    std::atomic<uint32_t> m_tapTrackMarks{0};
+
+    // Wire markers (producer: sendAudio thread, consumer: getNewStream)
+    WireMarkers m_wireMarkers;
+    WireMarkers::Handler m_wireMarkerHandler;
 };
 
 #endif // DIRETTA_SYNC_H
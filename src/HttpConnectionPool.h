@@ -0,0 +1,681 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file HttpConnectionPool.h
+ * @brief Keep-alive HTTP connections shared by every decoder, per media server
+ *
+ * FFmpeg's HTTP protocol keeps a connection alive only inside one
+ * AVIOContext, so each track, each gapless preload and each reopen used to
+ * pay a TCP connect and a fresh request/response round trip to the same
+ * server. PooledHttpStream is a minimal HTTP/1.1 range reader for plain
+ * http:// sources whose socket goes back to the HttpConnectionPool once a
+ * body has been read to the end; the next request to that host (next track,
+ * preload, seek) reuses it.
+ *
+ * The pool also caps concurrent connections per host (current track +
+ * preload by default), which keeps UPnP servers that serialise or throttle
+ * parallel requests from stalling the playing track. A stream holds one of
+ * its host's slots from its first request until its body is fully read or
+ * it is closed.
+ *
+ * Anything unusual (https, redirects, chunked bodies, error statuses, user
+ * info in the URL) makes PooledHttpStream::open() fail, and AudioDecoder
+ * falls back to FFmpeg's HTTP client, which handles all of it.
+ *
+ * Streams are used by one thread at a time (the read-ahead reader thread);
+ * the pool itself is thread-safe and must outlive every stream.
+ */
+
+#ifndef HTTP_CONNECTION_POOL_H
+#define HTTP_CONNECTION_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class HttpConnectionPool {
+public:
+    static constexpr int DEFAULT_MAX_PER_HOST = 2;   // Current track + preload
+    static constexpr int IDLE_TIMEOUT_S = 15;        // Below common server keep-alive timeouts
+    static constexpr int SLOT_WAIT_MS = 10000;       // Then the caller falls back to FFmpeg
+    static constexpr int IO_TIMEOUT_MS = 30000;      // Same as the local-server FFmpeg timeout
+    static constexpr int WAIT_SLICE_MS = 20;         // Abort-callback poll interval
+
+    using AbortCallback = int (*)(void* opaque);     // Non-zero = abort (FFmpeg style)
+
+    struct Stats {
+        uint64_t connects = 0;         // New TCP connections
+        uint64_t reuses = 0;           // Requests sent on a kept-alive connection
+        uint64_t waits = 0;            // Slot acquisitions that had to wait
+        size_t idle = 0;               // Connections currently parked
+    };
+
+    explicit HttpConnectionPool(int maxPerHost = DEFAULT_MAX_PER_HOST)
+        : m_maxPerHost(std::max(1, maxPerHost)) {}
+
+    ~HttpConnectionPool() {
+        for (auto& host : m_idle) {
+            for (const Idle& c : host.second) ::close(c.fd);
+        }
+    }
+
+    HttpConnectionPool(const HttpConnectionPool&) = delete;
+    HttpConnectionPool& operator=(const HttpConnectionPool&) = delete;
+
+    int maxPerHost() const { return m_maxPerHost; }
+
+    /**
+     * @brief Take one of @p key's connection slots, waiting while all are in use
+     * @return false on abort or after SLOT_WAIT_MS
+     */
+    bool acquireSlot(const std::string& key, AbortCallback abort = nullptr, void* opaque = nullptr) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        int& active = m_active[key];
+        if (active >= m_maxPerHost) {
+            m_waits.fetch_add(1, std::memory_order_relaxed);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SLOT_WAIT_MS);
+            while (active >= m_maxPerHost) {
+                m_slotCv.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS));
+                if ((abort && abort(opaque)) || std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+            }
+        }
+        active++;
+        return true;
+    }
+
+    /** @brief acquireSlot() without waiting */
+    bool tryAcquireSlot(const std::string& key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int& active = m_active[key];
+        if (active >= m_maxPerHost) return false;
+        active++;
+        return true;
+    }
+
+    void releaseSlot(const std::string& key) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_active.find(key);
+            if (it != m_active.end() && it->second > 0) it->second--;
+        }
+        m_slotCv.notify_all();
+    }
+
+    /** @brief Most recently parked live connection to @p key, or -1 */
+    int takeIdle(const std::string& key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_idle.find(key);
+        if (it == m_idle.end()) return -1;
+        auto now = std::chrono::steady_clock::now();
+        std::deque<Idle>& list = it->second;
+        while (!list.empty()) {
+            Idle c = list.back();
+            list.pop_back();
+            if (now - c.since < std::chrono::seconds(IDLE_TIMEOUT_S) && idleAlive(c.fd)) {
+                m_reuses.fetch_add(1, std::memory_order_relaxed);
+                m_idleCount.fetch_sub(1, std::memory_order_relaxed);
+                return c.fd;
+            }
+            ::close(c.fd);
+            m_idleCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return -1;
+    }
+
+    /** @brief Park @p fd (between responses, nothing unread) for the next request to @p key */
+    void putIdle(const std::string& key, int fd) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::deque<Idle>& list = m_idle[key];
+        list.push_back({fd, std::chrono::steady_clock::now()});
+        m_idleCount.fetch_add(1, std::memory_order_relaxed);
+        while (list.size() > static_cast<size_t>(m_maxPerHost)) {
+            ::close(list.front().fd);
+            list.pop_front();
+            m_idleCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief New non-blocking TCP connection to @p host : @p port
+     * @return Socket, or -errno
+     */
+    int connect(const std::string& host, const std::string& port,
+                AbortCallback abort = nullptr, void* opaque = nullptr) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res) return -EHOSTUNREACH;
+
+        int err = -ECONNREFUSED;
+        for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+            int fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+            if (fd < 0) continue;
+            err = (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) ? 0 : -errno;
+            if (err == -EINPROGRESS) {
+                err = waitFd(fd, POLLOUT, abort, opaque);
+                if (err == 0) err = socketError(fd);
+            }
+            if (err == 0) {
+                freeaddrinfo(res);
+                m_connects.fetch_add(1, std::memory_order_relaxed);
+                return fd;
+            }
+            ::close(fd);
+            if (err == -EINTR) break;   // Aborted: don't try the next address
+        }
+        freeaddrinfo(res);
+        return err;
+    }
+
+    Stats getStats() const {
+        Stats s;
+        s.connects = m_connects.load(std::memory_order_relaxed);
+        s.reuses = m_reuses.load(std::memory_order_relaxed);
+        s.waits = m_waits.load(std::memory_order_relaxed);
+        s.idle = m_idleCount.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief Wait until @p fd is ready for @p events
+     * @return 0, -EINTR on abort, -ETIMEDOUT after IO_TIMEOUT_MS, or -errno
+     */
+    static int waitFd(int fd, short events, AbortCallback abort, void* opaque) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(IO_TIMEOUT_MS);
+        while (true) {
+            pollfd p{fd, events, 0};
+            int r = ::poll(&p, 1, WAIT_SLICE_MS);
+            if (r > 0) return 0;   // Errors and hangups surface in the following send/recv
+            if (r < 0 && errno != EINTR) return -errno;
+            if (abort && abort(opaque)) return -EINTR;
+            if (std::chrono::steady_clock::now() >= deadline) return -ETIMEDOUT;
+        }
+    }
+
+private:
+    struct Idle {
+        int fd;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    static int socketError(int fd) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0) return -errno;
+        return -err;
+    }
+
+    // A parked connection has nothing to read: readable means the server closed it
+    static bool idleAlive(int fd) {
+        pollfd p{fd, POLLIN, 0};
+        return ::poll(&p, 1, 0) == 0;
+    }
+
+    const int m_maxPerHost;
+
+    std::mutex m_mutex;
+    std::condition_variable m_slotCv;
+    std::map<std::string, int> m_active;               // Slots in use per host
+    std::map<std::string, std::deque<Idle>> m_idle;    // Oldest first
+
+    // Atomics: read by DirettaRenderer::dumpStats()
+    std::atomic<uint64_t> m_connects{0};
+    std::atomic<uint64_t> m_reuses{0};
+    std::atomic<uint64_t> m_waits{0};
+    std::atomic<size_t> m_idleCount{0};
+};
+
+/**
+ * @brief Seekable HTTP/1.1 GET of one URL over pooled connections
+ *
+ * Every request asks for "Range: bytes=pos-" ("pos-end" after a bounded
+ * open()), so a seek is a new request on the same (or a pooled)
+ * connection. read()/seek() follow HttpReadAhead's ReadFn/SeekFn
+ * conventions; errors are -errno.
+ */
+class PooledHttpStream {
+public:
+    static constexpr size_t BUF_SIZE = 65536;
+    static constexpr size_t MAX_HEADER_BYTES = 16384;
+    static constexpr int64_t SKIP_BYTES = 262144;   // Forward seeks up to this read through
+    static constexpr int64_t DRAIN_BYTES = 65536;   // Body left that is drained to keep the connection
+
+    using AbortCallback = HttpConnectionPool::AbortCallback;
+
+    explicit PooledHttpStream(HttpConnectionPool& pool, AbortCallback abort = nullptr, void* opaque = nullptr)
+        : m_pool(pool), m_abort(abort), m_opaque(opaque), m_buf(BUF_SIZE) {}
+
+    ~PooledHttpStream() { close(); }
+
+    PooledHttpStream(const PooledHttpStream&) = delete;
+    PooledHttpStream& operator=(const PooledHttpStream&) = delete;
+
+    /**
+     * @brief Request @p url from byte @p start and read the response headers
+     * @param end Last byte of a bounded range (read() then ends there), -1 = to the end
+     * @return 0, or -errno (-EPROTONOSUPPORT: not something we handle; use FFmpeg)
+     */
+    int open(const std::string& url, int64_t start = 0, int64_t end = -1) {
+        close();
+        if (!parseUrl(url)) return -EPROTONOSUPPORT;
+        m_pos = start;
+        m_rangeEnd = end;
+        m_size = -1;
+        m_seekable = false;
+        return request(start);
+    }
+
+    /** @brief Fail with -EBUSY instead of waiting when the host's slots are taken */
+    void setSlotWait(bool wait) { m_slotWait = wait; }
+
+    void close() {
+        dropConnection();
+        releaseSlot();
+    }
+
+    /** @brief Source size from Content-Length / Content-Range, -1 = unknown */
+    int64_t size() const { return m_size; }
+
+    /** @brief Server honours byte ranges */
+    bool seekable() const { return m_seekable; }
+
+    /** @brief The current response came over a reused connection */
+    bool reused() const { return m_reused; }
+
+    const std::string& hostKey() const { return m_key; }
+
+    int read(uint8_t* dst, int size) {
+        if (size <= 0) return 0;
+        if (m_fd < 0) {
+            if ((m_size >= 0 && m_pos >= m_size) || (m_rangeEnd >= 0 && m_pos > m_rangeEnd)) return 0;
+            int ret = request(m_pos);
+            if (ret < 0) return ret;
+        }
+        if (m_remaining == 0) {
+            finishBody();
+            return 0;
+        }
+
+        size_t want = static_cast<size_t>(size);
+        if (m_remaining > 0) want = std::min(want, static_cast<size_t>(m_remaining));
+        int n = receive(dst, want);
+        if (n == 0 && m_remaining < 0) {
+            // Body delimited by connection close
+            dropConnection();
+            releaseSlot();
+            if (m_size < 0) m_size = m_pos;
+            return 0;
+        }
+        if (n <= 0 && n != -EINTR && m_seekable) {
+            // Connection lost mid-body: pick up where it stopped, once
+            dropConnection();
+            int ret = request(m_pos);
+            if (ret < 0) return ret;
+            n = receive(dst, want);
+        }
+        if (n == 0) return -ECONNRESET;
+        if (n < 0) return n;
+
+        m_pos += n;
+        if (m_remaining > 0) {
+            m_remaining -= n;
+            if (m_remaining == 0) finishBody();
+        }
+        return n;
+    }
+
+    int64_t seek(int64_t pos) {
+        if (pos < 0) return -EINVAL;
+        if (pos == m_pos) return pos;
+        if (!m_seekable) return -ESPIPE;
+
+        // Short forward skip: cheaper to read through than to issue a new request
+        if (m_fd >= 0 && pos > m_pos && pos - m_pos <= SKIP_BYTES) {
+            uint8_t scratch[4096];
+            while (m_pos < pos) {
+                int n = read(scratch, static_cast<int>(std::min<int64_t>(sizeof(scratch), pos - m_pos)));
+                if (n <= 0) break;
+            }
+            if (m_pos == pos) return pos;
+        }
+
+        abandonBody();
+        m_pos = pos;
+        if (m_size >= 0 && pos >= m_size) {
+            releaseSlot();
+            return pos;   // At or past the end: read() returns EOF
+        }
+        int ret = request(pos);
+        return ret < 0 ? ret : pos;
+    }
+
+    struct Response {
+        int status = 0;
+        int64_t contentLength = -1;
+        int64_t rangeStart = -1;
+        int64_t totalSize = -1;
+        bool keepAlive = false;
+        bool chunked = false;
+        bool acceptRanges = false;
+    };
+
+    /**
+     * @brief Parse a response header block (status line and fields, CRLF-separated)
+     * @return false if @p head does not start with an HTTP/1.x status line
+     */
+    static bool parseResponse(const std::string& head, Response& r) {
+        size_t eol = head.find("\r\n");
+        std::string status = head.substr(0, eol);
+        if (status.compare(0, 7, "HTTP/1.") != 0 || status.size() < 12) return false;
+        r.keepAlive = status[7] == '1';   // HTTP/1.1 default; 1.0 needs "Connection: keep-alive"
+        r.status = std::atoi(status.c_str() + 9);
+
+        size_t pos = (eol == std::string::npos) ? head.size() : eol + 2;
+        while (pos < head.size()) {
+            size_t end = head.find("\r\n", pos);
+            if (end == std::string::npos) end = head.size();
+            size_t colon = head.find(':', pos);
+            if (colon != std::string::npos && colon < end) {
+                std::string name = lower(head.substr(pos, colon - pos));
+                size_t v = head.find_first_not_of(" \t", colon + 1);
+                std::string value = (v != std::string::npos && v < end) ? head.substr(v, end - v) : "";
+                std::string lv = lower(value);
+                if (name == "content-length") {
+                    r.contentLength = std::strtoll(value.c_str(), nullptr, 10);
+                } else if (name == "content-range") {
+                    // "bytes start-end/total" (total may be "*")
+                    if (lv.compare(0, 6, "bytes ") == 0) {
+                        r.rangeStart = std::strtoll(value.c_str() + 6, nullptr, 10);
+                        size_t slash = value.find('/');
+                        if (slash != std::string::npos && value[slash + 1] != '*') {
+                            r.totalSize = std::strtoll(value.c_str() + slash + 1, nullptr, 10);
+                        }
+                    }
+                } else if (name == "connection") {
+                    if (lv.find("close") != std::string::npos) r.keepAlive = false;
+                    else if (lv.find("keep-alive") != std::string::npos) r.keepAlive = true;
+                } else if (name == "transfer-encoding") {
+                    r.chunked = lv.find("chunked") != std::string::npos;
+                } else if (name == "accept-ranges") {
+                    r.acceptRanges = lv.find("bytes") != std::string::npos;
+                }
+            }
+            pos = end + 2;
+        }
+        return r.status >= 100;
+    }
+
+private:
+    static std::string lower(std::string s) {
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+        return s;
+    }
+
+    bool parseUrl(const std::string& url) {
+        if (url.compare(0, 7, "http://") != 0) return false;
+        size_t start = 7;
+        size_t end = url.find_first_of("/?#", start);
+        std::string authority = url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (authority.empty() || authority.find('@') != std::string::npos) return false;
+
+        m_hostHeader = authority;
+        m_port = "80";
+        if (authority[0] == '[') {   // IPv6 literal
+            size_t close = authority.find(']');
+            if (close == std::string::npos) return false;
+            m_host = authority.substr(1, close - 1);
+            if (close + 1 < authority.size()) {
+                if (authority[close + 1] != ':') return false;
+                m_port = authority.substr(close + 2);
+            }
+        } else {
+            size_t colon = authority.rfind(':');
+            m_host = authority.substr(0, colon);
+            if (colon != std::string::npos) m_port = authority.substr(colon + 1);
+        }
+        if (m_host.empty() || m_port.empty() ||
+            m_port.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+
+        m_path = (end == std::string::npos) ? "/" : url.substr(end);
+        size_t hash = m_path.find('#');
+        if (hash != std::string::npos) m_path.resize(hash);
+        if (m_path.empty() || m_path[0] != '/') m_path.insert(0, "/");
+        m_key = m_host + ":" + m_port;
+        return true;
+    }
+
+    // Send the GET for @p pos and consume the response headers
+    int request(int64_t pos) {
+        for (int attempt = 0; attempt < 2; attempt++) {
+            if (!m_haveSlot) {
+                bool slot = m_slotWait ? m_pool.acquireSlot(m_key, m_abort, m_opaque)
+                                       : m_pool.tryAcquireSlot(m_key);
+                if (!slot) return -EBUSY;
+                m_haveSlot = true;
+            }
+            m_fd = (attempt == 0) ? m_pool.takeIdle(m_key) : -1;
+            m_reused = m_fd >= 0;
+            if (m_fd < 0) {
+                m_fd = m_pool.connect(m_host, m_port, m_abort, m_opaque);
+                if (m_fd < 0) {
+                    int err = m_fd;
+                    m_fd = -1;
+                    releaseSlot();
+                    return err;
+                }
+            }
+            m_bufPos = m_bufLen = 0;
+
+            bool transport = true;   // Failure could be a parked connection the server dropped
+            int ret = sendRequest(pos);
+            if (ret == 0) ret = readHeaders(pos, transport);
+            if (ret == 0) return 0;
+            dropConnection();
+            if (!m_reused || !transport || ret == -EINTR) {
+                releaseSlot();
+                return ret;
+            }
+        }
+        releaseSlot();
+        return -ECONNRESET;
+    }
+
+    int sendRequest(int64_t pos) {
+        std::string req = "GET " + m_path + " HTTP/1.1\r\n"
+                          "Host: " + m_hostHeader + "\r\n"
+                          "User-Agent: DirettaRenderer/1.0\r\n"
+                          "Accept: */*\r\n"
+                          "Range: bytes=" + std::to_string(pos) + "-" +
+                          (m_rangeEnd >= 0 ? std::to_string(m_rangeEnd) : "") + "\r\n"
+                          "Connection: keep-alive\r\n\r\n";
+        size_t sent = 0;
+        while (sent < req.size()) {
+            ssize_t n = ::send(m_fd, req.data() + sent, req.size() - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                int ret = HttpConnectionPool::waitFd(m_fd, POLLOUT, m_abort, m_opaque);
+                if (ret < 0) return ret;
+            } else if (n < 0 && errno != EINTR) {
+                return -errno;
+            }
+        }
+        return 0;
+    }
+
+    int readHeaders(int64_t pos, bool& transport) {
+        std::string head;
+        size_t end;
+        while ((end = head.find("\r\n\r\n")) == std::string::npos) {
+            if (head.size() > MAX_HEADER_BYTES) {
+                transport = false;
+                return -EPROTO;
+            }
+            int ret = fill();
+            if (ret <= 0) return ret == 0 ? -ECONNRESET : ret;
+            head.append(reinterpret_cast<const char*>(m_buf.data()), m_bufLen);
+            m_bufLen = 0;
+        }
+        transport = false;
+
+        // Body bytes that arrived with the headers stay buffered
+        size_t bodyStart = end + 4;
+        size_t extra = head.size() - bodyStart;
+        std::memcpy(m_buf.data(), head.data() + bodyStart, extra);
+        m_bufPos = 0;
+        m_bufLen = extra;
+        head.resize(end + 2);
+
+        Response r;
+        if (!parseResponse(head, r) || r.chunked) return -EPROTONOSUPPORT;
+        if (r.status == 416 && m_size >= 0 && pos >= m_size) {
+            m_keepAlive = false;
+            m_remaining = 0;   // Range past the end: EOF
+            return 0;
+        }
+        if (r.status == 200) {
+            if (pos != 0 || m_rangeEnd >= 0) return -ESPIPE;   // Range ignored
+            m_seekable = r.acceptRanges;
+            if (r.contentLength >= 0) m_size = r.contentLength;
+        } else if (r.status == 206) {
+            if (r.rangeStart != pos) return -EPROTO;
+            m_seekable = true;
+            if (r.totalSize >= 0) m_size = r.totalSize;
+        } else {
+            return -EPROTONOSUPPORT;   // Redirects, errors: FFmpeg reports or follows them
+        }
+        m_remaining = r.contentLength;
+        m_keepAlive = r.keepAlive && r.contentLength >= 0;
+        return 0;
+    }
+
+    // Refill m_buf from the socket: bytes read, 0 on close, or -errno
+    int fill() {
+        while (true) {
+            ssize_t n = ::recv(m_fd, m_buf.data(), m_buf.size(), MSG_DONTWAIT);
+            if (n >= 0) {
+                m_bufPos = 0;
+                m_bufLen = static_cast<size_t>(n);
+                return static_cast<int>(n);
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                int ret = HttpConnectionPool::waitFd(m_fd, POLLIN, m_abort, m_opaque);
+                if (ret < 0) return ret;
+            } else if (errno != EINTR) {
+                return -errno;
+            }
+        }
+    }
+
+    // Body bytes: buffered ones first, large reads straight from the socket
+    int receive(uint8_t* dst, size_t want) {
+        if (m_bufPos < m_bufLen) {
+            size_t n = std::min(want, m_bufLen - m_bufPos);
+            std::memcpy(dst, m_buf.data() + m_bufPos, n);
+            m_bufPos += n;
+            return static_cast<int>(n);
+        }
+        if (want < m_buf.size()) {
+            int ret = fill();
+            if (ret <= 0) return ret;
+            return receive(dst, want);
+        }
+        while (true) {
+            ssize_t n = ::recv(m_fd, dst, want, MSG_DONTWAIT);
+            if (n >= 0) return static_cast<int>(n);
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                int ret = HttpConnectionPool::waitFd(m_fd, POLLIN, m_abort, m_opaque);
+                if (ret < 0) return ret;
+            } else if (errno != EINTR) {
+                return -errno;
+            }
+        }
+    }
+
+    // Body read to the end: connection goes back to the pool, slot is freed
+    void finishBody() {
+        if (m_fd >= 0) {
+            if (m_keepAlive && m_bufPos == m_bufLen) m_pool.putIdle(m_key, m_fd);
+            else ::close(m_fd);
+            m_fd = -1;
+        }
+        releaseSlot();
+    }
+
+    // Leaving a response early: drain a short remainder to keep the connection
+    void abandonBody() {
+        if (m_fd < 0) return;
+        if (m_keepAlive && m_remaining > 0 && m_remaining <= DRAIN_BYTES) {
+            uint8_t scratch[4096];
+            int64_t savedPos = m_pos;
+            while (m_fd >= 0 && m_remaining > 0) {
+                if (read(scratch, static_cast<int>(sizeof(scratch))) <= 0) break;
+            }
+            m_pos = savedPos;
+            if (m_fd < 0) return;   // Parked by finishBody(): the next request takes it back
+        }
+        dropConnection();
+    }
+
+    void dropConnection() {
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+        m_bufPos = m_bufLen = 0;
+    }
+
+    void releaseSlot() {
+        if (!m_haveSlot) return;
+        m_haveSlot = false;
+        m_pool.releaseSlot(m_key);
+    }
+
+    HttpConnectionPool& m_pool;
+    AbortCallback m_abort;
+    void* m_opaque;
+
+    std::string m_host;
+    std::string m_port;
+    std::string m_hostHeader;
+    std::string m_path;
+    std::string m_key;
+
+    int m_fd = -1;
+    bool m_haveSlot = false;
+    bool m_slotWait = true;
+    bool m_reused = false;
+    bool m_keepAlive = false;
+    bool m_seekable = false;
+    int64_t m_pos = 0;             // Source position of the next body byte
+    int64_t m_size = -1;
+    int64_t m_remaining = -1;      // Body bytes left in the current response, -1 = until close
+    int64_t m_rangeEnd = -1;       // Last byte requested, -1 = open-ended
+
+    std::vector<uint8_t> m_buf;
+    size_t m_bufPos = 0;
+    size_t m_bufLen = 0;
+};
+
+#endif // HTTP_CONNECTION_POOL_H
@@ -0,0 +1,350 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file HttpReadAhead.h
+ * @brief Network read-ahead ring filled by a dedicated reader thread
+ *
+ * The reader thread pulls the source (an FFmpeg HTTP AVIOContext in
+ * AudioDecoder) in CHUNK_SIZE reads and keeps a multi-megabyte ring full.
+ * The decoder reads from the ring through a custom AVIOContext, so a slow
+ * or jittery network only shows up as a shrinking fill level instead of
+ * blocking av_read_frame() in the audio thread.
+ *
+ * Seeks inside the buffered window (including capacity/8 bytes already
+ * read, for demuxer rewinds) and short forward skips are served from the
+ * ring; anything else repositions the source on the reader thread.
+ *
+ * With retainAll the ring never overwrites: sized to the whole source it
+ * becomes an in-memory copy (memory play), and every seek is served from it.
+ * Readers of such a copy each take a Cursor, so two decoders of the same
+ * track (repeat-one: current and gapless next) do not move each other.
+ *
+ * The source callbacks are only ever called from the reader thread.
+ */
+
+#ifndef HTTP_READ_AHEAD_H
+#define HTTP_READ_AHEAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class HttpReadAhead {
+public:
+    static constexpr size_t CHUNK_SIZE = 65536;        // Source read size
+    static constexpr size_t MIN_CAPACITY = 4 * CHUNK_SIZE;
+    static constexpr int WAIT_SLICE_MS = 20;           // Abort-callback poll interval
+    static constexpr int ABORTED = INT_MIN;            // read()/seek(): abort callback fired
+
+    using ReadFn = std::function<int(uint8_t* buf, int size)>;  // >0 bytes, 0 EOF, <0 error
+    using SeekFn = std::function<int64_t(int64_t pos)>;         // New position, <0 error
+    using AbortCallback = int (*)(void* opaque);                // Non-zero = abort (FFmpeg style)
+
+    struct Stats {
+        uint64_t bytesIn = 0;          // Read from the source
+        uint64_t bytesOut = 0;         // Delivered to the decoder
+        uint64_t stalls = 0;           // Decoder reads that found the ring empty
+        int64_t stallNs = 0;           // Time spent waiting in those reads
+        int64_t sourceNs = 0;          // Time spent in source reads (throughput basis)
+        uint64_t seeks = 0;
+        uint64_t seeksInBuffer = 0;    // Served without touching the source
+        size_t capacity = 0;
+        size_t buffered = 0;           // Current fill (unread bytes)
+    };
+
+    /**
+     * @brief Independent read position over a retainAll ring
+     *
+     * read()/seek()/position() behave like the ring's own, without touching
+     * the ring's read position. Must not outlive the ring.
+     */
+    class Cursor {
+    public:
+        explicit Cursor(HttpReadAhead& ring) : m_ring(ring), m_pos(ring.startPosition()) {}
+
+        /** @return Bytes read, 0 at end of stream, source error (<0), or ABORTED */
+        int read(uint8_t* dst, int size, AbortCallback abort = nullptr, void* opaque = nullptr) {
+            int n = m_ring.readAt(m_pos, dst, size, abort, opaque);
+            if (n > 0) m_pos += n;
+            return n;
+        }
+
+        /** @brief Everything is retained: only moves the cursor, reads wait for the download */
+        int64_t seek(int64_t pos) {
+            if (pos < m_ring.startPosition()) return -EINVAL;
+            m_pos = pos;
+            return pos;
+        }
+
+        int64_t position() const { return m_pos; }
+
+    private:
+        HttpReadAhead& m_ring;
+        int64_t m_pos;
+    };
+
+    explicit HttpReadAhead(size_t capacity, bool retainAll = false)
+        : m_capacity(std::max(capacity, MIN_CAPACITY))
+        , m_keepBehind(retainAll ? m_capacity : m_capacity / 8)
+        , m_buffer(m_capacity) {}
+
+    ~HttpReadAhead() { stop(); }
+
+    HttpReadAhead(const HttpReadAhead&) = delete;
+    HttpReadAhead& operator=(const HttpReadAhead&) = delete;
+
+    /** @brief Start the reader thread at source position @p startPos */
+    void start(ReadFn read, SeekFn seek, int64_t startPos = 0) {
+        if (m_thread.joinable()) return;
+        m_read = std::move(read);
+        m_seek = std::move(seek);
+        m_basePos = m_readPos = m_writePos = m_fillEnd = startPos;
+        m_stop.store(false, std::memory_order_release);
+        m_thread = std::thread([this]() { readerLoop(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop.store(true, std::memory_order_release);
+        }
+        m_spaceCv.notify_all();
+        m_dataCv.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    /** @brief True once stop() was called (interrupts a blocking source read) */
+    bool stopping() const { return m_stop.load(std::memory_order_acquire); }
+
+    //=========================================================================
+    // Decoder side
+    //=========================================================================
+
+    /**
+     * @brief Read up to @p size bytes, waiting for the reader thread if empty
+     * @return Bytes read, 0 at end of stream, source error (<0), or ABORTED
+     */
+    int read(uint8_t* dst, int size, AbortCallback abort = nullptr, void* opaque = nullptr) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_writePos == m_readPos && !m_eof && m_error == 0 && !m_stop) {
+            auto waitStart = std::chrono::steady_clock::now();
+            while (m_writePos == m_readPos && !m_eof && m_error == 0 && !m_stop) {
+                m_dataCv.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS));
+                if (abort && abort(opaque)) return ABORTED;
+            }
+            // Waiting for the first bytes after start/seek is expected, not a stall
+            if (m_primed) {
+                m_stats.stalls++;
+                m_stats.stallNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - waitStart).count();
+            }
+        }
+        if (m_stop) return ABORTED;
+
+        size_t avail = static_cast<size_t>(m_writePos - m_readPos);
+        if (avail == 0) return m_error != 0 ? m_error : 0;
+
+        size_t n = std::min(avail, static_cast<size_t>(size));
+        copyOutLocked(m_readPos, dst, n);
+
+        m_readPos += static_cast<int64_t>(n);
+        m_stats.bytesOut += n;
+        m_primed = true;
+        lock.unlock();
+        m_spaceCv.notify_one();
+        return static_cast<int>(n);
+    }
+
+    /**
+     * @brief Move the read position to absolute byte @p pos
+     * @return New position, source error (<0), or ABORTED
+     */
+    int64_t seek(int64_t pos, AbortCallback abort = nullptr, void* opaque = nullptr) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stats.seeks++;
+
+        // Forward skip past the fill: wait for the reader rather than reconnect,
+        // as long as the reader can get there without overwriting kept data
+        while (pos > m_writePos && pos + static_cast<int64_t>(CHUNK_SIZE) <= writeLimitLocked() &&
+               !m_eof && m_error == 0 && !m_stop) {
+            m_dataCv.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS));
+            if (abort && abort(opaque)) return ABORTED;
+        }
+        if (m_stop) return ABORTED;
+
+        // A source read in flight lands over the oldest bytes, up to m_fillEnd - capacity
+        int64_t windowStart = std::max(m_basePos, m_fillEnd - static_cast<int64_t>(m_capacity));
+        if (pos >= windowStart && pos <= m_writePos) {
+            m_readPos = pos;
+            m_stats.seeksInBuffer++;
+            lock.unlock();
+            m_spaceCv.notify_one();
+            return pos;
+        }
+
+        // Outside the window: the reader thread repositions the source
+        m_seekTarget = pos;
+        m_seekPending = true;
+        m_spaceCv.notify_one();
+        while (m_seekPending && !m_stop) {
+            m_dataCv.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS));
+            if (m_seekPending && abort && abort(opaque)) return ABORTED;
+        }
+        return m_seekPending ? ABORTED : m_seekResult;
+    }
+
+    /** @brief Current read position (bytes from the start of the source) */
+    int64_t position() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_readPos;
+    }
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats s = m_stats;
+        s.capacity = m_capacity;
+        s.buffered = static_cast<size_t>(m_writePos - m_readPos);
+        return s;
+    }
+
+private:
+    int64_t startPosition() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_basePos;
+    }
+
+    void copyOutLocked(int64_t pos, uint8_t* dst, size_t n) const {
+        size_t off = static_cast<size_t>(pos % static_cast<int64_t>(m_capacity));
+        size_t first = std::min(n, m_capacity - off);
+        std::memcpy(dst, m_buffer.data() + off, first);
+        if (first < n) std::memcpy(dst + first, m_buffer.data(), n - first);
+    }
+
+    // Cursor::read(): bytes at @p pos, waiting for the reader thread to get there
+    int readAt(int64_t pos, uint8_t* dst, int size, AbortCallback abort, void* opaque) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (pos >= m_writePos && !m_eof && m_error == 0 && !m_stop) {
+            m_dataCv.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS));
+            if (abort && abort(opaque)) return ABORTED;
+        }
+        if (m_stop) return ABORTED;
+        if (pos >= m_writePos) return m_error != 0 ? m_error : 0;
+        if (pos < std::max(m_basePos, m_fillEnd - static_cast<int64_t>(m_capacity))) return -EINVAL;
+
+        size_t n = std::min(static_cast<size_t>(m_writePos - pos), static_cast<size_t>(size));
+        copyOutLocked(pos, dst, n);
+        m_stats.bytesOut += n;
+        return static_cast<int>(n);
+    }
+
+    // Position the reader may fill up to without overwriting unread or kept-behind data
+    int64_t writeLimitLocked() const {
+        int64_t tail = std::max(m_basePos, m_readPos - static_cast<int64_t>(m_keepBehind));
+        return tail + static_cast<int64_t>(m_capacity);
+    }
+
+    int64_t freeSpaceLocked() const { return writeLimitLocked() - m_writePos; }
+
+    void readerLoop() {
+        std::vector<uint8_t> chunk(CHUNK_SIZE);
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_spaceCv.wait(lock, [this]() {
+                    return m_stop || m_seekPending ||
+                           (!m_eof && m_error == 0 &&
+                            freeSpaceLocked() >= static_cast<int64_t>(CHUNK_SIZE));
+                });
+                if (m_stop) break;
+
+                if (m_seekPending) {
+                    int64_t target = m_seekTarget;
+                    lock.unlock();
+                    int64_t result = m_seek(target);
+                    lock.lock();
+                    if (result >= 0) {
+                        m_basePos = m_readPos = m_writePos = m_fillEnd = result;
+                        m_eof = false;
+                        m_error = 0;
+                        m_primed = false;
+                    }
+                    m_seekResult = result;
+                    m_seekPending = false;
+                    m_dataCv.notify_all();
+                    continue;
+                }
+                m_fillEnd = m_writePos + static_cast<int64_t>(CHUNK_SIZE);
+            }
+
+            auto t0 = std::chrono::steady_clock::now();
+            int n = m_read(chunk.data(), static_cast<int>(CHUNK_SIZE));
+            int64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_fillEnd = m_writePos;
+                if (m_stop) break;
+                if (m_seekPending) continue;   // Bytes belong to the old position
+
+                m_stats.sourceNs += elapsedNs;
+                if (n > 0) {
+                    size_t len = static_cast<size_t>(n);
+                    size_t off = static_cast<size_t>(m_writePos % static_cast<int64_t>(m_capacity));
+                    size_t first = std::min(len, m_capacity - off);
+                    std::memcpy(m_buffer.data() + off, chunk.data(), first);
+                    if (first < len) std::memcpy(m_buffer.data(), chunk.data() + first, len - first);
+                    m_writePos += n;
+                    m_fillEnd = m_writePos;
+                    m_stats.bytesIn += len;
+                } else if (n == 0) {
+                    m_eof = true;
+                } else {
+                    m_error = n;
+                }
+            }
+            m_dataCv.notify_all();
+        }
+    }
+
+    const size_t m_capacity;
+    const size_t m_keepBehind;          // Already-read bytes kept for backward seeks
+    std::vector<uint8_t> m_buffer;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_dataCv;   // Reader -> decoder: data, EOF, seek done
+    std::condition_variable m_spaceCv;  // Decoder -> reader: space, seek request
+
+    // Absolute source positions, protected by m_mutex
+    int64_t m_basePos = 0;              // First valid byte since the last reposition
+    int64_t m_readPos = 0;
+    int64_t m_writePos = 0;
+    int64_t m_fillEnd = 0;              // m_writePos + CHUNK_SIZE while a source read is in flight
+    bool m_eof = false;
+    int m_error = 0;
+    bool m_primed = false;              // Data delivered since the last reposition
+
+    bool m_seekPending = false;
+    int64_t m_seekTarget = 0;
+    int64_t m_seekResult = 0;
+
+    Stats m_stats;
+
+    ReadFn m_read;
+    SeekFn m_seek;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+#endif // HTTP_READ_AHEAD_H
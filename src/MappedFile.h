@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file MappedFile.h
+ * @brief Read-only mmap of a local track, read sequentially from the page cache
+ *
+ * The native WAV/AIFF/DSF readers take pointers into the mapping (view())
+ * and convert or copy straight into the output buffer: no read() into an
+ * AVIO buffer, no scratch copy. read()/seek() serve the FFmpeg demuxer
+ * through a custom AVIOContext and follow HttpReadAhead's ReadFn/SeekFn
+ * conventions.
+ *
+ * The mapping is MADV_SEQUENTIAL, and the next WILLNEED_BYTES past the read
+ * position are requested with MADV_WILLNEED every half window, so the
+ * kernel reads ahead of playback instead of faulting pages in on the audio
+ * thread. Single-threaded.
+ *
+ * Accesses to pages past the end of a file truncated while mapped, or that
+ * a network filesystem fails to read, raise SIGBUS and kill the process.
+ * The read()-based paths see a short read or EOF in the same situation.
+ * This is why --mmap is opt-in and documented as such.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class MappedFile {
+public:
+    static constexpr size_t WILLNEED_BYTES = 8 << 20;
+
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** @return 0, or -errno (-EINVAL: not a regular, non-empty file) */
+    int open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return -errno;
+        struct stat st;
+        if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+            ::close(fd);
+            return -EINVAL;
+        }
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        int err = errno;
+        ::close(fd);   // The mapping keeps the file open
+        if (p == MAP_FAILED) return -err;
+
+        m_data = static_cast<const uint8_t*>(p);
+        m_size = static_cast<size_t>(st.st_size);
+        madvise(const_cast<uint8_t*>(m_data), m_size, MADV_SEQUENTIAL);
+        advise();
+        return 0;
+    }
+
+    void close() {
+        if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = m_pos = m_advisedEnd = 0;
+    }
+
+    bool isOpen() const { return m_data != nullptr; }
+    int64_t size() const { return static_cast<int64_t>(m_size); }
+    int64_t position() const { return static_cast<int64_t>(m_pos); }
+
+    /**
+     * @brief Pointer to up to @p size bytes at the read position, which moves past them
+     * @param got Bytes available (less than @p size near the end, 0 at the end)
+     */
+    const uint8_t* view(size_t size, size_t& got) {
+        got = std::min(size, m_size - m_pos);
+        const uint8_t* p = m_data + m_pos;
+        m_pos += got;
+        advise();
+        return p;
+    }
+
+    /** @return Bytes read, 0 at the end of the file, or -errno */
+    int read(uint8_t* dst, int size) {
+        if (!m_data) return -EBADF;
+        if (size <= 0) return 0;
+        size_t got;
+        const uint8_t* src = view(static_cast<size_t>(size), got);
+        std::memcpy(dst, src, got);
+        return static_cast<int>(got);
+    }
+
+    int64_t seek(int64_t pos) {
+        if (!m_data) return -EBADF;
+        if (pos < 0) return -EINVAL;
+        m_pos = std::min(static_cast<size_t>(pos), m_size);
+        m_advisedEnd = 0;   // Window starts over at the new position
+        advise();
+        return pos;
+    }
+
+private:
+    // Keep the window past the read position requested; renewed every half window
+    void advise() {
+        if (m_advisedEnd >= m_size || (m_advisedEnd > m_pos && m_advisedEnd - m_pos > WILLNEED_BYTES / 2)) return;
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t start = std::max(m_pos, m_advisedEnd) / page * page;
+        size_t end = std::min(m_size, m_pos + WILLNEED_BYTES);
+        if (end > start) madvise(const_cast<uint8_t*>(m_data) + start, end - start, MADV_WILLNEED);
+        m_advisedEnd = end;
+    }
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_pos = 0;
+    size_t m_advisedEnd = 0;   // End of the last MADV_WILLNEED range
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file NativeContainer.h
+ * @brief Header parsing for uncompressed containers read without libavformat
+ *
+ * WAV, AIFF/AIFF-C and DSF carry raw samples after a small header, so
+ * AudioDecoder reads them like DSDIFF (openDFF): parse the header from the
+ * first few KB, then read sample data in large blocks straight into the
+ * output buffer, and seek by byte-offset arithmetic. No demuxer packets and
+ * no avformat_find_stream_info() probing.
+ *
+ * Anything unusual (float or compressed PCM, RF64, unknown data size, DSF
+ * with other than two channels, headers beyond the probe window) makes
+ * parseNativeHeader() return false and the decoder falls back to FFmpeg.
+ */
+
+#ifndef NATIVE_CONTAINER_H
+#define NATIVE_CONTAINER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+struct NativeLayout {
+    enum class Kind { None, WAV, AIFF, DSF };
+
+    Kind kind = Kind::None;
+    uint32_t sampleRate = 0;      // DSF: 1-bit rate (e.g. 2822400)
+    uint16_t channels = 0;
+    uint16_t bitsPerSample = 0;   // PCM: 16, 24 or 32; DSF: 1
+    bool bigEndian = false;       // AIFF (except AIFF-C 'sowt')
+    bool dsdMsbFirst = false;     // DSF bitsPerSample == 8
+    uint32_t blockAlign = 0;      // PCM: bytes per frame in the file
+    uint32_t dsfBlockSize = 0;    // DSF: bytes per channel per block (4096)
+    int64_t dataOffset = 0;       // First sample byte in the file
+    int64_t dataSize = 0;         // Sample bytes (DSF: including last-block padding)
+    uint64_t frames = 0;          // PCM frames, DSF samples per channel
+};
+
+namespace native_detail {
+
+inline uint16_t le16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+inline uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+inline uint64_t le64(const uint8_t* p) { return le32(p) | (static_cast<uint64_t>(le32(p + 4)) << 32); }
+inline uint16_t be16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+inline uint32_t be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+inline bool tag(const uint8_t* p, const char* t) { return std::memcmp(p, t, 4) == 0; }
+
+// AIFF COMM sample rate: 80-bit IEEE 754 extended, big-endian
+inline uint32_t extended80ToRate(const uint8_t* p) {
+    int exponent = ((p[0] & 0x7F) << 8) | p[1];
+    uint64_t mantissa = (static_cast<uint64_t>(be32(p + 2)) << 32) | be32(p + 6);
+    int shift = 16383 + 63 - exponent;
+    if ((p[0] & 0x80) || shift < 0 || shift > 63) return 0;
+    return static_cast<uint32_t>(mantissa >> shift);
+}
+
+inline bool validPcm(const NativeLayout& l) {
+    return l.sampleRate > 0 && l.channels > 0 && l.channels <= 8 &&
+           (l.bitsPerSample == 16 || l.bitsPerSample == 24 || l.bitsPerSample == 32) &&
+           l.blockAlign == static_cast<uint32_t>(l.channels) * l.bitsPerSample / 8;
+}
+
+inline bool parseWav(const uint8_t* p, size_t len, NativeLayout& out) {
+    NativeLayout l;
+    l.kind = NativeLayout::Kind::WAV;
+    bool haveFmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= len) {
+        const uint8_t* c = p + pos;
+        uint32_t size = le32(c + 4);
+        if (tag(c, "fmt ")) {
+            if (size < 16 || pos + 8 + 16 > len) return false;
+            uint16_t format = le16(c + 8);
+            if (format == 0xFFFE) {  // WAVE_FORMAT_EXTENSIBLE: sub-format GUID starts with the tag
+                if (size < 40 || pos + 8 + 40 > len) return false;
+                format = le16(c + 8 + 24);
+            }
+            if (format != 1) return false;  // Float, compressed: FFmpeg
+            l.channels = le16(c + 10);
+            l.sampleRate = le32(c + 12);
+            l.blockAlign = le16(c + 20);
+            l.bitsPerSample = le16(c + 22);
+            haveFmt = true;
+        } else if (tag(c, "data")) {
+            if (!haveFmt || !validPcm(l) || size == 0 || size == 0xFFFFFFFF) return false;
+            l.dataOffset = static_cast<int64_t>(pos + 8);
+            l.dataSize = size - size % l.blockAlign;
+            l.frames = static_cast<uint64_t>(l.dataSize) / l.blockAlign;
+            out = l;
+            return true;
+        }
+        pos += 8 + size + (size & 1);  // Chunks are word-aligned
+    }
+    return false;
+}
+
+inline bool parseAiff(const uint8_t* p, size_t len, bool aifc, NativeLayout& out) {
+    NativeLayout l;
+    l.kind = NativeLayout::Kind::AIFF;
+    l.bigEndian = true;
+    bool haveComm = false;
+    size_t pos = 12;
+    while (pos + 8 <= len) {
+        const uint8_t* c = p + pos;
+        uint32_t size = be32(c + 4);
+        if (tag(c, "COMM")) {
+            if (size < 18 || pos + 8 + 18 > len) return false;
+            l.channels = be16(c + 8);
+            l.frames = be32(c + 10);
+            l.bitsPerSample = be16(c + 14);
+            l.sampleRate = extended80ToRate(c + 16);
+            if (aifc) {
+                if (size < 22 || pos + 8 + 22 > len) return false;
+                if (tag(c + 26, "sowt")) l.bigEndian = false;
+                else if (!tag(c + 26, "NONE")) return false;  // fl32, alaw, ...: FFmpeg
+            }
+            l.blockAlign = static_cast<uint32_t>(l.channels) * l.bitsPerSample / 8;
+            haveComm = true;
+        } else if (tag(c, "SSND")) {
+            if (!haveComm || !validPcm(l) || size < 8 || pos + 16 > len) return false;
+            uint32_t offset = be32(c + 8);
+            l.dataOffset = static_cast<int64_t>(pos + 16 + offset);
+            int64_t avail = static_cast<int64_t>(size) - 8 - offset;
+            int64_t needed = static_cast<int64_t>(l.frames) * l.blockAlign;
+            if (avail <= 0 || needed == 0) return false;
+            l.dataSize = needed < avail ? needed : avail - avail % l.blockAlign;
+            l.frames = static_cast<uint64_t>(l.dataSize) / l.blockAlign;
+            out = l;
+            return true;
+        }
+        pos += 8 + size + (size & 1);
+    }
+    return false;
+}
+
+inline bool parseDsf(const uint8_t* p, size_t len, NativeLayout& out) {
+    // "DSD " chunk (28 bytes), then "fmt " (52 bytes), then "data"
+    if (len < 28 + 52 + 12 || le64(p + 4) != 28 || !tag(p + 28, "fmt ")) return false;
+    const uint8_t* f = p + 28;
+    uint64_t fmtSize = le64(f + 4);
+    if (fmtSize < 52 || 28 + fmtSize + 12 > len) return false;
+    if (le32(f + 12) != 1 || le32(f + 16) != 0) return false;  // Version 1, raw DSD
+
+    NativeLayout l;
+    l.kind = NativeLayout::Kind::DSF;
+    l.channels = static_cast<uint16_t>(le32(f + 24));
+    l.sampleRate = le32(f + 28);
+    uint32_t bits = le32(f + 32);
+    l.frames = le64(f + 36);
+    l.dsfBlockSize = le32(f + 44);
+    l.bitsPerSample = 1;
+    l.dsdMsbFirst = (bits == 8);
+
+    const uint8_t* d = p + 28 + fmtSize;
+    if (!tag(d, "data") || (bits != 1 && bits != 8) || l.channels != 2 ||
+        l.sampleRate == 0 || l.dsfBlockSize == 0 || l.frames == 0) {
+        return false;
+    }
+    l.dataOffset = static_cast<int64_t>(28 + fmtSize + 12);
+    l.dataSize = static_cast<int64_t>(le64(d + 4)) - 12;
+    uint64_t perChannel = (l.frames + 7) / 8;
+    uint64_t blocks = (perChannel + l.dsfBlockSize - 1) / l.dsfBlockSize;
+    if (l.dataSize < static_cast<int64_t>(blocks * l.dsfBlockSize * l.channels)) return false;
+    out = l;
+    return true;
+}
+
+}  // namespace native_detail
+
+/**
+ * @brief Parse a WAV / AIFF / DSF header from the first @p len bytes of a file
+ * @return false if the container is not one we read natively (use FFmpeg)
+ */
+inline bool parseNativeHeader(const uint8_t* p, size_t len, NativeLayout& out) {
+    using namespace native_detail;
+    if (len < 12) return false;
+    if (tag(p, "RIFF") && tag(p + 8, "WAVE")) return parseWav(p, len, out);
+    if (tag(p, "FORM") && tag(p + 8, "AIFF")) return parseAiff(p, len, false, out);
+    if (tag(p, "FORM") && tag(p + 8, "AIFC")) return parseAiff(p, len, true, out);
+    if (tag(p, "DSD ")) return parseDsf(p, len, out);
+    return false;
+}
+
+/**
+ * @brief Convert @p samples PCM samples from file layout to AudioDecoder output
+ *
+ * Output matches the FFmpeg path: S16 little-endian for 16-bit, S32 with the
+ * sample in the upper 24 bits for 24-bit, S32 for 32-bit. 16/32-bit may be
+ * converted in place (@p src == @p dst).
+ */
+inline void nativePcmToOutput(const uint8_t* src, uint8_t* dst, size_t samples, const NativeLayout& l) {
+    if (l.bitsPerSample == 24) {
+        for (size_t i = 0; i < samples; i++, src += 3, dst += 4) {
+            dst[0] = 0;
+            if (l.bigEndian) { dst[1] = src[2]; dst[2] = src[1]; dst[3] = src[0]; }
+            else             { dst[1] = src[0]; dst[2] = src[1]; dst[3] = src[2]; }
+        }
+        return;
+    }
+    size_t bytes = samples * (l.bitsPerSample / 8);
+    if (!l.bigEndian) {
+        if (src != dst) std::memcpy(dst, src, bytes);
+        return;
+    }
+    if (l.bitsPerSample == 16) {
+        for (size_t i = 0; i < bytes; i += 2) {
+            uint8_t b0 = src[i];
+            dst[i] = src[i + 1];
+            dst[i + 1] = b0;
+        }
+    } else {
+        for (size_t i = 0; i < bytes; i += 4) {
+            uint8_t b0 = src[i], b1 = src[i + 1];
+            dst[i] = src[i + 3];
+            dst[i + 1] = src[i + 2];
+            dst[i + 2] = b1;
+            dst[i + 3] = b0;
+        }
+    }
+}
+
+#endif // NATIVE_CONTAINER_H
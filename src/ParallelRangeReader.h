@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file ParallelRangeReader.h
+ * @brief One HTTP source fetched as byte-range segments over several connections
+ *
+ * Some servers (and most streaming proxies) deliver each connection at about
+ * real time, so a high-rate track never gets ahead of playback and prefill
+ * takes as long as the audio it covers. When the server honours ranges, the
+ * source is cut into SEGMENT_SIZE segments that worker threads fetch over
+ * their own pooled connections ("Range: bytes=a-b"); read() hands them out
+ * strictly in order. Only segments inside a window of windowSegments from
+ * the read position are fetched, which bounds memory.
+ *
+ * The number of connections adapts: it starts at one, grows by one each time
+ * read() has to wait for the next segment, and shrinks when a fetch fails
+ * (e.g. the server or the pool's per-host cap refuses another connection).
+ * Extra connections never wait for a pool slot. Failed segments are fetched
+ * again; MAX_FAILURES consecutive failed fetches end the stream with the error.
+ *
+ * read()/seek() follow HttpReadAhead's ReadFn/SeekFn conventions and are
+ * called from a single thread (the read-ahead reader thread). The abort
+ * callback (the read-ahead's stopping flag) ends a read() waiting for a
+ * segment and the fetches in flight, so stopping the read-ahead does not
+ * wait for a slow server.
+ */
+
+#ifndef PARALLEL_RANGE_READER_H
+#define PARALLEL_RANGE_READER_H
+
+#include "HttpConnectionPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ParallelRangeReader {
+public:
+    static constexpr size_t SEGMENT_SIZE = 1 << 20;
+    static constexpr int MAX_FAILURES = 4;          // Consecutive failed fetches before giving up
+    static constexpr int RETRY_DELAY_MS = 250;
+    static constexpr int WAIT_SLICE_MS = 20;        // read() polls the abort callback this often
+
+    struct Stats {
+        uint64_t segments = 0;         // Fetched and stored
+        uint64_t failures = 0;         // Fetches that failed and were queued again
+        uint64_t stalls = 0;           // read() calls that waited for the next segment
+        unsigned connections = 0;      // Current target
+        unsigned peakConnections = 0;
+    };
+
+    /**
+     * @param size Source size (Content-Length); the server must honour byte ranges
+     * @param abort Non-zero aborts read() and the fetches (FFmpeg style), like stop()
+     * @param windowSegments Segments buffered or in flight ahead of the reader (0 = 2 per connection)
+     */
+    ParallelRangeReader(HttpConnectionPool& pool, const std::string& url, int64_t size,
+                        unsigned maxConnections,
+                        HttpConnectionPool::AbortCallback abort = nullptr, void* opaque = nullptr,
+                        size_t windowSegments = 0)
+        : m_pool(pool)
+        , m_abort(abort)
+        , m_opaque(opaque)
+        , m_url(url)
+        , m_size(size)
+        , m_numSegments((size + static_cast<int64_t>(SEGMENT_SIZE) - 1) / static_cast<int64_t>(SEGMENT_SIZE))
+        , m_maxConnections(std::max(1u, maxConnections))
+        , m_windowSegments(static_cast<int64_t>(windowSegments ? windowSegments : 2 * m_maxConnections)) {
+        m_stats.connections = m_stats.peakConnections = 1;
+        for (unsigned i = 0; i < m_maxConnections; i++) {
+            m_workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~ParallelRangeReader() { stop(); }
+
+    ParallelRangeReader(const ParallelRangeReader&) = delete;
+    ParallelRangeReader& operator=(const ParallelRangeReader&) = delete;
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop.store(true, std::memory_order_release);
+        }
+        m_workCv.notify_all();
+        m_dataCv.notify_all();
+        for (auto& t : m_workers) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    /** @return Bytes read, 0 at the end of the source, or -errno */
+    int read(uint8_t* dst, int size) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_readPos >= m_size) return 0;
+        int64_t seg = m_readPos / static_cast<int64_t>(SEGMENT_SIZE);
+        auto it = m_ready.find(seg);
+        if (it == m_ready.end()) {
+            m_stats.stalls++;
+            // The reader is waiting on the network: try one more connection
+            if (m_stats.connections < m_maxConnections) {
+                m_stats.connections++;
+                m_stats.peakConnections = std::max(m_stats.peakConnections, m_stats.connections);
+                m_workCv.notify_all();
+            }
+            while (!m_dataCv.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS), [&]() {
+                       return m_stop || m_error != 0 || (it = m_ready.find(seg)) != m_ready.end();
+                   })) {
+                if (aborted()) return -EINTR;
+            }
+            if (m_stop) return -EINTR;
+            if (it == m_ready.end()) return m_error;
+        }
+
+        size_t off = static_cast<size_t>(m_readPos - seg * static_cast<int64_t>(SEGMENT_SIZE));
+        size_t n = std::min(static_cast<size_t>(size), it->second.size() - off);
+        std::memcpy(dst, it->second.data() + off, n);
+        m_readPos += static_cast<int64_t>(n);
+        if (off + n == it->second.size()) {
+            m_ready.erase(it);
+            m_workCv.notify_all();   // Window moved on
+        }
+        return static_cast<int>(n);
+    }
+
+    /** @brief Restart fetching at @p pos; segments already fetched are dropped */
+    int64_t seek(int64_t pos) {
+        if (pos < 0) return -EINVAL;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_generation.fetch_add(1, std::memory_order_acq_rel);  // Aborts fetches in flight
+            m_ready.clear();
+            m_retry.clear();
+            m_readPos = pos;
+            m_nextClaim = pos / static_cast<int64_t>(SEGMENT_SIZE);
+            m_error = 0;
+            m_failures = 0;
+        }
+        m_workCv.notify_all();
+        return pos;
+    }
+
+    Stats getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    struct WorkerCtx {
+        ParallelRangeReader* self;
+        uint64_t generation;
+    };
+
+    bool aborted() const {
+        return m_stop.load(std::memory_order_acquire) || (m_abort && m_abort(m_opaque));
+    }
+
+    // Fetches of an older generation (before a seek) and fetches during stop()/abort end early
+    static int abortCb(void* opaque) {
+        auto* ctx = static_cast<WorkerCtx*>(opaque);
+        return ctx->self->aborted() ||
+               ctx->generation != ctx->self->m_generation.load(std::memory_order_acquire);
+    }
+
+    int64_t windowEndLocked() const {
+        return std::min(m_numSegments, m_readPos / static_cast<int64_t>(SEGMENT_SIZE) + m_windowSegments);
+    }
+
+    bool claimableLocked() const {
+        int64_t end = windowEndLocked();
+        return (!m_retry.empty() && *m_retry.begin() < end) || m_nextClaim < end;
+    }
+
+    // Lowest segment first: failed ones before new ones
+    int64_t claimLocked() {
+        if (!m_retry.empty() && *m_retry.begin() < windowEndLocked()) {
+            int64_t seg = *m_retry.begin();
+            m_retry.erase(m_retry.begin());
+            return seg;
+        }
+        return m_nextClaim++;
+    }
+
+    void workerLoop(unsigned index) {
+        WorkerCtx ctx{this, 0};
+        PooledHttpStream stream(m_pool, abortCb, &ctx);
+        stream.setSlotWait(index == 0);   // Extra connections only if the host has a free slot
+        std::vector<uint8_t> buf;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop) {
+            m_workCv.wait(lock, [&]() {
+                return m_stop || (index < m_stats.connections && m_error == 0 && claimableLocked());
+            });
+            if (m_stop) break;
+            int64_t seg = claimLocked();
+            ctx.generation = m_generation.load(std::memory_order_acquire);
+            lock.unlock();
+
+            int64_t start = seg * static_cast<int64_t>(SEGMENT_SIZE);
+            int64_t end = std::min(m_size, start + static_cast<int64_t>(SEGMENT_SIZE)) - 1;
+            buf.resize(static_cast<size_t>(end - start + 1));
+            size_t got = 0;
+            int ret = stream.open(m_url, start, end);
+            while (ret == 0 && got < buf.size()) {
+                int n = stream.read(buf.data() + got, static_cast<int>(std::min<size_t>(buf.size() - got, INT_MAX)));
+                if (n <= 0) ret = (n < 0) ? n : -ECONNRESET;
+                else got += static_cast<size_t>(n);
+            }
+
+            lock.lock();
+            if (ctx.generation != m_generation.load(std::memory_order_acquire)) continue;  // Seeked away
+            if (ret < 0) {
+                stream.close();
+                m_retry.insert(seg);
+                m_stats.failures++;
+                // Server (or the pool cap) won't take this many connections
+                if (m_stats.connections > 1) m_stats.connections--;
+                // No free pool slot for an extra connection is not a source failure
+                if (ret != -EBUSY && ++m_failures >= MAX_FAILURES) {
+                    m_error = ret;
+                    m_dataCv.notify_all();
+                }
+                m_workCv.wait_for(lock, std::chrono::milliseconds(RETRY_DELAY_MS), [this]() { return m_stop.load(); });
+                continue;
+            }
+            m_failures = 0;
+            m_ready[seg].swap(buf);
+            m_stats.segments++;
+            m_dataCv.notify_all();
+        }
+    }
+
+    HttpConnectionPool& m_pool;
+    const HttpConnectionPool::AbortCallback m_abort;
+    void* const m_opaque;
+    const std::string m_url;
+    const int64_t m_size;
+    const int64_t m_numSegments;
+    const unsigned m_maxConnections;
+    const int64_t m_windowSegments;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workCv;   // Reader -> workers: window moved, more connections, seek
+    std::condition_variable m_dataCv;   // Workers -> reader: segment stored, error
+
+    // Protected by m_mutex
+    int64_t m_readPos = 0;
+    int64_t m_nextClaim = 0;            // Next segment never claimed since the last seek
+    std::set<int64_t> m_retry;          // Failed segments to fetch again
+    std::map<int64_t, std::vector<uint8_t>> m_ready;
+    int m_failures = 0;                 // Consecutive
+    int m_error = 0;
+    Stats m_stats;
+
+    std::atomic<uint64_t> m_generation{0};
+    std::atomic<bool> m_stop{false};
+    std::vector<std::thread> m_workers;
+};
+
+#endif // PARALLEL_RANGE_READER_H
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file SeekIndex.h
+ * @brief Sparse position -> byte offset map for containers without fixed-size frames
+ *
+ * DST-compressed DFF frames (1/75 s each) have variable sizes, so a seek
+ * cannot compute the byte offset of a frame. AudioDecoder records the
+ * offset of every @p stride-th frame it reads, and loads the file's "DSTI"
+ * index chunk when there is one. A seek starts at floor(target), one range
+ * request, and walks at most stride - 1 frame headers from there.
+ *
+ * Positions are whatever unit the container counts in (DST: frame numbers).
+ * Points are kept sorted; a seek back and replay records nothing twice.
+ */
+
+#ifndef SEEK_INDEX_H
+#define SEEK_INDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class SeekIndex {
+public:
+    struct Point {
+        uint64_t position = 0;
+        int64_t offset = 0;            // Byte offset in the source
+    };
+
+    explicit SeekIndex(uint64_t stride = 1) : m_stride(stride ? stride : 1) {}
+
+    uint64_t stride() const { return m_stride; }
+    size_t size() const { return m_points.size(); }
+    bool empty() const { return m_points.empty(); }
+    void clear() { m_points.clear(); }
+
+    /** @brief Highest indexed position (0 when empty) */
+    uint64_t last() const { return m_points.empty() ? 0 : m_points.back().position; }
+
+    /** @brief Record @p position at @p offset; positions off the stride are ignored */
+    void add(uint64_t position, int64_t offset) {
+        if (position % m_stride != 0) return;
+        if (m_points.empty() || position > m_points.back().position) {
+            m_points.push_back({position, offset});   // Playback order: append
+            return;
+        }
+        auto it = lowerBound(position);
+        if (it != m_points.end() && it->position == position) return;
+        m_points.insert(it, {position, offset});
+    }
+
+    /** @brief Nearest point at or before @p position */
+    bool floor(uint64_t position, Point& out) const {
+        auto it = std::upper_bound(m_points.begin(), m_points.end(), position,
+                                   [](uint64_t p, const Point& pt) { return p < pt.position; });
+        if (it == m_points.begin()) return false;
+        out = *(it - 1);
+        return true;
+    }
+
+private:
+    std::vector<Point>::iterator lowerBound(uint64_t position) {
+        return std::lower_bound(m_points.begin(), m_points.end(), position,
+                                [](const Point& pt, uint64_t p) { return pt.position < p; });
+    }
+
+    const uint64_t m_stride;
+    std::vector<Point> m_points;
+};
+
+#endif // SEEK_INDEX_H
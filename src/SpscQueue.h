@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file SpscQueue.h
+ * @brief Bounded single-producer / single-consumer queue, lock-free on the fast path
+ *
+ * AudioDecoder's demux thread hands packets to the decoder through one of
+ * these and gets them back, emptied, through a second one. tryPush()/tryPop()
+ * are a head/tail ring with acquire/release ordering and never block or
+ * allocate. push()/pop() wait only when the queue is full/empty: the waiting
+ * side raises a flag and sleeps on a condition variable, and the other side
+ * takes the mutex to notify only when that flag is set.
+ *
+ * size() may be read from any thread (statistics).
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+template <typename T>
+class SpscQueue {
+public:
+    // Upper bound on one sleep: a missed stop flag is noticed this late at worst
+    static constexpr auto WAIT_SLICE = std::chrono::milliseconds(5);
+
+    /** @param capacity Rounded up to a power of two */
+    explicit SpscQueue(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        m_slots.resize(n);
+        m_mask = n - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return m_slots.size(); }
+
+    size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    /** @brief Producer: false when full */
+    bool tryPush(const T& value) {
+        if (!pushSlot(value)) return false;
+        wake(m_popWaiting, m_notEmpty);
+        return true;
+    }
+
+    /** @brief Consumer: false when empty */
+    bool tryPop(T& value) {
+        if (!popSlot(value)) return false;
+        wake(m_pushWaiting, m_notFull);
+        return true;
+    }
+
+    /** @brief Producer: wait for space; false if @p stop was set first */
+    bool push(const T& value, const std::atomic<bool>& stop) {
+        if (!waitFor([&]() { return pushSlot(value); }, stop, m_pushWaiting, m_notFull)) return false;
+        wake(m_popWaiting, m_notEmpty);
+        return true;
+    }
+
+    /** @brief Consumer: wait for an element; false if @p stop was set first */
+    bool pop(T& value, const std::atomic<bool>& stop) {
+        if (!waitFor([&]() { return popSlot(value); }, stop, m_popWaiting, m_notEmpty)) return false;
+        wake(m_pushWaiting, m_notFull);
+        return true;
+    }
+
+    /** @brief Wake both sides, e.g. after setting their stop flag */
+    void wakeAll() {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+private:
+    bool pushSlot(const T& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size()) return false;
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool popSlot(T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        value = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void wake(std::atomic<bool>& waiting, std::condition_variable& cv) {
+        // Pairs with the fence in waitFor(): either it sees our update or we see its flag
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!waiting.load(std::memory_order_relaxed)) return;
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        cv.notify_one();
+    }
+
+    // Called without waking the other side; the caller does that after the mutex is released
+    template <typename Try>
+    bool waitFor(Try attempt, const std::atomic<bool>& stop,
+                 std::atomic<bool>& waiting, std::condition_variable& cv) {
+        if (attempt()) return true;
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        bool done = false;
+        while (!stop.load(std::memory_order_acquire)) {
+            waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if ((done = attempt())) break;
+            cv.wait_for(lock, WAIT_SLICE);
+        }
+        waiting.store(false, std::memory_order_relaxed);
+        return done;
+    }
+
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_head{0};   // Written by the consumer
+    alignas(64) std::atomic<size_t> m_tail{0};   // Written by the producer
+
+    std::mutex m_waitMutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::atomic<bool> m_popWaiting{false};
+    std::atomic<bool> m_pushWaiting{false};
+};
+
+#endif // SPSC_QUEUE_H
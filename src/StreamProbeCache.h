@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file StreamProbeCache.h
+ * @brief Stream parameters found by FFmpeg probing, remembered per URI
+ *
+ * avformat_find_stream_info() reads and decodes the start of the stream
+ * (up to the 5 MB default probesize on remote servers) before a track can
+ * start. The result only depends on the file, so AudioDecoder stores it
+ * here after a full probe: demuxer, audio stream index, codec parameters
+ * and duration. When the same URI is opened again (replay, gapless retry,
+ * reopen after a restart or a format change) the decoder names the demuxer
+ * up front and skips stream-info probing, as long as the reopened source
+ * has the same Content-Length and the demuxer reports the same codec.
+ *
+ * Sources without a known size (live streams) are never cached. Fields are
+ * plain integers so the header needs no FFmpeg includes; AudioDecoder maps
+ * them to and from AVCodecParameters.
+ */
+
+#ifndef STREAM_PROBE_CACHE_H
+#define STREAM_PROBE_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct StreamProbe {
+    std::string demuxer;            // AVInputFormat name
+    int64_t size = -1;              // Source size the probe was made on
+    int streamIndex = -1;
+    int codecId = 0;                // AVCodecID
+    int format = -1;                // AVSampleFormat (codecpar->format)
+    int sampleRate = 0;
+    int channels = 0;
+    int bitsPerCodedSample = 0;
+    int bitsPerRawSample = 0;
+    int blockAlign = 0;
+    int frameSize = 0;
+    int64_t bitRate = 0;
+    std::vector<uint8_t> extradata;
+    int64_t durationUs = -1;        // Stream duration (AV_TIME_BASE units), -1 = unknown
+};
+
+class StreamProbeCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 512;
+
+    struct Stats {
+        uint64_t hits = 0;             // Opens that skipped stream-info probing
+        uint64_t misses = 0;
+        uint64_t stale = 0;            // Entries dropped because the source changed
+        size_t entries = 0;
+    };
+
+    explicit StreamProbeCache(size_t capacity = DEFAULT_CAPACITY) : m_capacity(capacity ? capacity : 1) {}
+
+    StreamProbeCache(const StreamProbeCache&) = delete;
+    StreamProbeCache& operator=(const StreamProbeCache&) = delete;
+
+    /** @brief Copy the entry for @p uri into @p out (most recently used) */
+    bool lookup(const std::string& uri, StreamProbe& out) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(uri);
+        if (it == m_index.end()) {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        out = it->second->second;
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** @brief Remember @p probe for @p uri; ignored when the size is unknown */
+    void store(const std::string& uri, StreamProbe probe) {
+        if (probe.size <= 0 || probe.demuxer.empty() || probe.streamIndex < 0) return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(uri);
+        if (it != m_index.end()) {
+            it->second->second = std::move(probe);
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return;
+        }
+        m_lru.emplace_front(uri, std::move(probe));
+        m_index[uri] = m_lru.begin();
+        if (m_lru.size() > m_capacity) {
+            m_index.erase(m_lru.back().first);
+            m_lru.pop_back();
+        }
+        m_entries.store(m_lru.size(), std::memory_order_relaxed);
+    }
+
+    /** @brief Drop @p uri's entry after lookup() found it but the reopened source differs */
+    void invalidate(const std::string& uri) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(uri);
+        if (it == m_index.end()) return;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+        m_entries.store(m_lru.size(), std::memory_order_relaxed);
+        m_hits.fetch_sub(1, std::memory_order_relaxed);   // Counted by the lookup() that found it
+        m_stale.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Stats getStats() const {
+        Stats s;
+        s.hits = m_hits.load(std::memory_order_relaxed);
+        s.misses = m_misses.load(std::memory_order_relaxed);
+        s.stale = m_stale.load(std::memory_order_relaxed);
+        s.entries = m_entries.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    using Entry = std::pair<std::string, StreamProbe>;
+
+    const size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_lru;                                        // Most recent first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+
+    // Atomics: read by DirettaRenderer::dumpStats()
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_stale{0};
+    std::atomic<size_t> m_entries{0};
+};
+
+#endif // STREAM_PROBE_CACHE_H
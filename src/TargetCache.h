@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file TargetCache.h
+ * @brief Persisted Diretta target selection, MTU and sink capabilities
+ *
+ * Written after every successful DirettaSync::enable(). On the next start
+ * the cached target is looked up with a single discovery pass and the
+ * cached MTU replaces measureMTU(); if the target isn't there, the normal
+ * discovery loop runs. Only an MTU that measureMTU() actually measured is
+ * stored, so a --mtu override or the fallback never masks the real link.
+ *
+ * Plain "key=value" lines, written to a temp file and renamed into place so
+ * a crash never leaves a truncated cache behind.
+ */
+
+#ifndef TARGET_CACHE_H
+#define TARGET_CACHE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+struct TargetCache {
+    static constexpr int VERSION = 2;   // 2: mtu holds only a measured value
+
+    std::string address;        // ACQUA::IPAddress::get_str()
+    std::string targetName;
+    std::string outputName;
+    int targetIndex = -1;       // --target selection the entry was made for
+    uint32_t mtu = 0;           // Measured MTU (0 = never measured, measure on start)
+
+    // Sink capabilities from inquirySupportFormat()
+    bool supportPCM = false;
+    bool supportDSD = false;
+    bool supportDSDlsb = false;
+    bool supportDSDmsb = false;
+    uint16_t msModes = 0;       // supportMSmode bitmask (0 until first connection)
+
+    bool valid() const { return !address.empty(); }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) return false;
+
+        TargetCache c;
+        int version = 0;
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t eq = line.find('=');
+            if (line.empty() || line[0] == '#' || eq == std::string::npos) continue;
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            unsigned long n = std::strtoul(value.c_str(), nullptr, 10);
+
+            if (key == "version") version = static_cast<int>(n);
+            else if (key == "address") c.address = value;
+            else if (key == "target_name") c.targetName = value;
+            else if (key == "output_name") c.outputName = value;
+            else if (key == "target_index") c.targetIndex = std::atoi(value.c_str());
+            else if (key == "mtu") c.mtu = static_cast<uint32_t>(n);
+            else if (key == "pcm") c.supportPCM = n != 0;
+            else if (key == "dsd") c.supportDSD = n != 0;
+            else if (key == "dsd_lsb") c.supportDSDlsb = n != 0;
+            else if (key == "dsd_msb") c.supportDSDmsb = n != 0;
+            else if (key == "ms_modes") c.msModes = static_cast<uint16_t>(n);
+        }
+
+        if (version != VERSION || !c.valid()) return false;
+        *this = c;
+        return true;
+    }
+
+    bool save(const std::string& path) const {
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            if (!out) return false;
+            out << "# DirettaRendererUPnP target cache (safe to delete)\n"
+                << "version=" << VERSION << "\n"
+                << "address=" << address << "\n"
+                << "target_name=" << targetName << "\n"
+                << "output_name=" << outputName << "\n"
+                << "target_index=" << targetIndex << "\n"
+                << "mtu=" << mtu << "\n"
+                << "pcm=" << supportPCM << "\n"
+                << "dsd=" << supportDSD << "\n"
+                << "dsd_lsb=" << supportDSDlsb << "\n"
+                << "dsd_msb=" << supportDSDmsb << "\n"
+                << "ms_modes=" << msModes << "\n";
+            if (!out.flush()) return false;
+        }
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+};
+
+#endif // TARGET_CACHE_H
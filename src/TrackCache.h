@@ -0,0 +1,412 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file TrackCache.h
+ * @brief On-disk LRU cache of HTTP track bytes, served via mmap
+ *
+ * Each cached source is a preallocated data file (mmap'd) plus a block map
+ * recording which BLOCK_SIZE ranges have been downloaded. A TrackCache::Source
+ * sits between HttpReadAhead and the network: blocks already on disk are
+ * copied from the mapping, missing blocks are fetched from the network
+ * straight into the mapping and marked once complete. Partially cached
+ * tracks therefore play and seek from disk where they can, and every play
+ * fills in more of the file.
+ *
+ * Entries are keyed by URI + Content-Length (FFmpeg's HTTP protocol does not
+ * expose ETag). Sources without a known size are not cached. The cache
+ * directory is trimmed to the size cap (least recently used first) when it
+ * is opened and before each new entry is created.
+ *
+ * Released entries are synced and their block map written by a background
+ * thread (nice +10), never by the thread that closed the decoder, and
+ * outside the cache lock, so acquire() never waits for another entry's
+ * writeback. The TrackCache must outlive every decoder holding one of its
+ * entries.
+ */
+
+#ifndef TRACK_CACHE_H
+#define TRACK_CACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+class TrackCache {
+public:
+    static constexpr size_t BLOCK_SIZE = 262144;   // Block map granularity
+    static constexpr const char* MAP_MAGIC = "DRCACHE1";
+
+    using ReadFn = std::function<int(uint8_t* buf, int size)>;  // >0 bytes, 0 EOF, <0 error
+    using SeekFn = std::function<int64_t(int64_t pos)>;         // New position, <0 error
+
+    /** @brief One cached source (shared by all open decoders of the same key) */
+    class Entry {
+    public:
+        const std::string& uri() const { return m_uri; }
+        int64_t size() const { return m_size; }
+        const uint8_t* data() const { return m_data; }
+        uint8_t* data() { return m_data; }
+
+        size_t numBlocks() const { return m_numBlocks; }
+        bool has(size_t block) const { return m_blocks[block].load(std::memory_order_acquire) != 0; }
+        size_t blocksPresent() const { return m_present.load(std::memory_order_relaxed); }
+        bool complete() const { return blocksPresent() == m_numBlocks; }
+
+        void mark(size_t block) {
+            if (m_blocks[block].exchange(1, std::memory_order_release) == 0) {
+                m_present.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        friend class TrackCache;
+        std::string m_key;
+        std::string m_uri;
+        int64_t m_size = 0;
+        int m_fd = -1;
+        uint8_t* m_data = nullptr;
+        size_t m_numBlocks = 0;
+        std::unique_ptr<std::atomic<uint8_t>[]> m_blocks;
+        std::atomic<size_t> m_present{0};
+    };
+
+    /**
+     * @brief Read path for one decoder: cache blocks first, network for the rest
+     *
+     * read()/seek() follow HttpReadAhead's ReadFn/SeekFn contract and are
+     * called from its reader thread only. The network is repositioned
+     * lazily, at block starts, so every fetched block can be marked.
+     */
+    class Source {
+    public:
+        struct Stats {
+            uint64_t cacheBytes = 0;
+            uint64_t networkBytes = 0;
+            uint64_t networkSeeks = 0;
+        };
+
+        /** @param net / netSeek Network source, may be empty if the entry is complete */
+        Source(std::shared_ptr<Entry> entry, ReadFn net, SeekFn netSeek, int64_t netPos = 0)
+            : m_entry(std::move(entry)), m_net(std::move(net)), m_netSeek(std::move(netSeek))
+            , m_netPos(netPos), m_runStart(netPos) {}
+
+        int read(uint8_t* buf, int size) {
+            const int64_t fileSize = m_entry->size();
+            if (m_pos >= fileSize) return 0;
+
+            size_t block = static_cast<size_t>(m_pos / static_cast<int64_t>(BLOCK_SIZE));
+            int64_t blockStart = static_cast<int64_t>(block * BLOCK_SIZE);
+            int64_t blockEnd = std::min(blockStart + static_cast<int64_t>(BLOCK_SIZE), fileSize);
+
+            if (m_entry->has(block)) {
+                int n = static_cast<int>(std::min<int64_t>(size, blockEnd - m_pos));
+                std::memcpy(buf, m_entry->data() + m_pos, static_cast<size_t>(n));
+                m_pos += n;
+                m_stats.cacheBytes += static_cast<uint64_t>(n);
+                return n;
+            }
+            if (!m_net) return -EIO;
+
+            // [m_runStart, m_netPos) is valid in the mapping. The run must cover the
+            // whole block to mark it: otherwise restart the network at its start.
+            if (m_runStart > blockStart || m_netPos < blockStart || m_netPos > blockEnd) {
+                int64_t r = m_netSeek(blockStart);
+                if (r < 0) return static_cast<int>(r);
+                m_netPos = m_runStart = blockStart;
+                m_stats.networkSeeks++;
+            }
+
+            while (m_netPos <= m_pos) {
+                int want = static_cast<int>(blockEnd - m_netPos);
+                int n = m_net(m_entry->data() + m_netPos, want);
+                if (n <= 0) return n;   // Short source: EOF/error before Content-Length
+                m_netPos += n;
+                m_stats.networkBytes += static_cast<uint64_t>(n);
+                if (m_netPos == blockEnd) m_entry->mark(block);
+            }
+
+            int n = static_cast<int>(std::min<int64_t>(size, m_netPos - m_pos));
+            std::memcpy(buf, m_entry->data() + m_pos, static_cast<size_t>(n));
+            m_pos += n;
+            return n;
+        }
+
+        int64_t seek(int64_t pos) {
+            if (pos < 0) return -EINVAL;
+            m_pos = pos;
+            return pos;
+        }
+
+        const Entry& entry() const { return *m_entry; }
+        Stats getStats() const { return m_stats; }
+
+    private:
+        std::shared_ptr<Entry> m_entry;
+        ReadFn m_net;
+        SeekFn m_netSeek;
+        int64_t m_pos = 0;        // Decoder-side position
+        int64_t m_netPos;         // Network position
+        int64_t m_runStart;       // Start of the current contiguous network run
+        Stats m_stats;
+    };
+
+    TrackCache(const std::string& dir, uint64_t capacityBytes)
+        : m_dir(dir), m_capacity(capacityBytes) {
+        mkdir(m_dir.c_str(), 0755);
+        evict(m_capacity, std::string());
+        m_thread = std::thread([this]() { retireLoop(); });
+    }
+
+    ~TrackCache() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    TrackCache(const TrackCache&) = delete;
+    TrackCache& operator=(const TrackCache&) = delete;
+
+    const std::string& directory() const { return m_dir; }
+    uint64_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief Open (or create) the entry for @p uri with @p size bytes
+     * @return nullptr if the source can't be cached (size unknown/too large, disk full)
+     */
+    std::shared_ptr<Entry> acquire(const std::string& uri, int64_t size) {
+        if (size <= 0 || static_cast<uint64_t>(size) > m_capacity) return nullptr;
+        std::string key = makeKey(uri, size);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            auto live = m_live.find(key);
+            if (live != m_live.end()) {
+                if (auto e = live->second.lock()) return e;
+            }
+            // Same key still queued for writeback: finish that first (files are reused)
+            auto pending = std::find_if(m_retireQueue.begin(), m_retireQueue.end(),
+                                        [&](const Entry* q) { return q->m_key == key; });
+            if (pending != m_retireQueue.end()) {
+                Entry* e = *pending;
+                m_retireQueue.erase(pending);
+                retire(e, lock);
+                continue;   // Lock was released: look again
+            }
+            if (m_retiring.count(key) == 0) break;
+            m_cv.wait(lock);
+        }
+
+        std::unique_ptr<Entry> e(new Entry);
+        e->m_key = key;
+        e->m_uri = uri;
+        e->m_size = size;
+        e->m_numBlocks = static_cast<size_t>((size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        e->m_blocks.reset(new std::atomic<uint8_t>[e->m_numBlocks]);
+        for (size_t i = 0; i < e->m_numBlocks; i++) e->m_blocks[i].store(0, std::memory_order_relaxed);
+
+        struct stat st;
+        bool resumed = stat(dataPath(key).c_str(), &st) == 0 && st.st_size == size && loadMap(*e);
+        if (!resumed) {
+            // New or mismatched entry: make room, then reserve the space up front
+            // (a sparse mapping would SIGBUS on a full disk)
+            unlink(dataPath(key).c_str());
+            unlink(mapPath(key).c_str());
+            evict(m_capacity - static_cast<uint64_t>(size), key);
+        }
+
+        e->m_fd = open(dataPath(key).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (e->m_fd < 0) return nullptr;
+        if (!resumed && posix_fallocate(e->m_fd, 0, size) != 0) {
+            close(e->m_fd);
+            unlink(dataPath(key).c_str());
+            return nullptr;
+        }
+        void* p = mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, e->m_fd, 0);
+        if (p == MAP_FAILED) {
+            close(e->m_fd);
+            return nullptr;
+        }
+        e->m_data = static_cast<uint8_t*>(p);
+
+        std::shared_ptr<Entry> shared(e.release(), [this](Entry* released) {
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_retireQueue.push_back(released);
+            }
+            m_cv.notify_all();
+        });
+        m_live[key] = shared;
+        return shared;
+    }
+
+    /** @brief Wait until all released entries have been written back */
+    void flush() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]() { return m_retireQueue.empty() && m_retiring.empty(); });
+    }
+
+private:
+    std::string dataPath(const std::string& key) const { return m_dir + "/" + key + ".data"; }
+    std::string mapPath(const std::string& key) const { return m_dir + "/" + key + ".map"; }
+
+    static std::string makeKey(const std::string& uri, int64_t size) {
+        uint64_t h = 14695981039346656037ULL;   // FNV-1a 64
+        auto mix = [&h](const void* p, size_t n) {
+            const uint8_t* b = static_cast<const uint8_t*>(p);
+            for (size_t i = 0; i < n; i++) { h ^= b[i]; h *= 1099511628211ULL; }
+        };
+        mix(uri.data(), uri.size());
+        mix(&size, sizeof(size));
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+        return buf;
+    }
+
+    // Map file: "<magic> <size> <block size>\n<uri>\n" + one byte per block
+    bool loadMap(Entry& e) {
+        std::ifstream in(mapPath(e.m_key), std::ios::binary);
+        if (!in) return false;
+        std::string magic, uri;
+        int64_t size = 0;
+        size_t blockSize = 0;
+        in >> magic >> size >> blockSize;
+        in.ignore(1);
+        std::getline(in, uri);
+        if (!in || magic != MAP_MAGIC || size != e.m_size || blockSize != BLOCK_SIZE || uri != e.m_uri) {
+            return false;
+        }
+        std::vector<char> bits(e.m_numBlocks);
+        if (!in.read(bits.data(), static_cast<std::streamsize>(bits.size()))) return false;
+        for (size_t i = 0; i < bits.size(); i++) {
+            if (bits[i]) e.mark(i);
+        }
+        return true;
+    }
+
+    void saveMap(const Entry& e) {
+        std::string tmp = mapPath(e.m_key) + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) return;
+            out << MAP_MAGIC << " " << e.m_size << " " << BLOCK_SIZE << "\n" << e.m_uri << "\n";
+            for (size_t i = 0; i < e.m_numBlocks; i++) out.put(e.has(i) ? 1 : 0);
+            if (!out.flush()) return;
+        }
+        std::rename(tmp.c_str(), mapPath(e.m_key).c_str());
+    }
+
+    // Write back an entry already taken off m_retireQueue. @p lock holds m_mutex
+    // and is released for the sync: a full-file msync can take seconds
+    void retire(Entry* e, std::unique_lock<std::mutex>& lock) {
+        std::string key = e->m_key;
+        m_retiring.insert(key);
+        lock.unlock();
+
+        if (e->m_data) {
+            // Data must be on disk before the map claims it
+            msync(e->m_data, static_cast<size_t>(e->m_size), MS_SYNC);
+            munmap(e->m_data, static_cast<size_t>(e->m_size));
+        }
+        if (e->m_fd >= 0) close(e->m_fd);
+        saveMap(*e);   // Also refreshes the LRU timestamp
+        delete e;
+
+        lock.lock();
+        m_retiring.erase(key);
+        auto live = m_live.find(key);
+        if (live != m_live.end() && live->second.expired()) m_live.erase(live);
+        m_cv.notify_all();
+    }
+
+    void retireLoop() {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this]() { return m_stop || !m_retireQueue.empty(); });
+            if (m_retireQueue.empty()) break;   // Stop requested, queue drained
+            Entry* e = m_retireQueue.front();
+            m_retireQueue.pop_front();
+            retire(e, lock);
+        }
+    }
+
+    // Delete least recently used entries until the cache holds <= target bytes.
+    // Entries that are open (m_live), being written back or @p keep are never removed.
+    void evict(uint64_t target, const std::string& keep) {
+        struct File { std::string key; uint64_t bytes; int64_t mtime; };
+        std::map<std::string, File> files;
+        DIR* d = opendir(m_dir.c_str());
+        if (!d) return;
+        while (struct dirent* ent = readdir(d)) {
+            std::string name = ent->d_name;
+            size_t dot = name.find('.');
+            if (dot == std::string::npos || name[0] == '.') continue;
+            std::string key = name.substr(0, dot);
+            struct stat st;
+            if (stat((m_dir + "/" + name).c_str(), &st) != 0) continue;
+            File& f = files[key];
+            f.key = key;
+            f.bytes += static_cast<uint64_t>(st.st_blocks) * 512;
+            f.mtime = std::max<int64_t>(f.mtime, st.st_mtime);
+        }
+        closedir(d);
+
+        uint64_t total = 0;
+        std::vector<File> candidates;
+        for (const auto& kv : files) {
+            total += kv.second.bytes;
+            auto live = m_live.find(kv.first);
+            bool open = (live != m_live.end() && !live->second.expired()) || m_retiring.count(kv.first) > 0;
+            if (!open && kv.first != keep) candidates.push_back(kv.second);
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const File& a, const File& b) { return a.mtime < b.mtime; });
+        for (const File& f : candidates) {
+            if (total <= target) break;
+            unlink(dataPath(f.key).c_str());
+            unlink(mapPath(f.key).c_str());
+            unlink((mapPath(f.key) + ".tmp").c_str());
+            total -= std::min(total, f.bytes);
+        }
+    }
+
+    std::string m_dir;
+    uint64_t m_capacity;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<std::string, std::weak_ptr<Entry>> m_live;   // Protected by m_mutex
+    std::deque<Entry*> m_retireQueue;                     // Protected by m_mutex
+    std::set<std::string> m_retiring;                     // Keys written back outside m_mutex
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+#endif // TRACK_CACHE_H
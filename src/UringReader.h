@@ -0,0 +1,413 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file UringReader.h
+ * @brief Local-file source with io_uring read-ahead, for file:// tracks
+ *
+ * FFmpeg's file protocol issues one blocking read() per 32KB AVIO buffer on
+ * the thread that demuxes, i.e. the audio thread; on NFS or a busy disk a
+ * single read can stall it. UringFileReader keeps up to @p depth reads of
+ * CHUNK_SIZE in flight ahead of the read position, submitted in batches with
+ * one io_uring_enter(), and read() only copies finished blocks. No thread is
+ * involved: the kernel completes the reads while the caller plays audio.
+ *
+ * Block buffers are registered with the ring (READ_FIXED) when RLIMIT_MEMLOCK
+ * allows, plain READV otherwise. The ring is set up with raw syscalls, so no
+ * liburing is needed; open() returns -ENOSYS where io_uring is unavailable
+ * (old kernel, seccomp) and the caller falls back to FFmpeg.
+ *
+ * read()/seek() follow HttpReadAhead's ReadFn/SeekFn conventions and are
+ * called from a single thread.
+ */
+
+#ifndef URING_READER_H
+#define URING_READER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// <linux/fs.h> (via io_uring.h) defines BLOCK_SIZE, a name TrackCache uses
+#ifdef BLOCK_SIZE
+#undef BLOCK_SIZE
+#endif
+
+class UringFileReader {
+public:
+    static constexpr unsigned DEFAULT_DEPTH = 8;
+    static constexpr size_t CHUNK_SIZE = 256 << 10;
+
+    struct Stats {
+        uint64_t reads = 0;            // Completed block reads (including resubmitted short reads)
+        uint64_t submits = 0;          // io_uring_enter() calls that submitted
+        uint64_t waits = 0;            // read() calls that had to wait for the kernel
+        uint64_t bytes = 0;            // Handed to the caller
+        bool fixedBuffers = false;     // Registered buffers (READ_FIXED)
+    };
+
+    explicit UringFileReader(unsigned depth = DEFAULT_DEPTH) : m_depth(std::max(1u, depth)) {}
+
+    ~UringFileReader() { close(); }
+
+    UringFileReader(const UringFileReader&) = delete;
+    UringFileReader& operator=(const UringFileReader&) = delete;
+
+    /** @return 0, or -errno (-ENOSYS: no io_uring on this system) */
+    int open(const std::string& path) {
+        close();
+        m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0) return -errno;
+        struct stat st;
+        if (fstat(m_fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+            close();
+            return -EINVAL;
+        }
+        m_size = st.st_size;
+
+        int ret = setupRing();
+        if (ret < 0) {
+            close();
+            return ret;
+        }
+        fill();
+        return 0;
+    }
+
+    void close() {
+        // The kernel may still write into the block buffers
+        while (m_inFlight > 0 && reapOrWait() == 0) {}
+        if (m_sqes) munmap(m_sqes, m_sqesSize);
+        if (m_cqRing && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+        if (m_sqRing) munmap(m_sqRing, m_sqRingSize);
+        if (m_ringFd >= 0) ::close(m_ringFd);   // Also unregisters the buffers
+        if (m_buffers) munmap(m_buffers, m_buffersSize);
+        if (m_fd >= 0) ::close(m_fd);
+        m_sqes = nullptr;
+        m_sqRing = m_cqRing = m_buffers = nullptr;
+        m_ringFd = m_fd = -1;
+        m_slots.clear();
+        m_order.clear();
+        m_free.clear();
+        m_inFlight = m_pendingSubmit = 0;
+        m_pos = m_nextOffset = 0;
+        m_size = -1;
+    }
+
+    int64_t size() const { return m_size; }
+    int64_t position() const { return m_pos; }
+
+    /** @return Bytes read, 0 at the end of the file, or -errno */
+    int read(uint8_t* dst, int size) {
+        if (m_ringFd < 0) return -EBADF;
+        if (m_pos >= m_size || size <= 0) return 0;
+        if (m_order.empty()) fill();
+        // After a seek every slot may still be reading for the old position:
+        // wait for them to come back rather than report EOF
+        while (m_order.empty() && m_inFlight > 0) {
+            int ret = reapOrWait();
+            if (ret < 0) return ret;
+            fill();
+        }
+        if (m_order.empty()) return 0;
+
+        Slot& s = m_slots[m_order.front()];
+        if (!s.done) {
+            reap();
+            if (!s.done) m_stats.waits++;
+            while (!s.done) {
+                int ret = reapOrWait();
+                if (ret < 0) return ret;
+            }
+        }
+        if (s.error < 0) return s.error;
+
+        size_t off = static_cast<size_t>(m_pos - s.offset);
+        if (off >= s.got) return 0;   // File shrank under us
+        size_t n = std::min(static_cast<size_t>(size), s.got - off);
+        std::memcpy(dst, s.buf + off, n);
+        m_pos += static_cast<int64_t>(n);
+        m_stats.bytes += n;
+        if (off + n == s.got) {
+            m_free.push_back(m_order.front());
+            m_order.pop_front();
+            fill();
+        }
+        return static_cast<int>(n);
+    }
+
+    /** @brief Keep blocks already read past @p pos, restart read-ahead otherwise */
+    int64_t seek(int64_t pos) {
+        if (m_ringFd < 0) return -EBADF;
+        if (pos < 0) return -EINVAL;
+        bool ahead = !m_order.empty() && pos >= m_slots[m_order.front()].offset && pos < m_nextOffset;
+        while (!m_order.empty()) {
+            Slot& s = m_slots[m_order.front()];
+            if (ahead && pos < s.offset + static_cast<int64_t>(s.want)) break;
+            release(m_order.front());
+            m_order.pop_front();
+        }
+        if (!ahead) m_nextOffset = pos;
+        m_pos = pos;
+        fill();
+        return pos;
+    }
+
+    Stats getStats() const { return m_stats; }
+
+private:
+    struct Slot {
+        uint8_t* buf = nullptr;
+        int64_t offset = 0;
+        size_t want = 0;
+        size_t got = 0;
+        int error = 0;
+        bool inFlight = false;
+        bool done = false;
+        bool stale = false;            // Dropped by seek() while the kernel still reads into it
+        struct iovec iov{};
+    };
+
+    static int sysSetup(unsigned entries, io_uring_params* p) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+    }
+    int sysEnter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, m_ringFd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    int setupRing() {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        m_ringFd = sysSetup(m_depth, &p);
+        if (m_ringFd < 0) return -errno;
+
+        m_sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        m_cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+
+        m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        m_ringFd, IORING_OFF_SQ_RING);
+        if (m_sqRing == MAP_FAILED) { m_sqRing = nullptr; return -errno; }
+        if (single) {
+            m_cqRing = m_sqRing;
+        } else {
+            m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            m_ringFd, IORING_OFF_CQ_RING);
+            if (m_cqRing == MAP_FAILED) { m_cqRing = nullptr; return -errno; }
+        }
+        m_sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          m_ringFd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return -errno;
+        m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<uint8_t*>(m_sqRing);
+        auto* cq = static_cast<uint8_t*>(m_cqRing);
+        m_sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        m_cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+        // One contiguous allocation, one registered buffer per slot
+        m_buffersSize = static_cast<size_t>(m_depth) * CHUNK_SIZE;
+        m_buffers = mmap(nullptr, m_buffersSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m_buffers == MAP_FAILED) { m_buffers = nullptr; return -ENOMEM; }
+        m_slots.assign(m_depth, Slot{});
+        std::vector<struct iovec> iovs(m_depth);
+        for (unsigned i = 0; i < m_depth; i++) {
+            m_slots[i].buf = static_cast<uint8_t*>(m_buffers) + static_cast<size_t>(i) * CHUNK_SIZE;
+            iovs[i].iov_base = m_slots[i].buf;
+            iovs[i].iov_len = CHUNK_SIZE;
+            m_free.push_back(m_depth - 1 - i);
+        }
+        m_stats.fixedBuffers = syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_BUFFERS,
+                                       iovs.data(), m_depth) == 0;
+        return 0;
+    }
+
+    void queue(unsigned index) {
+        Slot& s = m_slots[index];
+        unsigned tail = *m_sqTail;
+        unsigned i = tail & m_sqMask;
+        io_uring_sqe* sqe = &m_sqes[i];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->fd = m_fd;
+        sqe->off = static_cast<uint64_t>(s.offset) + s.got;
+        sqe->user_data = index;
+        // Straight to a kernel worker: a cached read would otherwise be copied
+        // inline, i.e. in io_uring_enter() on the caller's (audio) thread
+        sqe->flags = IOSQE_ASYNC;
+        if (m_stats.fixedBuffers) {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->addr = reinterpret_cast<uint64_t>(s.buf + s.got);
+            sqe->len = static_cast<uint32_t>(s.want - s.got);
+            sqe->buf_index = static_cast<uint16_t>(index);
+        } else {
+            s.iov.iov_base = s.buf + s.got;
+            s.iov.iov_len = s.want - s.got;
+            sqe->opcode = IORING_OP_READV;
+            sqe->addr = reinterpret_cast<uint64_t>(&s.iov);
+            sqe->len = 1;
+        }
+        m_sqArray[i] = i;
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+        s.inFlight = true;
+        m_inFlight++;
+        m_pendingSubmit++;
+    }
+
+    void submit() {
+        while (m_pendingSubmit > 0) {
+            int ret = sysEnter(m_pendingSubmit, 0, 0);
+            if (ret < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                failUnsubmitted(-errno);
+                break;
+            }
+            m_stats.submits++;
+            m_pendingSubmit -= std::min(m_pendingSubmit, static_cast<unsigned>(ret));
+        }
+    }
+
+    // The kernel took none of the pending entries: take them back off the
+    // submission ring and fail their slots, so read() returns the error
+    // instead of waiting for completions that will never come
+    void failUnsubmitted(int error) {
+        unsigned tail = *m_sqTail;
+        for (unsigned k = 1; k <= m_pendingSubmit; k++) {
+            auto index = static_cast<unsigned>(m_sqes[(tail - k) & m_sqMask].user_data);
+            Slot& s = m_slots[index];
+            s.inFlight = false;
+            m_inFlight--;
+            if (s.stale) {
+                s.stale = false;
+                m_free.push_back(index);
+            } else {
+                s.error = error;
+                s.done = true;
+            }
+        }
+        __atomic_store_n(m_sqTail, tail - m_pendingSubmit, __ATOMIC_RELEASE);
+        m_pendingSubmit = 0;
+    }
+
+    // Queue the blocks after the last one, up to depth, in one submission
+    void fill() {
+        while (!m_free.empty() && m_nextOffset < m_size) {
+            unsigned index = m_free.back();
+            m_free.pop_back();
+            Slot& s = m_slots[index];
+            s.offset = m_nextOffset;
+            s.want = static_cast<size_t>(std::min<int64_t>(CHUNK_SIZE, m_size - m_nextOffset));
+            s.got = 0;
+            s.error = 0;
+            s.done = s.stale = false;
+            m_nextOffset += static_cast<int64_t>(s.want);
+            queue(index);
+            m_order.push_back(index);
+        }
+        submit();
+    }
+
+    void release(unsigned index) {
+        Slot& s = m_slots[index];
+        if (s.inFlight) s.stale = true;   // Freed once the kernel is done with it
+        else m_free.push_back(index);
+    }
+
+    void complete(unsigned index, int res) {
+        Slot& s = m_slots[index];
+        s.inFlight = false;
+        m_inFlight--;
+        m_stats.reads++;
+        if (s.stale) {
+            s.stale = false;
+            m_free.push_back(index);
+            return;
+        }
+        if (res == -EAGAIN || res == -EINTR) {
+            queue(index);
+        } else if (res < 0) {
+            s.error = res;
+            s.done = true;
+        } else {
+            s.got += static_cast<size_t>(res);
+            if (res > 0 && s.got < s.want) queue(index);   // Short read (NFS): read the rest
+            else s.done = true;
+        }
+    }
+
+    void reap() {
+        unsigned head = *m_cqHead;
+        unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+            unsigned index = static_cast<unsigned>(cqe.user_data);
+            int res = cqe.res;
+            head++;
+            __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+            complete(index, res);
+        }
+        submit();   // Resubmitted short reads
+    }
+
+    // Reap what is there; if nothing, block for one completion
+    int reapOrWait() {
+        unsigned before = m_inFlight;
+        reap();
+        if (m_inFlight < before || m_inFlight == 0) return 0;
+        int ret = sysEnter(0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR) return -errno;
+        reap();
+        return 0;
+    }
+
+    const unsigned m_depth;
+    int m_fd = -1;
+    int m_ringFd = -1;
+    int64_t m_size = -1;
+    int64_t m_pos = 0;
+    int64_t m_nextOffset = 0;          // File offset of the next block to queue
+
+    void* m_sqRing = nullptr;
+    void* m_cqRing = nullptr;
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    size_t m_sqesSize = 0;
+    unsigned* m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned* m_sqArray = nullptr;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe* m_cqes = nullptr;
+
+    void* m_buffers = nullptr;
+    size_t m_buffersSize = 0;
+    std::vector<Slot> m_slots;
+    std::deque<unsigned> m_order;      // Slots with consecutive blocks from m_pos, in file order
+    std::vector<unsigned> m_free;
+    unsigned m_inFlight = 0;
+    unsigned m_pendingSubmit = 0;
+    Stats m_stats;
+};
+
+#endif // URING_READER_H
@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file WireMarkers.h
+ * @brief In-band track/position markers attached to ring buffer offsets
+ *
+ * Decoded position and track changes run ahead of the DAC by the ring
+ * buffer depth (~0.3-3s). The producer attaches a marker to the current ring
+ * write offset; getNewStream() releases it once the marked byte has been
+ * handed to the SDK. Events are reported from a dispatcher thread.
+ *
+ * - Producer (sendAudio thread): mark() + onRingWrite()
+ * - Consumer (SDK worker): onRingRead() - no locks, no allocation, no syscalls
+ * - Dispatcher (nice +10): polls released events and calls the handler
+ *
+ * Offsets are in ring bytes (ring format, i.e. source samples in
+ * convert-on-pop mode) counted from the last ring clear. Each side tracks
+ * the ring's clearCount(); markers from an older ring stream are released
+ * immediately as "flushed" (track markers) or dropped (position markers).
+ */
+
+#ifndef WIRE_MARKERS_H
+#define WIRE_MARKERS_H
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+class WireMarkers {
+public:
+    static constexpr size_t QUEUE_SIZE = 256;            // Power of 2
+    static constexpr int DISPATCH_POLL_MS = 5;
+
+    enum class Kind : uint8_t { Track, Position };
+
+    struct Event {
+        Kind kind = Kind::Position;
+        bool flushed = false;          // Ring was cleared before the marker reached the wire
+        uint32_t track = 0;            // Producer-defined track sequence
+        uint64_t frame = 0;            // Source frame position at the marked byte
+        uint32_t sampleRate = 0;
+        int64_t latencyNs = 0;         // Decode (mark) to wire (getNewStream), 0 if flushed
+    };
+
+    struct Stats {
+        uint64_t released = 0;
+        uint64_t flushed = 0;
+        uint64_t dropped = 0;          // Queue full (producer side)
+        int64_t lastLatencyNs = 0;
+        int64_t meanLatencyNs = 0;
+        int64_t maxLatencyNs = 0;
+    };
+
+    using Handler = std::function<void(const Event&)>;
+
+    WireMarkers() = default;
+    ~WireMarkers() { stop(); }
+
+    WireMarkers(const WireMarkers&) = delete;
+    WireMarkers& operator=(const WireMarkers&) = delete;
+
+    void start(Handler handler) {
+        if (m_enabled.load(std::memory_order_acquire)) return;
+        m_handler = std::move(handler);
+        m_stop.store(false, std::memory_order_release);
+        m_thread = std::thread([this]() { dispatchLoop(); });
+        // Published last: other threads see the handler and dispatcher once enabled
+        m_enabled.store(true, std::memory_order_release);
+    }
+
+    void stop() {
+        if (!m_enabled.load(std::memory_order_acquire)) return;
+        m_enabled.store(false, std::memory_order_release);
+        m_stop.store(true, std::memory_order_release);
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    bool enabled() const { return m_enabled.load(std::memory_order_acquire); }
+
+    //=========================================================================
+    // Producer side (sendAudio thread only)
+    //=========================================================================
+
+    /** @brief Account bytes written to the ring in stream @p epoch */
+    void onRingWrite(size_t ringBytes, uint32_t epoch) {
+        syncWriteEpoch(epoch);
+        m_writeOffset += ringBytes;
+    }
+
+    /**
+     * @brief Attach a marker to the next byte written to the ring
+     * @return false if the queue is full (marker dropped)
+     */
+    bool mark(Kind kind, uint32_t track, uint64_t frame, uint32_t sampleRate,
+              int64_t nowNs, uint32_t epoch) {
+        syncWriteEpoch(epoch);
+        size_t head = m_markHead.load(std::memory_order_relaxed);
+        if (head - m_markTail.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Marker& m = m_markers[head & (QUEUE_SIZE - 1)];
+        m.kind = kind;
+        m.track = track;
+        m.frame = frame;
+        m.sampleRate = sampleRate;
+        m.ingestNs = nowNs;
+        m.offset = m_writeOffset;
+        m.epoch = epoch;
+        m_markHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //=========================================================================
+    // Consumer side (getNewStream only)
+    //=========================================================================
+
+    /**
+     * @brief Account bytes popped from the ring and release reached markers
+     * @param epoch Ring clearCount() read before the pop
+     */
+    void onRingRead(size_t ringBytes, uint32_t epoch, int64_t nowNs) {
+        if (epoch != m_readEpoch) {
+            m_readEpoch = epoch;
+            m_readOffset = 0;
+        }
+        m_readOffset += ringBytes;
+
+        size_t tail = m_markTail.load(std::memory_order_relaxed);
+        size_t head = m_markHead.load(std::memory_order_acquire);
+        while (tail != head) {
+            const Marker& m = m_markers[tail & (QUEUE_SIZE - 1)];
+            bool stale = static_cast<int32_t>(m.epoch - epoch) < 0;
+            if (!stale && (m.epoch != epoch || m.offset >= m_readOffset)) break;
+
+            // Track markers survive a ring clear (the track did start); positions don't
+            if (!stale || m.kind == Kind::Track) {
+                Event e;
+                e.kind = m.kind;
+                e.flushed = stale;
+                e.track = m.track;
+                e.frame = m.frame;
+                e.sampleRate = m.sampleRate;
+                e.latencyNs = stale ? 0 : nowNs - m.ingestNs;
+                if (!releaseEvent(e)) break;   // Dispatcher behind: retry next callback
+            }
+            tail++;
+        }
+        m_markTail.store(tail, std::memory_order_release);
+    }
+
+    Stats getStats() const {
+        Stats s;
+        s.released = m_released.load(std::memory_order_relaxed);
+        s.flushed = m_flushed.load(std::memory_order_relaxed);
+        s.dropped = m_dropped.load(std::memory_order_relaxed);
+        s.lastLatencyNs = m_lastLatencyNs.load(std::memory_order_relaxed);
+        s.maxLatencyNs = m_maxLatencyNs.load(std::memory_order_relaxed);
+        uint64_t timed = s.released - s.flushed;
+        s.meanLatencyNs = timed > 0
+            ? m_latencySumNs.load(std::memory_order_relaxed) / static_cast<int64_t>(timed) : 0;
+        return s;
+    }
+
+    /**
+     * @brief Deliver released events on the calling thread
+     *
+     * Used by the dispatcher thread; exposed for single-threaded tests.
+     * @return Number of events delivered
+     */
+    size_t dispatchPending() {
+        size_t n = 0;
+        size_t tail = m_eventTail.load(std::memory_order_relaxed);
+        size_t head = m_eventHead.load(std::memory_order_acquire);
+        while (tail != head) {
+            Event e = m_events[tail & (QUEUE_SIZE - 1)];
+            m_eventTail.store(++tail, std::memory_order_release);
+            if (m_handler) m_handler(e);
+            n++;
+        }
+        return n;
+    }
+
+    void setHandler(Handler handler) { m_handler = std::move(handler); }
+
+private:
+    struct Marker {
+        Kind kind;
+        uint32_t track;
+        uint64_t frame;
+        uint32_t sampleRate;
+        int64_t ingestNs;
+        uint64_t offset;
+        uint32_t epoch;
+    };
+
+    void syncWriteEpoch(uint32_t epoch) {
+        if (epoch != m_writeEpoch) {
+            m_writeEpoch = epoch;
+            m_writeOffset = 0;
+        }
+    }
+
+    bool releaseEvent(const Event& e) {
+        size_t head = m_eventHead.load(std::memory_order_relaxed);
+        if (head - m_eventTail.load(std::memory_order_acquire) >= QUEUE_SIZE) return false;
+        m_events[head & (QUEUE_SIZE - 1)] = e;
+        m_eventHead.store(head + 1, std::memory_order_release);
+
+        m_released.store(m_released.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (e.flushed) {
+            m_flushed.store(m_flushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        } else {
+            m_lastLatencyNs.store(e.latencyNs, std::memory_order_relaxed);
+            m_latencySumNs.store(m_latencySumNs.load(std::memory_order_relaxed) + e.latencyNs,
+                                 std::memory_order_relaxed);
+            if (e.latencyNs > m_maxLatencyNs.load(std::memory_order_relaxed)) {
+                m_maxLatencyNs.store(e.latencyNs, std::memory_order_relaxed);
+            }
+        }
+        return true;
+    }
+
+    void dispatchLoop() {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+        while (!m_stop.load(std::memory_order_acquire)) {
+            dispatchPending();
+            std::this_thread::sleep_for(std::chrono::milliseconds(DISPATCH_POLL_MS));
+        }
+        dispatchPending();
+    }
+
+    // Producer -> consumer marker queue
+    std::array<Marker, QUEUE_SIZE> m_markers{};
+    std::atomic<size_t> m_markHead{0};
+    std::atomic<size_t> m_markTail{0};
+    uint64_t m_writeOffset = 0;        // Producer only
+    uint32_t m_writeEpoch = 0;
+    uint64_t m_readOffset = 0;         // Consumer only
+    uint32_t m_readEpoch = 0;
+
+    // Consumer -> dispatcher event queue
+    std::array<Event, QUEUE_SIZE> m_events{};
+    std::atomic<size_t> m_eventHead{0};
+    std::atomic<size_t> m_eventTail{0};
+
+    // Stats (written by consumer, except m_dropped)
+    std::atomic<uint64_t> m_released{0};
+    std::atomic<uint64_t> m_flushed{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<int64_t> m_lastLatencyNs{0};
+    std::atomic<int64_t> m_latencySumNs{0};
+    std::atomic<int64_t> m_maxLatencyNs{0};
+
+    Handler m_handler;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_enabled{false};     // Read by audio and UPnP threads
+};
+
+#endif // WIRE_MARKERS_H
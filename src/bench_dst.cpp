@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file bench_dst.cpp
+ * @brief DST decode throughput: frames/s in total and per worker thread
+ *
+ * A DST frame is 1/75 s at every rate, so real time needs 75 frames/s; the
+ * per-frame cost grows with the DSD rate. Decodes the frames of a
+ * DST-compressed .dff, or synthetic worst-case frames (128-tap filters)
+ * when no file is given, through DstFramePool with 1..N workers.
+ *
+ *   make bench
+ *   ./bin/bench_dst [--file track.dff] [--rate 64|128|256] [--threads N] [--frames N]
+ */
+
+#include "DstDecoder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+uint64_t be(const uint8_t* p, int n) {
+    uint64_t v = 0;
+    for (int i = 0; i < n; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+// Collect the DSTF frame chunks of a DST-compressed DSDIFF file
+bool loadDff(const std::string& path, std::vector<std::vector<uint8_t>>& frames,
+             uint32_t& sampleRate, unsigned& channels) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> f((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (f.size() < 16 || std::memcmp(f.data(), "FRM8", 4) != 0 || std::memcmp(f.data() + 12, "DSD ", 4) != 0) {
+        return false;
+    }
+    size_t pos = 16;
+    while (pos + 12 <= f.size()) {
+        const uint8_t* c = f.data() + pos;
+        uint64_t size = be(c + 4, 8);
+        size_t end = std::min(f.size(), static_cast<size_t>(pos + 12 + size));
+        if (std::memcmp(c, "PROP", 4) == 0) {
+            for (size_t p = pos + 16; p + 12 <= end;) {
+                const uint8_t* s = f.data() + p;
+                uint64_t sub = be(s + 4, 8);
+                if (std::memcmp(s, "FS  ", 4) == 0) sampleRate = static_cast<uint32_t>(be(s + 12, 4));
+                if (std::memcmp(s, "CHNL", 4) == 0) channels = static_cast<unsigned>(be(s + 12, 2));
+                p += 12 + sub + (sub & 1);
+            }
+        } else if (std::memcmp(c, "DST ", 4) == 0) {
+            for (size_t p = pos + 12; p + 12 <= end;) {
+                const uint8_t* s = f.data() + p;
+                uint64_t sub = be(s + 4, 8);
+                if (std::memcmp(s, "DSTF", 4) == 0 && p + 12 + sub <= end) {
+                    frames.emplace_back(s + 12, s + 12 + sub);
+                }
+                p += 12 + sub + (sub & 1);
+            }
+        }
+        pos += 12 + size + (size & 1);
+    }
+    return !frames.empty() && sampleRate > 0 && channels > 0;
+}
+
+// Same layout as the unit test's synthetic frame: full-length filters, random payload
+std::vector<uint8_t> syntheticFrame(unsigned channels, size_t bytesPerChannel, uint32_t seed) {
+    std::vector<uint8_t> out;
+    uint32_t acc = 0;
+    int nbits = 0;
+    auto put = [&](uint32_t v, int n) {
+        for (int i = n - 1; i >= 0; i--) {
+            acc = (acc << 1) | ((v >> i) & 1);
+            if (++nbits == 8) { out.push_back(static_cast<uint8_t>(acc)); acc = 0; nbits = 0; }
+        }
+    };
+    auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    put(1, 1); put(7, 3); put(1, 1); put(1, 1);
+    for (unsigned ch = 0; ch < channels; ch++) put(0, 1);
+    put(127, 7); put(0, 1);
+    for (int i = 0; i < 128; i++) put(static_cast<uint32_t>(static_cast<int>(rnd() % 41) - 20) & 0x1FF, 9);
+    put(63, 6); put(0, 1);
+    for (int i = 0; i < 64; i++) put(rnd() & 0x7F, 7);
+    put(0, 1);
+    while (nbits) put(rnd() & 1, 1);
+    for (size_t i = 0; i < bytesPerChannel * channels; i++) out.push_back(static_cast<uint8_t>(rnd()));
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string file;
+    int rate = 64;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    size_t numFrames = 300;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--file" && i + 1 < argc) file = argv[++i];
+        else if (arg == "--rate" && i + 1 < argc) rate = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) maxThreads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc) numFrames = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cout << "Usage: " << argv[0]
+                      << " [--file track.dff] [--rate 64|128|256] [--threads N] [--frames N]" << std::endl;
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> frames;
+    uint32_t sampleRate = 44100u * static_cast<uint32_t>(rate);
+    unsigned channels = 2;
+    if (!file.empty()) {
+        if (!loadDff(file, frames, sampleRate, channels)) {
+            std::cerr << "Not a DST-compressed DSDIFF file: " << file << std::endl;
+            return 1;
+        }
+        if (frames.size() > numFrames) frames.resize(numFrames);
+    } else {
+        for (size_t f = 0; f < numFrames; f++) {
+            frames.push_back(syntheticFrame(channels, sampleRate / 75 / 8, static_cast<uint32_t>(f)));
+        }
+    }
+    const size_t perCh = sampleRate / 75 / 8;
+
+    std::cout << "DST decode: DSD" << sampleRate / 44100 << " " << channels << "ch, "
+              << frames.size() << " frames (" << (file.empty() ? "synthetic" : file) << ")" << std::endl;
+    std::cout << "threads    frames/s   per thread   x real time" << std::endl;
+
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    for (unsigned threads : counts) {
+        DstFramePool pool(threads, channels, perCh);
+        std::vector<uint8_t> out;
+        size_t submitted = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t f = 0; f < frames.size(); f++) {
+            while (submitted < frames.size() && pool.inFlight() < 2 * threads) {
+                pool.submit(frames[submitted].data(), frames[submitted].size());
+                submitted++;
+            }
+            pool.next(out);
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        double fps = frames.size() / secs;
+        DstFramePool::Stats st = pool.getStats();
+
+        std::printf("%7u %11.1f %12.1f %13.2f%s\n", threads, fps, fps / threads, fps / 75.0,
+                    st.errors ? "  (decode errors)" : "");
+    }
+    return 0;
+}
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: MIT
+// This file is part of DirettaRendererUPnP.
+// See LICENSE for copyright holders and terms.
+
+/**
+ * @file bench_io.cpp
+ * @brief Local-file read path: FFmpeg-style blocking reads vs io_uring vs mmap
+ *
+ * FFmpeg's file protocol does one read() per 32KB AVIO buffer on the audio
+ * thread; --io-uring replaces it with UringFileReader, --mmap with MappedFile
+ * (measured here as 32KB copies out of the mapping). For each backend this
+ * drops the file from the page cache (POSIX_FADV_DONTNEED, also on NFS) and
+ * measures:
+ *   - throughput: the whole file read as fast as possible, in MB/s and as a
+ *     multiple of the DSD512 and 768kHz/32-bit stereo data rates;
+ *   - paced: 32KB reads at the DSD512 rate, as playback consumes them; the
+ *     per-read latency (p99, max) is what the audio thread would stall for.
+ * Put --file on the library's disk (NVMe, NFS mount, ...) to compare them;
+ * without --file a temporary file is written to /tmp.
+ *
+ *   make bench
+ *   ./bin/bench_io [--file track.dsf] [--mb N] [--seconds N] [--depth N]
+ */
+
+#include "MappedFile.h"
+#include "UringReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int AVIO_BUF = 32768;                                  // FFmpeg's AVIO buffer
+constexpr double DSD512_BYTES_PER_SEC = 44100.0 * 512 * 2 / 8;   // Stereo, 1 bit
+constexpr double PCM768_BYTES_PER_SEC = 768000.0 * 2 * 4;        // Stereo, 32-bit
+
+using Clock = std::chrono::steady_clock;
+
+// One backend behind a common read(): 0 at the end, -errno on error
+struct Source {
+    virtual ~Source() = default;
+    virtual int read(uint8_t* dst, int size) = 0;
+};
+
+struct BlockingSource : Source {
+    int fd = -1;
+    ~BlockingSource() override { if (fd >= 0) ::close(fd); }
+    int open(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        return fd < 0 ? -errno : 0;
+    }
+    int read(uint8_t* dst, int size) override {
+        ssize_t n = ::read(fd, dst, static_cast<size_t>(size));
+        return n < 0 ? -errno : static_cast<int>(n);
+    }
+};
+
+struct UringSource : Source {
+    UringFileReader reader;
+    explicit UringSource(unsigned depth) : reader(depth) {}
+    int read(uint8_t* dst, int size) override { return reader.read(dst, size); }
+};
+
+struct MappedSource : Source {
+    MappedFile file;
+    int read(uint8_t* dst, int size) override { return file.read(dst, size); }
+};
+
+enum class Backend { Read, Uring, Mmap };
+
+void dropCache(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+std::unique_ptr<Source> openSource(Backend backend, const std::string& path, unsigned depth) {
+    dropCache(path);
+    if (backend == Backend::Mmap) {
+        auto s = std::make_unique<MappedSource>();
+        int ret = s->file.open(path);
+        if (ret < 0) {
+            std::cerr << "mmap failed: " << strerror(-ret) << std::endl;
+            return nullptr;
+        }
+        return s;
+    }
+    if (backend == Backend::Uring) {
+        auto s = std::make_unique<UringSource>(depth);
+        int ret = s->reader.open(path);
+        if (ret < 0) {
+            std::cerr << "io_uring open failed: " << strerror(-ret) << std::endl;
+            return nullptr;
+        }
+        return s;
+    }
+    auto s = std::make_unique<BlockingSource>();
+    if (s->open(path) < 0) {
+        std::cerr << "open failed: " << strerror(errno) << std::endl;
+        return nullptr;
+    }
+    return s;
+}
+
+// Bytes per second reading the whole file
+double throughput(Source& src) {
+    std::vector<uint8_t> buf(AVIO_BUF);
+    uint64_t total = 0;
+    auto t0 = Clock::now();
+    int n;
+    while ((n = src.read(buf.data(), AVIO_BUF)) > 0) total += static_cast<uint64_t>(n);
+    double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+    return secs > 0 ? total / secs : 0.0;
+}
+
+// Per-read latencies (us) of 32KB reads at the DSD512 rate for @p seconds
+std::vector<double> paced(Source& src, double seconds) {
+    std::vector<uint8_t> buf(AVIO_BUF);
+    std::vector<double> lat;
+    auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(AVIO_BUF / DSD512_BYTES_PER_SEC));
+    auto start = Clock::now();
+    auto next = start;
+    while (std::chrono::duration<double>(Clock::now() - start).count() < seconds) {
+        std::this_thread::sleep_until(next);
+        next += interval;
+        auto t0 = Clock::now();
+        if (src.read(buf.data(), AVIO_BUF) <= 0) break;
+        lat.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+    }
+    std::sort(lat.begin(), lat.end());
+    return lat;
+}
+
+bool writeTempFile(const std::string& path, size_t mb) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return false;
+    std::vector<uint8_t> block(1 << 20);
+    uint32_t seed = 1;
+    for (auto& b : block) { seed = seed * 1664525u + 1013904223u; b = static_cast<uint8_t>(seed >> 24); }
+    bool ok = true;
+    for (size_t i = 0; i < mb && ok; i++) {
+        ok = ::write(fd, block.data(), block.size()) == static_cast<ssize_t>(block.size());
+    }
+    ::close(fd);
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string file;
+    size_t mb = 512;
+    double seconds = 10.0;
+    unsigned depth = UringFileReader::DEFAULT_DEPTH;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--file" && i + 1 < argc) file = argv[++i];
+        else if (arg == "--mb" && i + 1 < argc) mb = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--seconds" && i + 1 < argc) seconds = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--depth" && i + 1 < argc) depth = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        else {
+            std::cout << "Usage: " << argv[0]
+                      << " [--file track.dsf] [--mb N] [--seconds N] [--depth N]" << std::endl;
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    bool temp = file.empty();
+    if (temp) {
+        file = "/tmp/diretta_bench_io_" + std::to_string(getpid());
+        if (!writeTempFile(file, mb)) {
+            std::cerr << "Cannot write " << file << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Local file I/O: " << file << " (io_uring depth " << depth << " x "
+              << (UringFileReader::CHUNK_SIZE >> 10) << " KB, page cache dropped per run)" << std::endl;
+    std::cout << "backend        MB/s   x DSD512   x 768k/32   paced p99 us   paced max us" << std::endl;
+
+    int status = 0;
+    const char* names[] = {"read()", "io_uring", "mmap"};
+    for (Backend backend : {Backend::Read, Backend::Uring, Backend::Mmap}) {
+        auto src = openSource(backend, file, depth);
+        if (!src) { status = 1; continue; }
+        double bps = throughput(*src);
+
+        src = openSource(backend, file, depth);
+        std::vector<double> lat = src ? paced(*src, seconds) : std::vector<double>();
+        double p99 = lat.empty() ? 0.0 : lat[std::min(lat.size() - 1, lat.size() * 99 / 100)];
+        double max = lat.empty() ? 0.0 : lat.back();
+
+        std::printf("%-10s %9.1f %10.1f %11.1f %14.0f %14.0f\n", names[static_cast<int>(backend)],
+                    bps / 1048576.0, bps / DSD512_BYTES_PER_SEC, bps / PCM768_BYTES_PER_SEC, p99, max);
+    }
+
+    if (temp) unlink(file.c_str());
+    return status;
+}
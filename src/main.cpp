@@ -280,6 +280,32 @@ DirettaRenderer::Config parseArguments(int argc, char* argv[]) {
         else if (arg == "--target-profile-limit" && i + 1 < argc) {
             config.targetProfileLimitTime = std::atoi(argv[++i]);
         }
+        else if (arg == "--worker-wait" && i + 1 < argc) {
+            config.workerWait = argv[++i];
+            if (config.workerWait != "sleep" && config.workerWait != "abstime" &&
+                config.workerWait != "timerfd") {
+                std::cerr << "Invalid worker-wait. Use: sleep, abstime, timerfd" << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--convert-on-pop") {
+            config.convertOnPop = true;
+        }
+        else if (arg == "--constant-work") {
+            config.constantWorkConsumer = true;
+        }
+        else if (arg == "--wire-markers") {
+            config.wireMarkers = true;
+        }
+        else if (arg == "--target-cache" && i + 1 < argc) {
+            config.targetCachePath = argv[++i];
+        }
+        else if (arg == "--verify-bitperfect") {
+            config.bitPerfectVerify = true;
+        }
+        else if (arg == "--tap-dump" && i + 1 < argc) {
+            config.tapDumpPath = argv[++i];
+        }
         else if (arg == "--mtu" && i + 1 < argc) {
             config.mtu = std::atoi(argv[++i]);
         }
@@ -332,6 +358,20 @@ DirettaRenderer::Config parseArguments(int argc, char* argv[]) {
                 }
             }
         }
+        else if (arg == "--cpu-demux" && i + 1 < argc) {
+            config.cpuDemux = argv[++i];
+            std::string onlineDesc;
+            auto online = getOnlineCpus(&onlineDesc);
+            auto cores = parseCoreSpec(config.cpuDemux);
+            for (int c : cores) {
+                if (online.find(c) == online.end()) {
+                    std::cerr << "Warning: --cpu-demux contains invalid core " << c
+                              << " (online CPUs: " << onlineDesc << ")" << std::endl;
+                    config.cpuDemux.clear();
+                    break;
+                }
+            }
+        }
         // Buffer configuration (v2.3.0)
         else if (arg == "--pcm-buffer-seconds" && i + 1 < argc) {
             config.pcmBufferSeconds = static_cast<float>(std::atof(argv[++i]));
@@ -351,6 +391,45 @@ DirettaRenderer::Config parseArguments(int argc, char* argv[]) {
         else if (arg == "--dsd-prefill-ms" && i + 1 < argc) {
             config.dsdPrefillMs = std::atoi(argv[++i]);
         }
+        else if (arg == "--http-buffer-mb" && i + 1 < argc) {
+            config.httpBufferMB = std::atoi(argv[++i]);
+        }
+        else if (arg == "--track-cache" && i + 1 < argc) {
+            config.trackCacheDir = argv[++i];
+        }
+        else if (arg == "--track-cache-mb" && i + 1 < argc) {
+            config.trackCacheMB = std::atoi(argv[++i]);
+        }
+        else if (arg == "--http-pool" && i + 1 < argc) {
+            config.httpPoolPerHost = std::atoi(argv[++i]);
+        }
+        else if (arg == "--http-connections" && i + 1 < argc) {
+            config.httpConnections = std::atoi(argv[++i]);
+        }
+        else if (arg == "--probe-cache") {
+            config.probeCache = true;
+        }
+        else if (arg == "--io-uring") {
+            config.ioUring = true;
+        }
+        else if (arg == "--mmap") {
+            config.mmapFiles = true;
+        }
+        else if (arg == "--memory-play-mb" && i + 1 < argc) {
+            config.memoryPlayMB = std::atoi(argv[++i]);
+        }
+        else if (arg == "--decode-ahead-mb" && i + 1 < argc) {
+            config.decodeAheadMB = std::atoi(argv[++i]);
+        }
+        else if (arg == "--preroll-ms" && i + 1 < argc) {
+            config.prerollMs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--dst-threads" && i + 1 < argc) {
+            config.dstThreads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--demux-packets" && i + 1 < argc) {
+            config.demuxPackets = std::atoi(argv[++i]);
+        }
         else if (arg == "--help" || arg == "-h") {
             std::cout << "Diretta UPnP Renderer (Simplified Architecture)\n\n"
                       << "Usage: " << argv[0] << " [options]\n\n"
@@ -384,11 +463,24 @@ DirettaRenderer::Config parseArguments(int argc, char* argv[]) {
                       << "  --target-profile-limit <us> Target profile limit time (0=SelfProfile (stable), default: 0, >0=experimental)\n"
                       << "  --mtu <bytes>              MTU override (default: auto-detect)\n"
                       << "  --rt-priority <1-99>       SCHED_FIFO real-time priority for worker thread (default: 50)\n"
+                      << "  --worker-wait <mode>       Worker idle wait: sleep (100us poll, default), abstime\n"
+                      << "                             (clock_nanosleep on cycle-aligned grid), timerfd\n"
+                      << "  --convert-on-pop           PCM ring stores source samples; 16->32/16->24/24-bit packing\n"
+                      << "                             is done per callback (halves ring memory for 16->32)\n"
+                      << "  --constant-work            Worker callback does the same copy for audio and silence\n"
+                      << "                             (minimum callback jitter)\n"
+                      << "  --wire-markers             Report track changes and position when the audio is\n"
+                      << "                             handed to the target, not when it is decoded\n"
+                      << "  --target-cache <file>      Remember target, MTU and capabilities in <file>; skips\n"
+                      << "                             discovery retries and MTU measurement on restart\n"
+                      << "  --verify-bitperfect        Hash input vs. output of the ring buffer, report per track\n"
+                      << "  --tap-dump <file>          Also write raw output bytes to <file> (implies verify)\n"
                       << "\n"
                       << "CPU affinity (core isolation for audio quality):\n"
                       << "  --cpu-audio <cores>        Pin Diretta worker thread to CPU core(s), comma-separated (e.g., '3' or '3,4')\n"
                       << "  --cpu-decode <cores>       Pin DirettaRenderer Audio thread (decode) to CPU core(s), comma-separated\n"
                       << "  --cpu-other <cores>        Pin other threads (UPnP/position) to CPU core(s), comma-separated\n"
+                      << "  --cpu-demux <cores>        Pin the demux thread (--demux-packets) to CPU core(s) (default: --cpu-other)\n"
                       << "\n"
                       << "Buffer configuration (advanced — leave unset to use defaults):\n"
                       << "  --pcm-buffer-seconds <s>       PCM local buffer size in seconds (default 0.5)\n"
@@ -397,6 +489,35 @@ DirettaRenderer::Config parseArguments(int argc, char* argv[]) {
                       << "  --pcm-prefill-ms <ms>          PCM prefill in ms (default 80)\n"
                       << "  --pcm-remote-prefill-ms <ms>   PCM remote prefill in ms (default 150)\n"
                       << "  --dsd-prefill-ms <ms>          DSD prefill in ms (default 200)\n"
+                      << "  --http-buffer-mb <MB>          Network read-ahead per HTTP stream, filled by its\n"
+                      << "                                 own thread (default 0 = FFmpeg's 256-512KB buffer)\n"
+                      << "  --track-cache <dir>            Keep downloaded tracks in <dir> (LRU); replays and\n"
+                      << "                                 seeks are served from disk (implies read-ahead)\n"
+                      << "  --track-cache-mb <MB>          Track cache size cap (default 2048)\n"
+                      << "  --http-pool <n>                Keep up to <n> HTTP connections per media server\n"
+                      << "                                 alive across tracks, preloads and seeks; 2 covers\n"
+                      << "                                 current + next track (default 0 = off)\n"
+                      << "  --http-connections <n>         Fetch each track as byte ranges over up to <n>\n"
+                      << "                                 connections, for servers that send ~1x real time\n"
+                      << "                                 per connection (default 1; implies --http-pool)\n"
+                      << "  --probe-cache                  Reuse probed stream parameters when a URI is opened\n"
+                      << "                                 again (replay, gapless retry): skips FFmpeg probing\n"
+                      << "  --io-uring                     Read local (file://) tracks with io_uring read-ahead\n"
+                      << "                                 instead of blocking reads on the audio thread\n"
+                      << "  --mmap                         Map local tracks and read them from the page cache;\n"
+                      << "                                 WAV/AIFF/DSF convert without copies (over --io-uring)\n"
+                      << "                                 Caution: a file rewritten or an NFS read error\n"
+                      << "                                 during playback kills the renderer (SIGBUS)\n"
+                      << "  --memory-play-mb <MB>          Download tracks into RAM from SetURI on; budget\n"
+                      << "                                 covers current + next track (default 0 = off)\n"
+                      << "  --decode-ahead-mb <MB>         Decode PCM on a non-RT worker (--cpu-other cores)\n"
+                      << "                                 into a FIFO per track (default 0 = off)\n"
+                      << "  --preroll-ms <ms>              Decode the start of the next track while preloading\n"
+                      << "                                 so gapless transitions start from RAM (e.g. 2000)\n"
+                      << "  --dst-threads <n>              Workers for DST-compressed DFF, on the --cpu-other\n"
+                      << "                                 cores (default 0 = half the CPUs, max 4)\n"
+                      << "  --demux-packets <n>            Read packets on a demux thread into a queue of <n>,\n"
+                      << "                                 so network reads never stall decoding (e.g. 64)\n"
                       << std::endl;
             exit(0);
         }
@@ -567,6 +688,14 @@ int main(int argc, char* argv[]) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
 
+        // Diretta startup runs in the background and stops the renderer on failure
+        if (g_renderer->startupFailed()) {
+            std::cerr << "Failed to start Diretta target" << std::endl;
+            g_renderer->stop();
+            shutdownAsyncLogging();
+            return 1;
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "Exception: " << e.what() << std::endl;
         shutdownAsyncLogging();
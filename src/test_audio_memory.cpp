@@ -5,6 +5,22 @@
 #include "AudioMemoryTest.h"
 #include "memcpyfast_audio.h"
 #include "DirettaRingBuffer.h"
+#include "BitPerfectTap.h"
+#include "ClockDriftEstimator.h"
+#include "WireMarkers.h"
+#include "TargetCache.h"
+#include "HttpReadAhead.h"
+#include "TrackCache.h"
+#include "DecodeAhead.h"
+#include "NativeContainer.h"
+#include "DstDecoder.h"
+#include "HttpConnectionPool.h"
+#include "StreamProbeCache.h"
+#include "ParallelRangeReader.h"
+#include "SeekIndex.h"
+#include "UringReader.h"
+#include "MappedFile.h"
+#include "SpscQueue.h"
 
 // Forward declarations
 bool test_memcpy_audio_fixed_correctness();
@@ -25,11 +41,38 @@ bool test_ring_buffer_wraparound();
 bool test_ring_buffer_power_of_2();
 bool test_ring_buffer_full();
 bool test_ring_buffer_empty_pop();
+bool test_ring_buffer_constant_work_pop();
 bool test_push24bit_pop_integration();
 bool test_pushDSD_optimized_integration();
+bool test_pushDSD_direct_wrap_and_partial();
 bool test_pushDSD_dop_encoding();
 bool test_pushDSD_dop_msb_encoding();
 bool test_pushDSD_dop_marker_phase_invariant();
+bool test_convert_on_pop_matches_push_conversion();
+bool test_bitperfect_canonical_roundtrip();
+bool test_bitperfect_tap_detects_mismatch();
+bool test_clock_drift_estimator();
+bool test_wire_markers_release_at_offset();
+bool test_target_cache_roundtrip();
+bool test_http_read_ahead_seek();
+bool test_http_read_ahead_retain_all();
+bool test_http_read_ahead_seek_during_fill();
+bool test_http_read_ahead_two_cursors();
+bool test_track_cache_partial_and_hit();
+bool test_decode_ahead_fifo_order();
+bool test_native_wav_aiff_headers();
+bool test_native_dsf_header();
+bool test_dst_stored_frame();
+bool test_dst_pool_matches_serial();
+bool test_http_pool_response_parsing();
+bool test_http_pool_keep_alive_reuse();
+bool test_stream_probe_cache_lru();
+bool test_parallel_range_reader_in_order();
+bool test_parallel_range_reader_abort_stalled();
+bool test_seek_index_floor();
+bool test_uring_reader_sequential_and_seek();
+bool test_mapped_file_view_and_seek();
+bool test_spsc_queue_order_and_stop();
 
 int main() {
     std::cout << "=== DirettaRingBuffer Unit Tests ===" << std::endl;
@@ -67,14 +110,89 @@ int main() {
     RUN_TEST(test_ring_buffer_power_of_2);
     RUN_TEST(test_ring_buffer_full);
     RUN_TEST(test_ring_buffer_empty_pop);
+    RUN_TEST(test_ring_buffer_constant_work_pop);
 
     // Group 5: Integration (push → pop)
     std::cout << std::endl << "--- Integration ---" << std::endl;
     RUN_TEST(test_push24bit_pop_integration);
     RUN_TEST(test_pushDSD_optimized_integration);
+    RUN_TEST(test_pushDSD_direct_wrap_and_partial);
     RUN_TEST(test_pushDSD_dop_encoding);
     RUN_TEST(test_pushDSD_dop_msb_encoding);
     RUN_TEST(test_pushDSD_dop_marker_phase_invariant);
+    RUN_TEST(test_convert_on_pop_matches_push_conversion);
+
+    // Group 6: Bit-perfect verification tap
+    std::cout << std::endl << "--- Bit-Perfect Tap ---" << std::endl;
+    RUN_TEST(test_bitperfect_canonical_roundtrip);
+    RUN_TEST(test_bitperfect_tap_detects_mismatch);
+
+    // Group 7: Target clock drift estimation
+    std::cout << std::endl << "--- Clock Drift ---" << std::endl;
+    RUN_TEST(test_clock_drift_estimator);
+
+    // Group 8: Wire markers
+    std::cout << std::endl << "--- Wire Markers ---" << std::endl;
+    RUN_TEST(test_wire_markers_release_at_offset);
+
+    // Group 9: Target cache
+    std::cout << std::endl << "--- Target Cache ---" << std::endl;
+    RUN_TEST(test_target_cache_roundtrip);
+
+    // Group 10: HTTP read-ahead
+    std::cout << std::endl << "--- HTTP Read-Ahead ---" << std::endl;
+    RUN_TEST(test_http_read_ahead_seek);
+    RUN_TEST(test_http_read_ahead_retain_all);
+    RUN_TEST(test_http_read_ahead_seek_during_fill);
+    RUN_TEST(test_http_read_ahead_two_cursors);
+
+    // Group 11: Track cache
+    std::cout << std::endl << "--- Track Cache ---" << std::endl;
+    RUN_TEST(test_track_cache_partial_and_hit);
+
+    // Group 12: Decode-ahead
+    std::cout << std::endl << "--- Decode-Ahead ---" << std::endl;
+    RUN_TEST(test_decode_ahead_fifo_order);
+
+    // Group 13: Native containers
+    std::cout << std::endl << "--- Native Containers ---" << std::endl;
+    RUN_TEST(test_native_wav_aiff_headers);
+    RUN_TEST(test_native_dsf_header);
+
+    // Group 14: DST decoding
+    std::cout << std::endl << "--- DST Decoding ---" << std::endl;
+    RUN_TEST(test_dst_stored_frame);
+    RUN_TEST(test_dst_pool_matches_serial);
+
+    // Group 15: HTTP keep-alive pool
+    std::cout << std::endl << "--- HTTP Keep-Alive Pool ---" << std::endl;
+    RUN_TEST(test_http_pool_response_parsing);
+    RUN_TEST(test_http_pool_keep_alive_reuse);
+
+    // Group 16: Stream probe cache
+    std::cout << std::endl << "--- Stream Probe Cache ---" << std::endl;
+    RUN_TEST(test_stream_probe_cache_lru);
+
+    // Group 17: Parallel range download
+    std::cout << std::endl << "--- Parallel Range Download ---" << std::endl;
+    RUN_TEST(test_parallel_range_reader_in_order);
+    RUN_TEST(test_parallel_range_reader_abort_stalled);
+
+    // Group 18: Seek index
+    std::cout << std::endl << "--- Seek Index ---" << std::endl;
+    RUN_TEST(test_seek_index_floor);
+
+    // Group 19: io_uring file reader
+    std::cout << std::endl << "--- io_uring File Reader ---" << std::endl;
+    RUN_TEST(test_uring_reader_sequential_and_seek);
+
+    // Group 20: Mapped local file
+    std::cout << std::endl << "--- Mapped File ---" << std::endl;
+    RUN_TEST(test_mapped_file_view_and_seek);
+
+    // Group 21: SPSC queue (demux thread)
+    std::cout << std::endl << "--- SPSC Queue ---" << std::endl;
+    RUN_TEST(test_spsc_queue_order_and_stop);
 
     std::cout << std::endl;
     std::cout << "=== Results: " << passed << " passed, " << failed << " failed ===" << std::endl;
@@ -653,6 +771,80 @@ bool test_ring_buffer_empty_pop() {
     return true;
 }
 
+bool test_ring_buffer_constant_work_pop() {
+    // Correctness: mirrored reads across the wrap point, silence doesn't consume
+    {
+        DirettaRingBuffer ring;
+        ring.setReadMirror(512);
+        ring.resize(1024, 0x00);
+        TEST_ASSERT_EQ(ring.readMirror(), static_cast<size_t>(512), "Mirror not allocated");
+
+        std::vector<uint8_t> silence(512, 0x00);
+        std::vector<uint8_t> out(300);
+        uint8_t next = 0;       // Expected next data byte
+        uint8_t fill = 0;       // Next byte to push
+        for (int round = 0; round < 40; round++) {
+            std::vector<uint8_t> chunk(300);
+            for (auto& b : chunk) b = ++fill;
+            // Alternate the direct-write and staged (writeToRing) push paths
+            size_t pushed = (round & 1) ? ring.push(chunk.data(), chunk.size())
+                                        : ring.pushSamples(chunk.data(), chunk.size(), 4);
+            TEST_ASSERT_EQ(pushed, chunk.size(), "Push should fit");
+
+            size_t availBefore = ring.getAvailable();
+            ring.popConstantWork(out.data(), out.size(), silence.data(), false);
+            TEST_ASSERT_EQ(ring.getAvailable(), availBefore, "Silence must not consume ring data");
+            TEST_ASSERT(out[0] == 0 && out[299] == 0, "Silence call should output silence");
+
+            ring.popConstantWork(out.data(), out.size(), silence.data(), true);
+            for (size_t i = 0; i < out.size(); i++) {
+                TEST_ASSERT(out[i] == ++next, "Constant-work pop byte " << i
+                    << " in round " << round << " differs");
+            }
+        }
+    }
+
+    // Callback timing: legacy pop/memset mix vs. constant work, variable silence
+    // share per batch (underrun/rebuffer bursts). Informational, not asserted.
+    constexpr size_t BPB = 1536;
+    constexpr int BATCH = 64;
+    constexpr int ITERATIONS = 300;
+    DirettaRingBuffer ring;
+    ring.setReadMirror(65536);
+    ring.resize(1024 * 1024, 0x00);
+    std::vector<uint8_t> silence(65536, 0x00);
+    std::vector<uint8_t> feed(BPB * BATCH, 0x5A);
+    alignas(64) uint8_t dest[BPB];
+
+    uint32_t rng = 2024;
+    TimingStats legacy, constant;
+    for (int i = 0; i < ITERATIONS * 2; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        int silent = static_cast<int>((rng >> 8) % (BATCH + 1));
+        bool constantMode = (i & 1) != 0;
+        ring.clear();
+        ring.push(feed.data(), feed.size());
+
+        auto start = std::chrono::steady_clock::now();
+        for (int j = 0; j < BATCH; j++) {
+            bool haveData = j >= silent;
+            if (constantMode) {
+                ring.popConstantWork(dest, BPB, silence.data(), haveData);
+            } else if (haveData) {
+                ring.pop(dest, BPB);
+            } else {
+                std::memset(dest, 0x00, BPB);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count();
+        (constantMode ? constant : legacy).record(us / BATCH);
+    }
+
+    std::cout << "[legacy cv=" << legacy.cv() << " constant-work cv=" << constant.cv() << "] ";
+    return true;
+}
+
 //=============================================================================
 // Group 5: Integration (push → pop)
 //=============================================================================
@@ -918,3 +1110,1386 @@ bool test_pushDSD_optimized_integration() {
 
     return true;
 }
+
+bool test_pushDSD_direct_wrap_and_partial() {
+    // Conversion goes straight into the ring: check a group straddling the wrap
+    // and a push limited by free space (whole groups from the start of each plane)
+    constexpr size_t PER_CH = 64;
+    alignas(64) uint8_t input[PER_CH * 2];
+    for (size_t i = 0; i < PER_CH; i++) {
+        input[i] = static_cast<uint8_t>(0x11 + i);
+        input[PER_CH + i] = static_cast<uint8_t>(0xA0 + i);
+    }
+    const auto mode = DirettaRingBuffer::DSDConversionMode::BitReverseAndSwap;
+
+    DirettaRingBuffer ref;
+    alignas(64) uint8_t expected[PER_CH * 2];
+    ref.convertDSD_BitReverseSwap(expected, input, sizeof(input), 2);
+
+    DirettaRingBuffer ring;
+    ring.resize(1024, 0x69);
+    std::vector<uint8_t> scratch(1020, 0);
+    ring.push(scratch.data(), scratch.size());
+    ring.pop(scratch.data(), scratch.size());     // Write position 1020: 4 bytes to the end
+
+    size_t written = ring.pushDSDPlanarOptimized(input, sizeof(input), 2, mode);
+    TEST_ASSERT_EQ(written, sizeof(input), "Wrapping DSD push should consume all input");
+    std::vector<uint8_t> popped(written);
+    ring.pop(popped.data(), written);
+    TEST_ASSERT(std::memcmp(popped.data(), expected, written) == 0, "Wrapped DSD output mismatch");
+
+    // Leave 40 bytes free: 5 groups of [4 L][4 R]
+    ring.clear();
+    std::vector<uint8_t> fill(1023 - 40, 0);
+    ring.push(fill.data(), fill.size());
+    written = ring.pushDSDPlanarOptimized(input, sizeof(input), 2, mode);
+    TEST_ASSERT_EQ(written, static_cast<size_t>(40), "Partial DSD push takes whole groups");
+    ring.pop(fill.data(), fill.size());
+    popped.resize(written);
+    ring.pop(popped.data(), written);
+    TEST_ASSERT(std::memcmp(popped.data(), expected, written) == 0, "Partial push must keep the R plane");
+    return true;
+}
+
+bool test_convert_on_pop_matches_push_conversion() {
+    // Source-format ring + popConverted() must produce the same wire bytes as
+    // converting on push, including across the ring wrap point
+    using Conv = DirettaRingBuffer::PopConversion;
+    constexpr size_t FRAME_IN = 8;          // Stereo S24_P32 / 2 x stereo 16-bit
+    constexpr size_t TOTAL = 24000;         // Multiple of FRAME_IN
+    std::vector<uint8_t> input(TOTAL);
+    for (size_t i = 0; i < TOTAL; i++) {
+        input[i] = (i % 4 == 3) ? 0 : static_cast<uint8_t>((i * 37 + 11) & 0xFF);
+    }
+
+    for (Conv conv : {Conv::Pack24, Conv::Pad16To32, Conv::Pad16To24}) {
+        DirettaRingBuffer ref;
+        ref.resize(1024 * 1024, 0x00);
+        size_t consumed = 0;
+        if (conv == Conv::Pack24) consumed = ref.push24BitPacked(input.data(), TOTAL);
+        else if (conv == Conv::Pad16To32) consumed = ref.push16To32(input.data(), TOTAL);
+        else consumed = ref.push16To24(input.data(), TOTAL);
+        TEST_ASSERT_EQ(consumed, TOTAL, "Reference push should consume all input");
+        std::vector<uint8_t> expected(ref.getAvailable());
+        ref.pop(expected.data(), expected.size());
+
+        // Small ring: several wraps, odd-sized push/pop chunks
+        DirettaRingBuffer ring;
+        ring.resize(4096, 0x00);
+        size_t wireSample = DirettaRingBuffer::popWireBytes(conv);
+        size_t popChunk = wireSample * 2 * 37;   // Whole wire frames
+        std::vector<uint8_t> out;
+        std::vector<uint8_t> buf(popChunk);
+        size_t in = 0;
+        while (out.size() < expected.size()) {
+            if (in < TOTAL) {
+                size_t chunk = std::min<size_t>(1000, TOTAL - in);
+                in += (conv == Conv::Pack24)
+                    ? ring.pushS24Source(input.data() + in, chunk, FRAME_IN)
+                    : ring.pushSamples(input.data() + in, chunk, FRAME_IN / 2);
+            }
+            size_t n = ring.popConverted(buf.data(), popChunk, conv);
+            out.insert(out.end(), buf.begin(), buf.begin() + n);
+            if (n == 0 && in >= TOTAL) break;
+        }
+
+        TEST_ASSERT_EQ(out.size(), expected.size(), "Convert-on-pop output size mismatch");
+        TEST_ASSERT(std::memcmp(out.data(), expected.data(), expected.size()) == 0,
+            "Convert-on-pop output differs from push-side conversion");
+    }
+    return true;
+}
+
+//=============================================================================
+// Group 6: Bit-Perfect Verification Tap
+//=============================================================================
+
+bool test_bitperfect_canonical_roundtrip() {
+    // Every ring conversion, inverted on the popped bytes, must hash like the input
+    using namespace BitPerfect;
+    using Mode = DirettaRingBuffer::DSDConversionMode;
+
+    constexpr size_t INPUT = 4096;
+    alignas(64) uint8_t pcm24[INPUT];   // S24_P32, LSB aligned (byte 3 = 0)
+    alignas(64) uint8_t pcm16[INPUT];
+    alignas(64) uint8_t dsd[INPUT];     // Planar stereo, 2048 bytes per channel
+    for (size_t i = 0; i < INPUT; i++) {
+        pcm24[i] = (i % 4 == 3) ? 0 : static_cast<uint8_t>((i * 7 + 1) & 0xFF);
+        pcm16[i] = static_cast<uint8_t>((i * 13 + 5) & 0xFF);
+        dsd[i] = static_cast<uint8_t>((i * 29 + 3) & 0xFF);
+    }
+
+    struct Case { Transform t; Mode mode; bool dopRev; const uint8_t* in; };
+    const Case cases[] = {
+        {Transform::Pack24, Mode::Passthrough, false, pcm24},
+        {Transform::Pad16To32, Mode::Passthrough, false, pcm16},
+        {Transform::Pad16To24, Mode::Passthrough, false, pcm16},
+        {Transform::DsdNative, Mode::Passthrough, false, dsd},
+        {Transform::DsdNative, Mode::BitReverseAndSwap, false, dsd},
+        {Transform::DoP, Mode::Passthrough, false, dsd},
+        {Transform::DoP, Mode::Passthrough, true, dsd},
+    };
+
+    for (const Case& c : cases) {
+        DirettaRingBuffer ring;
+        ring.resize(1024 * 1024, 0x00);
+        size_t consumed = 0;
+        switch (c.t) {
+            case Transform::Pack24:    consumed = ring.push24BitPacked(c.in, INPUT); break;
+            case Transform::Pad16To32: consumed = ring.push16To32(c.in, INPUT); break;
+            case Transform::Pad16To24: consumed = ring.push16To24(c.in, INPUT); break;
+            case Transform::DsdNative: consumed = ring.pushDSDPlanarOptimized(c.in, INPUT, 2, c.mode); break;
+            case Transform::DoP:       consumed = ring.pushDSDToDoP(c.in, INPUT, 2, c.dopRev); break;
+            default: break;
+        }
+        TEST_ASSERT_EQ(consumed, INPUT, "Push should consume all input");
+
+        // Input side canonical form
+        std::vector<uint8_t> inCanon(INPUT);
+        size_t inLen = 0;
+        uint64_t errs = 0;
+        if (c.t == Transform::Pack24) {
+            inLen = canonicalizeS24Input(c.in, INPUT / 4, false, inCanon.data(), errs);
+        } else if (c.t == Transform::DsdNative || c.t == Transform::DoP) {
+            inLen = canonicalizeDsdInput(c.in, INPUT / 2, INPUT / 2, 2,
+                                         c.t == Transform::DoP ? 2 : 4, inCanon.data());
+        } else {
+            std::memcpy(inCanon.data(), c.in, INPUT);
+            inLen = INPUT;
+        }
+
+        // Wire side canonical form
+        StreamParams p;
+        p.transform = c.t;
+        p.channels = 2;
+        p.dsdMode = c.mode;
+        p.dopBitReverse = c.dopRev;
+        std::vector<uint8_t> wire(ring.getAvailable());
+        ring.pop(wire.data(), wire.size());
+        std::vector<uint8_t> wireCanon(wire.size());
+        int marker = -1;
+        size_t frames = wire.size() / (p.wireUnitPerChannel() * 2);
+        size_t wireLen = canonicalizeWire(p, wire.data(), frames, wireCanon.data(), errs, marker);
+
+        TEST_ASSERT_EQ(errs, 0u, "No padding/marker errors expected");
+        TEST_ASSERT_EQ(wireLen, inLen, "Canonical lengths should match");
+        TEST_ASSERT(crc32Update(0, inCanon.data(), inLen) == crc32Update(0, wireCanon.data(), wireLen),
+            "Canonical CRCs should match");
+    }
+
+    // CRC must be streamable across chunk splits
+    uint32_t whole = crc32Update(0, dsd, INPUT);
+    uint32_t split = crc32Update(crc32Update(0, dsd, 1000), dsd + 1000, INPUT - 1000);
+    TEST_ASSERT(whole == split, "Chunked CRC should equal one-shot CRC");
+    return true;
+}
+
+bool test_bitperfect_tap_detects_mismatch() {
+    // 16-bit stereo direct PCM: 4 blocks of 64KB, one corrupted byte in block 2
+    constexpr size_t BLOCK = BitPerfect::BlockHasher::BLOCK_BYTES;
+    constexpr size_t TOTAL = BLOCK * 4;
+    constexpr size_t CHUNK = 4096;
+
+    std::vector<uint8_t> input(TOTAL);
+    for (size_t i = 0; i < TOTAL; i++) input[i] = static_cast<uint8_t>((i * 31 + 7) & 0xFF);
+
+    std::vector<BitPerfectTap::TrackReport> reports;
+    BitPerfectTap tap;
+    TEST_ASSERT(tap.start("", [&reports](const BitPerfectTap::TrackReport& r) { reports.push_back(r); }),
+        "Tap should start");
+
+    BitPerfect::StreamParams params;
+    params.transform = BitPerfect::Transform::Direct;
+    params.channels = 2;
+    params.wireBytesPerSample = 2;
+    tap.beginStream(params);
+
+    DirettaRingBuffer ring;
+    ring.resize(1024 * 1024, 0x00);
+    std::vector<uint8_t> out(CHUNK);
+    for (size_t off = 0; off < TOTAL; off += CHUNK) {
+        size_t written = ring.push(input.data() + off, CHUNK);
+        TEST_ASSERT_EQ(written, CHUNK, "Push should consume chunk");
+        tap.onInput(input.data() + off, written, CHUNK, false);
+
+        ring.pop(out.data(), CHUNK);
+        if (off == BLOCK * 2) out[100] ^= 0x01;   // Single bit flip on the wire
+        tap.onWire(out.data(), CHUNK);
+    }
+    tap.stop();
+
+    BitPerfectTap::Stats stats = tap.getStats();
+    TEST_ASSERT_EQ(stats.blocksVerified, 3u, "Three blocks should verify");
+    TEST_ASSERT_EQ(stats.blocksMismatched, 1u, "One block should mismatch");
+    TEST_ASSERT_EQ(stats.tracksMismatched, 1u, "Track should be reported as mismatched");
+    TEST_ASSERT_EQ(reports.size(), 1u, "One track report expected");
+    TEST_ASSERT_EQ(reports[0].firstMismatchByte, BLOCK * 2, "Mismatch should be located in block 2");
+    return true;
+}
+
+//=============================================================================
+// Group 7: Target Clock Drift Estimation
+//=============================================================================
+
+bool test_clock_drift_estimator() {
+    // Target consumes 44.1kHz/32bit/2ch at +50 ppm, 1ms callbacks with jitter and
+    // occasional late bursts; ring drains at 1000 B/s from 200KB
+    constexpr double NOMINAL = 44100.0 * 8.0;
+    constexpr double PPM = 50.0;
+    constexpr double DRAIN = 1000.0;
+    constexpr size_t RING = 1 << 20;
+
+    ClockDriftEstimator est;
+    est.reset(NOMINAL, RING);
+
+    uint32_t rng = 12345;
+    auto noise = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return static_cast<int64_t>(rng >> 16) % 400000 - 200000;   // +/-200us
+    };
+
+    double rate = NOMINAL * (1.0 + PPM * 1e-6);
+    for (int i = 1; i <= 40000; i++) {
+        double t = i * 1e-3;
+        int64_t tNs = static_cast<int64_t>(t * 1e9) + noise();
+        if (i % 1000 == 0) tNs += 5000000;                            // 5ms scheduling outlier
+        uint64_t bytes = static_cast<uint64_t>(rate * t);
+        size_t fill = static_cast<size_t>(200000.0 - DRAIN * t);
+        est.addPoint(tNs, bytes, fill);
+    }
+
+    const ClockDriftEstimator::Estimate& e = est.estimate();
+    TEST_ASSERT(e.valid, "Estimate should be valid after 40s");
+    TEST_ASSERT(std::abs(e.ppm - PPM) < 5.0, "Drift estimate off (got " << e.ppm << " ppm)");
+    TEST_ASSERT(std::abs(e.fillSlope + DRAIN) < 20.0, "Fill trend off (got " << e.fillSlope << " B/s)");
+    TEST_ASSERT(e.secondsToUnderrun > 150.0 && e.secondsToUnderrun < 170.0,
+        "Underrun prediction off (got " << e.secondsToUnderrun << " s)");
+    TEST_ASSERT(e.secondsToOverrun < 0, "No overrun expected while draining");
+
+    // A consumer stall restarts the series instead of skewing the slope
+    est.addPoint(static_cast<int64_t>(60e9), static_cast<uint64_t>(rate * 40.0), 160000);
+    TEST_ASSERT(!est.estimate().valid, "Gap should reset the estimate");
+    return true;
+}
+
+//=============================================================================
+// Group 8: Wire Markers
+//=============================================================================
+
+bool test_wire_markers_release_at_offset() {
+    using Kind = WireMarkers::Kind;
+    WireMarkers wm;
+    std::vector<WireMarkers::Event> events;
+    wm.setHandler([&events](const WireMarkers::Event& e) { events.push_back(e); });
+
+    // Track 1 at offset 0, position at 1000, track 2 at 2500 (all in epoch 1)
+    wm.mark(Kind::Track, 1, 0, 44100, 100, 1);
+    wm.onRingWrite(1000, 1);
+    wm.mark(Kind::Position, 1, 250, 44100, 200, 1);
+    wm.onRingWrite(1500, 1);
+    wm.mark(Kind::Track, 2, 0, 48000, 300, 1);
+    wm.onRingWrite(1000, 1);
+
+    // Marker is released by the pop that contains its first byte
+    wm.onRingRead(500, 1, 1100);
+    wm.dispatchPending();
+    TEST_ASSERT_EQ(events.size(), static_cast<size_t>(1), "Only track 1 should be on the wire");
+    TEST_ASSERT(events[0].kind == Kind::Track && events[0].track == 1, "First event should be track 1");
+    TEST_ASSERT_EQ(events[0].latencyNs, static_cast<int64_t>(1000), "Decode-to-wire latency");
+
+    wm.onRingRead(500, 1, 1200);      // Read offset 1000: position marker byte not yet popped
+    wm.dispatchPending();
+    TEST_ASSERT_EQ(events.size(), static_cast<size_t>(1), "Position marker released too early");
+    wm.onRingRead(1, 1, 1300);
+    wm.dispatchPending();
+    TEST_ASSERT_EQ(events.size(), static_cast<size_t>(2), "Position marker not released");
+    TEST_ASSERT_EQ(events[1].frame, static_cast<uint64_t>(250), "Position frame");
+
+    // Ring cleared (epoch 2) before track 2 reached the wire: flushed, not lost
+    wm.mark(Kind::Position, 2, 4096, 48000, 400, 2);
+    wm.onRingRead(100, 2, 1400);
+    wm.dispatchPending();
+    TEST_ASSERT_EQ(events.size(), static_cast<size_t>(4), "Stale track + new position expected");
+    TEST_ASSERT(events[2].kind == Kind::Track && events[2].track == 2 && events[2].flushed,
+        "Stale track marker should be released as flushed");
+    TEST_ASSERT(events[3].kind == Kind::Position && !events[3].flushed && events[3].frame == 4096,
+        "New-epoch position marker at offset 0");
+
+    WireMarkers::Stats st = wm.getStats();
+    TEST_ASSERT_EQ(st.released, static_cast<uint64_t>(4), "Released count");
+    TEST_ASSERT_EQ(st.flushed, static_cast<uint64_t>(1), "Flushed count");
+    TEST_ASSERT_EQ(st.maxLatencyNs, static_cast<int64_t>(1100), "Max latency");
+    return true;
+}
+
+//=============================================================================
+// Group 9: Target Cache
+//=============================================================================
+
+bool test_target_cache_roundtrip() {
+    std::string path = "/tmp/diretta_target_cache_test_" + std::to_string(getpid());
+
+    TargetCache c;
+    c.address = "fe80::1234%eth0";
+    c.targetName = "Diretta Target";
+    c.outputName = "USB Out=1";       // '=' in a value must survive
+    c.targetIndex = 1;
+    c.mtu = 9000;
+    c.supportPCM = true;
+    c.supportDSDmsb = true;
+    c.msModes = 0x5;
+    TEST_ASSERT(c.save(path), "Save failed");
+
+    TargetCache r;
+    TEST_ASSERT(r.load(path), "Load failed");
+    TEST_ASSERT(r.address == c.address && r.targetName == c.targetName &&
+                r.outputName == c.outputName, "Strings differ after reload");
+    TEST_ASSERT_EQ(r.targetIndex, 1, "Target index");
+    TEST_ASSERT_EQ(r.mtu, static_cast<uint32_t>(9000), "MTU");
+    TEST_ASSERT(r.supportPCM && !r.supportDSD && !r.supportDSDlsb && r.supportDSDmsb,
+                "Capability flags");
+    TEST_ASSERT_EQ(r.msModes, static_cast<uint16_t>(0x5), "MS modes");
+
+    // Incomplete or other-version files are rejected
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "version=" << (TargetCache::VERSION + 1) << "\naddress=x\nmtu=1500\n";
+    }
+    TargetCache bad;
+    TEST_ASSERT(!bad.load(path), "Version mismatch should be rejected");
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "version=" << TargetCache::VERSION << "\nmtu=1500\n";
+    }
+    TEST_ASSERT(!bad.load(path), "Missing address should be rejected");
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "version=" << TargetCache::VERSION << "\naddress=x\n";
+    }
+    TargetCache unmeasured;
+    TEST_ASSERT(unmeasured.load(path), "Entry without a measured MTU should load");
+    TEST_ASSERT_EQ(unmeasured.mtu, static_cast<uint32_t>(0), "Unmeasured MTU");
+
+    std::remove(path.c_str());
+    return true;
+}
+
+//=============================================================================
+// Group 10: HTTP Read-Ahead
+//=============================================================================
+
+bool test_http_read_ahead_seek() {
+    // Source: 4 MB where byte i == (i * 7) & 0xFF; counts repositions
+    constexpr int64_t SOURCE_SIZE = 4 << 20;
+    int64_t srcPos = 0;
+    int sourceSeeks = 0;
+    auto expected = [](int64_t i) { return static_cast<uint8_t>((i * 7) & 0xFF); };
+
+    HttpReadAhead ra(1 << 20);
+    ra.start(
+        [&](uint8_t* buf, int size) -> int {
+            int n = static_cast<int>(std::min<int64_t>(size, SOURCE_SIZE - srcPos));
+            for (int i = 0; i < n; i++) buf[i] = expected(srcPos + i);
+            srcPos += n;
+            return n;
+        },
+        [&](int64_t pos) -> int64_t { sourceSeeks++; srcPos = pos; return pos; });
+
+    auto readCheck = [&](int64_t from, int len) -> bool {
+        std::vector<uint8_t> buf(len);
+        int got = 0;
+        while (got < len) {
+            int n = ra.read(buf.data() + got, len - got);
+            if (n <= 0) return false;
+            got += n;
+        }
+        for (int i = 0; i < len; i++) {
+            if (buf[i] != expected(from + i)) return false;
+        }
+        return true;
+    };
+
+    TEST_ASSERT(readCheck(0, 300000), "Sequential read mismatch");
+
+    // Demuxer-style rewind within the keep-behind window (capacity/8): served from the ring
+    TEST_ASSERT_EQ(ra.seek(200000), static_cast<int64_t>(200000), "Backward seek");
+    TEST_ASSERT(readCheck(200000, 1000), "Data after backward seek");
+    TEST_ASSERT_EQ(sourceSeeks, 0, "Backward seek should not touch the source");
+
+    // Far seek: source repositioned on the reader thread
+    TEST_ASSERT_EQ(ra.seek(3 << 20), static_cast<int64_t>(3 << 20), "Far seek");
+    TEST_ASSERT(readCheck(3 << 20, 5000), "Data after far seek");
+    TEST_ASSERT_EQ(sourceSeeks, 1, "Far seek should reposition the source");
+
+    // Drain to EOF
+    uint8_t tmp[65536];
+    int64_t total = (3 << 20) + 5000;
+    int n;
+    while ((n = ra.read(tmp, sizeof(tmp))) > 0) total += n;
+    TEST_ASSERT_EQ(n, 0, "EOF expected");
+    TEST_ASSERT_EQ(total, SOURCE_SIZE, "Bytes delivered");
+
+    HttpReadAhead::Stats st = ra.getStats();
+    TEST_ASSERT_EQ(st.seeks, static_cast<uint64_t>(2), "Seek count");
+    TEST_ASSERT_EQ(st.seeksInBuffer, static_cast<uint64_t>(1), "In-buffer seek count");
+    ra.stop();
+    return true;
+}
+
+bool test_http_read_ahead_retain_all() {
+    // Memory play: ring sized to the whole source keeps every byte
+    constexpr int64_t SOURCE_SIZE = 1 << 20;
+    int64_t srcPos = 0;
+    int sourceSeeks = 0;
+    auto expected = [](int64_t i) { return static_cast<uint8_t>((i * 13) & 0xFF); };
+
+    HttpReadAhead ra(SOURCE_SIZE + HttpReadAhead::CHUNK_SIZE, true);
+    ra.start(
+        [&](uint8_t* buf, int size) -> int {
+            int n = static_cast<int>(std::min<int64_t>(size, SOURCE_SIZE - srcPos));
+            for (int i = 0; i < n; i++) buf[i] = expected(srcPos + i);
+            srcPos += n;
+            return n;
+        },
+        [&](int64_t pos) -> int64_t { sourceSeeks++; srcPos = pos; return pos; });
+
+    // Forward to near the end (waits for the download), then back to the start
+    TEST_ASSERT_EQ(ra.seek(SOURCE_SIZE - 100), SOURCE_SIZE - 100, "Seek near end");
+    uint8_t tmp[256];
+    int n = ra.read(tmp, sizeof(tmp));
+    TEST_ASSERT_EQ(n, 100, "Tail bytes");
+    TEST_ASSERT_EQ(tmp[0], expected(SOURCE_SIZE - 100), "Tail data");
+
+    TEST_ASSERT_EQ(ra.seek(0), static_cast<int64_t>(0), "Rewind to start");
+    n = ra.read(tmp, sizeof(tmp));
+    TEST_ASSERT(n > 0 && tmp[0] == expected(0) && tmp[n - 1] == expected(n - 1), "Data after rewind");
+
+    HttpReadAhead::Stats st = ra.getStats();
+    TEST_ASSERT_EQ(sourceSeeks, 0, "Retained source should never be repositioned");
+    TEST_ASSERT_EQ(st.bytesIn, static_cast<uint64_t>(SOURCE_SIZE), "Downloaded once");
+    TEST_ASSERT_EQ(st.seeksInBuffer, static_cast<uint64_t>(2), "All seeks in buffer");
+    ra.stop();
+    return true;
+}
+
+bool test_http_read_ahead_seek_during_fill() {
+    // Smallest ring; the source read after the first fill is slow, so it is
+    // in flight (and will overwrite the oldest chunk) when the decoder rewinds
+    const int64_t cap = static_cast<int64_t>(HttpReadAhead::MIN_CAPACITY);
+    const int64_t chunk = static_cast<int64_t>(HttpReadAhead::CHUNK_SIZE);
+    int64_t srcPos = 0;
+    std::atomic<bool> slowReadStarted{false};
+    auto expected = [](int64_t i) { return static_cast<uint8_t>((i * 11) ^ (i >> 16)); };
+
+    HttpReadAhead ra(static_cast<size_t>(cap));
+    ra.start(
+        [&](uint8_t* buf, int size) -> int {
+            if (srcPos == cap && !slowReadStarted) {
+                slowReadStarted = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+            for (int i = 0; i < size; i++) buf[i] = expected(srcPos + i);
+            srcPos += size;
+            return size;
+        },
+        [&](int64_t pos) -> int64_t { srcPos = pos; return pos; });
+
+    // Consume the first fill: the reader starts the slow read at [cap, cap + chunk)
+    std::vector<uint8_t> buf(static_cast<size_t>(cap));
+    int64_t got = 0;
+    while (got < cap) {
+        int n = ra.read(buf.data() + got, static_cast<int>(cap - got));
+        TEST_ASSERT(n > 0, "First fill");
+        got += n;
+    }
+    while (!slowReadStarted) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // Oldest byte of the ring: the in-flight read lands on it
+    TEST_ASSERT_EQ(ra.seek(0), static_cast<int64_t>(0), "Rewind to the oldest byte");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));   // Slow read has landed
+    got = 0;
+    while (got < chunk) {
+        int n = ra.read(buf.data() + got, static_cast<int>(chunk - got));
+        TEST_ASSERT(n > 0, "Read after rewind");
+        got += n;
+    }
+    for (int64_t i = 0; i < chunk; i++) {
+        TEST_ASSERT(buf[static_cast<size_t>(i)] == expected(i), "Rewound bytes not overwritten by the fill");
+    }
+    ra.stop();
+    return true;
+}
+
+bool test_http_read_ahead_two_cursors() {
+    // Memory play, repeat-one: the playing decoder and the gapless next one read one RAM copy
+    constexpr int64_t SOURCE_SIZE = 1 << 20;
+    int64_t srcPos = 0;
+    int sourceSeeks = 0;
+    auto expected = [](int64_t i) { return static_cast<uint8_t>((i * 29) ^ (i >> 9)); };
+
+    HttpReadAhead ra(SOURCE_SIZE + HttpReadAhead::CHUNK_SIZE, true);
+    ra.start(
+        [&](uint8_t* buf, int size) -> int {
+            int n = static_cast<int>(std::min<int64_t>(size, SOURCE_SIZE - srcPos));
+            for (int i = 0; i < n; i++) buf[i] = expected(srcPos + i);
+            srcPos += n;
+            return n;
+        },
+        [&](int64_t pos) -> int64_t { sourceSeeks++; srcPos = pos; return pos; });
+
+    HttpReadAhead::Cursor current(ra);
+    auto readCheck = [&](HttpReadAhead::Cursor& c, int len) -> bool {
+        std::vector<uint8_t> buf(static_cast<size_t>(len));
+        int64_t from = c.position();
+        int got = 0;
+        while (got < len) {
+            int n = c.read(buf.data() + got, len - got);
+            if (n <= 0) return false;
+            got += n;
+        }
+        for (int i = 0; i < len; i++) {
+            if (buf[static_cast<size_t>(i)] != expected(from + i)) return false;
+        }
+        return true;
+    };
+
+    TEST_ASSERT(readCheck(current, 600000), "Current track reads from the start");
+    HttpReadAhead::Cursor next(ra);   // Opened while the current one plays
+    TEST_ASSERT_EQ(next.position(), static_cast<int64_t>(0), "Next cursor starts at byte 0");
+    TEST_ASSERT(readCheck(next, 70000), "Next track reads from the start");
+    TEST_ASSERT_EQ(current.position(), static_cast<int64_t>(600000), "Current cursor not moved");
+
+    // Interleaved, as the audio thread and the preload/pre-roll would
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT(readCheck(current, 50000), "Current stream intact");
+        TEST_ASSERT(readCheck(next, 33333), "Next stream intact");
+    }
+    TEST_ASSERT_EQ(next.seek(12345), static_cast<int64_t>(12345), "Seek one cursor");
+    TEST_ASSERT(readCheck(next, 1000) && readCheck(current, 1000), "Both after seek");
+
+    uint8_t tmp[65536];
+    int n;
+    while ((n = current.read(tmp, sizeof(tmp))) > 0) {}
+    TEST_ASSERT_EQ(n, 0, "Current reaches EOF");
+    TEST_ASSERT_EQ(current.position(), SOURCE_SIZE, "Current read everything");
+    TEST_ASSERT(readCheck(next, 1000), "Next unaffected by the other's EOF");
+    TEST_ASSERT_EQ(sourceSeeks, 0, "RAM copy never repositions the source");
+    ra.stop();
+    return true;
+}
+
+//=============================================================================
+// Group 11: Track Cache
+//=============================================================================
+
+bool test_track_cache_partial_and_hit() {
+    std::string dir = "/tmp/diretta_track_cache_test_" + std::to_string(getpid());
+    const std::string uri = "http://192.168.1.2:9790/track.flac";
+    constexpr int64_t SIZE = 3 * TrackCache::BLOCK_SIZE + 1000;   // Short last block
+    auto expected = [](int64_t i) { return static_cast<uint8_t>((i * 13) & 0xFF); };
+
+    int64_t netPos = 0;
+    uint64_t netBytes = 0;
+    auto netRead = [&](uint8_t* buf, int size) -> int {
+        int n = static_cast<int>(std::min<int64_t>(std::min(size, 50000), SIZE - netPos));
+        for (int i = 0; i < n; i++) buf[i] = expected(netPos + i);
+        netPos += n;
+        netBytes += static_cast<uint64_t>(n);
+        return n;
+    };
+    auto netSeek = [&](int64_t pos) -> int64_t { netPos = pos; return pos; };
+
+    auto readAt = [](TrackCache::Source& src, int64_t pos, std::vector<uint8_t>& out, size_t len) {
+        out.assign(len, 0);
+        src.seek(pos);
+        size_t got = 0;
+        while (got < len) {
+            int n = src.read(out.data() + got, static_cast<int>(len - got));
+            if (n <= 0) return false;
+            got += static_cast<size_t>(n);
+        }
+        return true;
+    };
+
+    std::vector<uint8_t> buf;
+    {
+        TrackCache cache(dir, 64 << 20);
+
+        // First play: seek into block 1 mid-way, read into block 2
+        auto entry = cache.acquire(uri, SIZE);
+        TEST_ASSERT(entry != nullptr, "acquire failed");
+        TrackCache::Source src(entry, netRead, netSeek);
+        int64_t start = TrackCache::BLOCK_SIZE + 12345;
+        TEST_ASSERT(readAt(src, start, buf, TrackCache::BLOCK_SIZE), "Partial read failed");
+        for (size_t i = 0; i < buf.size(); i++) {
+            TEST_ASSERT(buf[i] == expected(start + static_cast<int64_t>(i)), "Partial read data");
+        }
+        // Block 1 fetched from its start (so it is complete); block 0 never touched
+        TEST_ASSERT(!entry->has(0) && entry->has(1), "Block map after partial read");
+
+        // Re-reading block 1 comes from the mapping, not the network
+        uint64_t before = netBytes;
+        TEST_ASSERT(readAt(src, TrackCache::BLOCK_SIZE, buf, 1000), "Cached read failed");
+        TEST_ASSERT_EQ(netBytes, before, "Cached block should not hit the network");
+
+        // Sequential read of the whole file fills the rest
+        TEST_ASSERT(readAt(src, 0, buf, static_cast<size_t>(SIZE)), "Full read failed");
+        TEST_ASSERT(entry->complete(), "Entry should be complete");
+        TEST_ASSERT(src.read(buf.data(), 16) == 0, "EOF at Content-Length");
+    }   // Cache destroyed: entry written back
+
+    {
+        // Restart: complete entry is served from disk with no network at all
+        TrackCache cache(dir, 64 << 20);
+        auto entry = cache.acquire(uri, SIZE);
+        TEST_ASSERT(entry && entry->complete(), "Entry should reload as complete");
+        TrackCache::Source src(entry, nullptr, nullptr);
+        TEST_ASSERT(readAt(src, 0, buf, static_cast<size_t>(SIZE)), "Cache hit read failed");
+        for (int64_t i = 0; i < SIZE; i += 4099) {
+            TEST_ASSERT(buf[static_cast<size_t>(i)] == expected(i), "Cache hit data");
+        }
+        TEST_ASSERT_EQ(src.getStats().cacheBytes, static_cast<uint64_t>(SIZE), "All bytes from disk");
+
+        // Different Content-Length = different entry
+        auto other = cache.acquire(uri, SIZE + 1);
+        TEST_ASSERT(other && other->blocksPresent() == 0, "Size change must not reuse entry");
+    }
+
+    {
+        // LRU: a cap below one entry evicts everything not open
+        TrackCache cache(dir, 1024);
+        DIR* d = opendir(dir.c_str());
+        int files = 0;
+        while (struct dirent* ent = readdir(d)) {
+            if (ent->d_name[0] != '.') files++;
+        }
+        closedir(d);
+        TEST_ASSERT_EQ(files, 0, "Eviction should empty the cache");
+    }
+    rmdir(dir.c_str());
+    return true;
+}
+
+//=============================================================================
+// Group 12: Decode-Ahead
+//=============================================================================
+
+bool test_decode_ahead_fifo_order() {
+    // Producer: 8-byte frames (stereo S32) whose first word is the frame index,
+    // in chunks bigger than the FIFO so the worker has to split and wait
+    constexpr size_t FRAME = 8;
+    constexpr uint32_t TOTAL_FRAMES = 400000;
+    constexpr uint32_t CHUNK_FRAMES = 150000;
+    std::vector<uint8_t> chunk(CHUNK_FRAMES * FRAME);
+    uint32_t produced = 0;
+
+    DecodeAhead da(DecodeAhead::MIN_CAPACITY, FRAME);
+    da.start([&](const uint8_t** data) -> size_t {
+        uint32_t n = std::min(CHUNK_FRAMES, TOTAL_FRAMES - produced);
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t idx = produced + i;
+            std::memcpy(chunk.data() + i * FRAME, &idx, 4);
+        }
+        produced += n;
+        *data = chunk.data();
+        return n * FRAME;
+    });
+
+    std::vector<uint8_t> out(2048 * FRAME + 3);  // Odd request size: only whole frames returned
+    uint32_t expected = 0;
+    size_t n;
+    while ((n = da.pop(out.data(), out.size())) > 0) {
+        TEST_ASSERT_EQ(n % FRAME, static_cast<size_t>(0), "Partial frame returned");
+        for (size_t off = 0; off < n; off += FRAME) {
+            uint32_t idx;
+            std::memcpy(&idx, out.data() + off, 4);
+            if (idx != expected) {
+                std::cerr << "  frame " << expected << " got " << idx << std::endl;
+                return false;
+            }
+            expected++;
+        }
+    }
+    TEST_ASSERT_EQ(expected, TOTAL_FRAMES, "Frames delivered");
+    TEST_ASSERT(da.drained(), "FIFO should be drained at end of track");
+
+    DecodeAhead::Stats st = da.getStats();
+    TEST_ASSERT_EQ(st.bytesIn, static_cast<uint64_t>(TOTAL_FRAMES) * FRAME, "Bytes decoded");
+    TEST_ASSERT_EQ(st.bytesOut, st.bytesIn, "Bytes taken");
+    da.stop();
+    return true;
+}
+
+//=============================================================================
+// Group 13: Native Containers
+//=============================================================================
+
+namespace {
+void putLE(std::vector<uint8_t>& v, uint64_t x, int n) { for (int i = 0; i < n; i++) v.push_back((x >> (8 * i)) & 0xFF); }
+void putBE(std::vector<uint8_t>& v, uint64_t x, int n) { for (int i = n - 1; i >= 0; i--) v.push_back((x >> (8 * i)) & 0xFF); }
+void putTag(std::vector<uint8_t>& v, const char* t) { v.insert(v.end(), t, t + 4); }
+}
+
+bool test_native_wav_aiff_headers() {
+    // WAV: 96kHz/24-bit stereo, odd-sized LIST chunk before fmt (padding byte)
+    std::vector<uint8_t> wav;
+    putTag(wav, "RIFF"); putLE(wav, 0, 4); putTag(wav, "WAVE");
+    putTag(wav, "LIST"); putLE(wav, 3, 4); wav.insert(wav.end(), {'a', 'b', 'c', 0});
+    putTag(wav, "fmt "); putLE(wav, 16, 4);
+    putLE(wav, 1, 2); putLE(wav, 2, 2); putLE(wav, 96000, 4); putLE(wav, 96000 * 6, 4);
+    putLE(wav, 6, 2); putLE(wav, 24, 2);
+    putTag(wav, "data"); putLE(wav, 6 * 100, 4);
+    size_t wavData = wav.size();
+    wav.insert(wav.end(), {0x56, 0x34, 0x12, 0xFE, 0xFF, 0xFF});  // L=0x123456, R=-2
+
+    NativeLayout l;
+    TEST_ASSERT(parseNativeHeader(wav.data(), wav.size(), l), "WAV header");
+    TEST_ASSERT(l.kind == NativeLayout::Kind::WAV, "WAV kind");
+    TEST_ASSERT_EQ(l.sampleRate, 96000u, "WAV rate");
+    TEST_ASSERT_EQ(l.bitsPerSample, static_cast<uint16_t>(24), "WAV bits");
+    TEST_ASSERT_EQ(l.dataOffset, static_cast<int64_t>(wavData), "WAV data offset");
+    TEST_ASSERT_EQ(l.frames, static_cast<uint64_t>(100), "WAV frames");
+
+    // 24-bit goes to S32 with the sample in the upper three bytes
+    uint8_t out[8];
+    nativePcmToOutput(wav.data() + wavData, out, 2, l);
+    int32_t left, right;
+    std::memcpy(&left, out, 4);
+    std::memcpy(&right, out + 4, 4);
+    TEST_ASSERT_EQ(left, 0x12345600, "WAV 24-bit left");
+    TEST_ASSERT_EQ(right, -2 * 256, "WAV 24-bit right");
+
+    // Float WAV is left to FFmpeg
+    std::vector<uint8_t> wavFloat = wav;
+    wavFloat[12 + 12 + 8] = 3;  // fmt format tag (after RIFF header and padded LIST)
+    TEST_ASSERT(!parseNativeHeader(wavFloat.data(), wavFloat.size(), l), "Float WAV should fall back");
+
+    // AIFF: 44.1kHz/16-bit stereo, big-endian samples
+    std::vector<uint8_t> aiff;
+    putTag(aiff, "FORM"); putBE(aiff, 0, 4); putTag(aiff, "AIFF");
+    putTag(aiff, "COMM"); putBE(aiff, 18, 4);
+    putBE(aiff, 2, 2); putBE(aiff, 50, 4); putBE(aiff, 16, 2);
+    aiff.insert(aiff.end(), {0x40, 0x0E, 0xAC, 0x44, 0, 0, 0, 0, 0, 0});  // 44100.0
+    putTag(aiff, "SSND"); putBE(aiff, 8 + 4 * 50, 4); putBE(aiff, 0, 4); putBE(aiff, 0, 4);
+    size_t aiffData = aiff.size();
+    aiff.insert(aiff.end(), {0x12, 0x34, 0xAB, 0xCD});
+
+    TEST_ASSERT(parseNativeHeader(aiff.data(), aiff.size(), l), "AIFF header");
+    TEST_ASSERT(l.kind == NativeLayout::Kind::AIFF && l.bigEndian, "AIFF kind");
+    TEST_ASSERT_EQ(l.sampleRate, 44100u, "AIFF 80-bit rate");
+    TEST_ASSERT_EQ(l.dataOffset, static_cast<int64_t>(aiffData), "AIFF data offset");
+    TEST_ASSERT_EQ(l.frames, static_cast<uint64_t>(50), "AIFF frames");
+
+    uint8_t s16[4];
+    nativePcmToOutput(aiff.data() + aiffData, s16, 2, l);
+    TEST_ASSERT(s16[0] == 0x34 && s16[1] == 0x12 && s16[2] == 0xCD && s16[3] == 0xAB, "AIFF byte swap");
+    return true;
+}
+
+bool test_native_dsf_header() {
+    // DSD64 stereo, 10000 samples per channel in one 4096-byte block pair
+    std::vector<uint8_t> dsf;
+    putTag(dsf, "DSD "); putLE(dsf, 28, 8); putLE(dsf, 0, 8); putLE(dsf, 0, 8);
+    putTag(dsf, "fmt "); putLE(dsf, 52, 8);
+    putLE(dsf, 1, 4); putLE(dsf, 0, 4); putLE(dsf, 2, 4); putLE(dsf, 2, 4);
+    putLE(dsf, 2822400, 4); putLE(dsf, 1, 4); putLE(dsf, 10000, 8); putLE(dsf, 4096, 4); putLE(dsf, 0, 4);
+    putTag(dsf, "data"); putLE(dsf, 12 + 2 * 4096, 8);
+
+    NativeLayout l;
+    TEST_ASSERT(parseNativeHeader(dsf.data(), dsf.size(), l), "DSF header");
+    TEST_ASSERT(l.kind == NativeLayout::Kind::DSF && !l.dsdMsbFirst, "DSF kind / bit order");
+    TEST_ASSERT_EQ(l.sampleRate, 2822400u, "DSF rate");
+    TEST_ASSERT_EQ(l.dsfBlockSize, 4096u, "DSF block size");
+    TEST_ASSERT_EQ(l.dataOffset, static_cast<int64_t>(28 + 52 + 12), "DSF data offset");
+    TEST_ASSERT_EQ(l.frames, static_cast<uint64_t>(10000), "DSF samples per channel");
+
+    // Data chunk shorter than the padded block pairs: left to FFmpeg
+    std::vector<uint8_t> truncated = dsf;
+    truncated[28 + 52 + 4] = 12 + 100;
+    truncated[28 + 52 + 5] = 0;
+    TEST_ASSERT(!parseNativeHeader(truncated.data(), truncated.size(), l), "Truncated DSF should fall back");
+    return true;
+}
+
+//=============================================================================
+// Group 14: DST Decoding
+//=============================================================================
+
+namespace {
+// Coded frame header (one filter/probability table for all channels, uncoded
+// coefficients) followed by pseudo-random arithmetic-coded payload
+std::vector<uint8_t> dstSyntheticFrame(unsigned channels, size_t bytesPerChannel, uint32_t seed) {
+    std::vector<uint8_t> out;
+    uint32_t acc = 0;
+    int nbits = 0;
+    auto put = [&](uint32_t v, int n) {
+        for (int i = n - 1; i >= 0; i--) {
+            acc = (acc << 1) | ((v >> i) & 1);
+            if (++nbits == 8) { out.push_back(static_cast<uint8_t>(acc)); acc = 0; nbits = 0; }
+        }
+    };
+    auto rnd = [&]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+    put(1, 1);                                      // DST coded
+    put(7, 3);                                      // Same segmentation, one segment
+    put(1, 1); put(1, 1);                           // Same mapping, all channels element 0
+    for (unsigned ch = 0; ch < channels; ch++) put(0, 1);  // No half probability
+    put(127, 7); put(0, 1);                         // 128 filter taps, uncoded
+    for (int i = 0; i < 128; i++) put(static_cast<uint32_t>(static_cast<int>(rnd() % 41) - 20) & 0x1FF, 9);
+    put(63, 6); put(0, 1);                          // 64 probabilities, uncoded
+    for (int i = 0; i < 64; i++) put(rnd() & 0x7F, 7);
+    put(0, 1);
+    while (nbits) put(rnd() & 1, 1);
+    for (size_t i = 0; i < bytesPerChannel * channels; i++) out.push_back(static_cast<uint8_t>(rnd()));
+    return out;
+}
+}
+
+bool test_dst_stored_frame() {
+    // Uncompressed frame: header byte, then byte-interleaved channels
+    const size_t perCh = 8;
+    std::vector<uint8_t> frame = {0x00};
+    for (size_t i = 0; i < perCh; i++) { frame.push_back(static_cast<uint8_t>(i)); frame.push_back(static_cast<uint8_t>(0x80 | i)); }
+    frame.resize(frame.size() - 2);  // Short frame: last byte pair is padded with silence
+
+    auto dec = std::make_unique<DstFrameDecoder>();
+    std::vector<uint8_t> out(2 * perCh);
+    TEST_ASSERT(dec->decode(frame.data(), frame.size(), 2, perCh, out.data()), "Stored frame");
+    for (size_t i = 0; i + 1 < perCh; i++) {
+        TEST_ASSERT_EQ(out[i], static_cast<uint8_t>(i), "Left byte");
+        TEST_ASSERT_EQ(out[perCh + i], static_cast<uint8_t>(0x80 | i), "Right byte");
+    }
+    TEST_ASSERT(out[perCh - 1] == 0x69 && out[2 * perCh - 1] == 0x69, "Missing tail is DSD silence");
+
+    frame[0] = 0x01;  // Reserved bits set
+    TEST_ASSERT(!dec->decode(frame.data(), frame.size(), 2, perCh, out.data()), "Reserved bits rejected");
+    return true;
+}
+
+bool test_dst_pool_matches_serial() {
+    // DSD64 stereo: 4704 bytes per channel per 1/75 s frame
+    const unsigned channels = 2;
+    const size_t perCh = 2822400 / 75 / 8;
+    const int numFrames = 12;
+
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<std::vector<uint8_t>> expected;
+    auto dec = std::make_unique<DstFrameDecoder>();
+    for (int f = 0; f < numFrames; f++) {
+        frames.push_back(dstSyntheticFrame(channels, perCh, 1000 + f));
+        std::vector<uint8_t> out(channels * perCh);
+        TEST_ASSERT(dec->decode(frames.back().data(), frames.back().size(), channels, perCh, out.data()),
+                    "Synthetic frame decodes");
+        expected.push_back(std::move(out));
+    }
+    TEST_ASSERT(expected[0] != expected[1], "Frames differ");
+
+    // Frame 5 is corrupted: delivered as silence, in its slot
+    frames[5][0] = 0x01;
+    DstFramePool pool(4, channels, perCh);
+    size_t submitted = 0;
+    std::vector<uint8_t> out;
+    for (int f = 0; f < numFrames; f++) {
+        while (submitted < frames.size() && pool.inFlight() < 6) {
+            pool.submit(frames[submitted].data(), frames[submitted].size());
+            submitted++;
+        }
+        TEST_ASSERT(pool.next(out), "Frame delivered");
+        if (f == 5) {
+            TEST_ASSERT(out == std::vector<uint8_t>(channels * perCh, 0x69), "Bad frame is silence");
+        } else {
+            TEST_ASSERT(out == expected[f], "Pool output matches serial decode, in order");
+        }
+    }
+    TEST_ASSERT(!pool.next(out), "Nothing left in flight");
+
+    DstFramePool::Stats st = pool.getStats();
+    TEST_ASSERT_EQ(st.frames, static_cast<uint64_t>(numFrames), "Frames decoded");
+    TEST_ASSERT_EQ(st.errors, static_cast<uint64_t>(1), "Errors counted");
+
+    // reset() drops queued frames (seek)
+    pool.submit(frames[0].data(), frames[0].size());
+    pool.submit(frames[1].data(), frames[1].size());
+    pool.reset();
+    TEST_ASSERT_EQ(pool.inFlight(), static_cast<size_t>(0), "Reset empties the queue");
+    return true;
+}
+
+//=============================================================================
+// Group 15: HTTP Keep-Alive Pool
+//=============================================================================
+
+bool test_http_pool_response_parsing() {
+    PooledHttpStream::Response r;
+    TEST_ASSERT(PooledHttpStream::parseResponse(
+        "HTTP/1.1 206 Partial Content\r\nContent-Length: 100\r\n"
+        "content-range: bytes 900-999/1000\r\nAccept-Ranges: bytes\r\n", r), "206 parsed");
+    TEST_ASSERT_EQ(r.status, 206, "Status");
+    TEST_ASSERT_EQ(r.contentLength, static_cast<int64_t>(100), "Content-Length");
+    TEST_ASSERT_EQ(r.rangeStart, static_cast<int64_t>(900), "Range start");
+    TEST_ASSERT_EQ(r.totalSize, static_cast<int64_t>(1000), "Total size");
+    TEST_ASSERT(r.keepAlive && r.acceptRanges && !r.chunked, "HTTP/1.1 keeps alive by default");
+
+    PooledHttpStream::Response c;
+    TEST_ASSERT(PooledHttpStream::parseResponse(
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\nConnection: close\r\n", c), "200 parsed");
+    TEST_ASSERT(c.chunked && !c.keepAlive && c.contentLength < 0, "Chunked, close");
+
+    PooledHttpStream::Response old;
+    TEST_ASSERT(PooledHttpStream::parseResponse("HTTP/1.0 200 OK\r\nContent-Length: 5\r\n", old), "1.0 parsed");
+    TEST_ASSERT(!old.keepAlive, "HTTP/1.0 closes by default");
+    TEST_ASSERT(!PooledHttpStream::parseResponse("ICY 200 OK\r\n", old), "Not HTTP");
+    return true;
+}
+
+namespace {
+// Loopback range server: every connection serves any number of requests ("bytes=a-" or "a-b")
+class LoopbackRangeServer {
+public:
+    explicit LoopbackRangeServer(const std::vector<uint8_t>& body) : m_body(body) {
+        m_listen = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(m_listen, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(m_listen, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+        ::listen(m_listen, 8);
+        m_thread = std::thread([this]() { acceptLoop(); });
+    }
+
+    ~LoopbackRangeServer() {
+        m_stop = true;
+        m_thread.join();
+        for (auto& t : m_handlers) t.join();
+        ::close(m_listen);
+    }
+
+    int port() const { return m_port; }
+    int accepted() const { return m_accepted.load(); }
+
+private:
+    void acceptLoop() {
+        while (!m_stop) {
+            pollfd p{m_listen, POLLIN, 0};
+            if (::poll(&p, 1, 20) <= 0) continue;
+            int fd = ::accept(m_listen, nullptr, nullptr);
+            if (fd < 0) continue;
+            m_accepted++;
+            m_handlers.emplace_back([this, fd]() { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string in;
+        char buf[4096];
+        while (!m_stop) {
+            pollfd p{fd, POLLIN, 0};
+            if (::poll(&p, 1, 20) <= 0) continue;
+            ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            in.append(buf, static_cast<size_t>(n));
+            size_t end;
+            while ((end = in.find("\r\n\r\n")) != std::string::npos) {
+                size_t start = 0;
+                size_t last = m_body.size() - 1;
+                size_t r = in.find("Range: bytes=");
+                if (r != std::string::npos && r < end) {
+                    char* dash = nullptr;
+                    start = std::strtoull(in.c_str() + r + 13, &dash, 10);
+                    if (dash[1] >= '0' && dash[1] <= '9') last = std::min<size_t>(last, std::strtoull(dash + 1, nullptr, 10));
+                }
+                in.erase(0, end + 4);
+                std::string head = "HTTP/1.1 206 Partial Content\r\nContent-Length: " +
+                    std::to_string(last + 1 - start) + "\r\nContent-Range: bytes " +
+                    std::to_string(start) + "-" + std::to_string(last) + "/" +
+                    std::to_string(m_body.size()) + "\r\n\r\n";
+                std::string out = head + std::string(m_body.begin() + start, m_body.begin() + last + 1);
+                for (size_t sent = 0; sent < out.size();) {
+                    ssize_t w = ::send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+                    if (w <= 0) break;
+                    sent += static_cast<size_t>(w);
+                }
+            }
+        }
+        ::close(fd);
+    }
+
+    std::vector<uint8_t> m_body;
+    int m_listen = -1;
+    int m_port = 0;
+    std::atomic<bool> m_stop{false};
+    std::atomic<int> m_accepted{0};
+    std::thread m_thread;
+    std::vector<std::thread> m_handlers;  // Accept thread only
+};
+
+int abortNow(void*) { return 1; }
+}
+
+bool test_http_pool_keep_alive_reuse() {
+    std::vector<uint8_t> body(200000);
+    for (size_t i = 0; i < body.size(); i++) body[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+    LoopbackRangeServer server(body);
+    std::string url = "http://127.0.0.1:" + std::to_string(server.port()) + "/track.flac?id=1";
+
+    HttpConnectionPool pool(2);
+    auto readAll = [&](PooledHttpStream& s, int64_t from) {
+        std::vector<uint8_t> got;
+        uint8_t buf[70000];
+        int n;
+        while ((n = s.read(buf, sizeof(buf))) > 0) got.insert(got.end(), buf, buf + n);
+        return n == 0 && got == std::vector<uint8_t>(body.begin() + from, body.end());
+    };
+
+    {
+        PooledHttpStream a(pool);
+        TEST_ASSERT_EQ(a.open(url), 0, "First track opened");
+        TEST_ASSERT(!a.reused(), "First request connects");
+        TEST_ASSERT_EQ(a.size(), static_cast<int64_t>(body.size()), "Size from Content-Range");
+        TEST_ASSERT(a.seekable(), "206 is seekable");
+        TEST_ASSERT(readAll(a, 0), "First track body");
+    }
+    {
+        PooledHttpStream b(pool);
+        TEST_ASSERT_EQ(b.open(url), 0, "Second track opened");
+        TEST_ASSERT(b.reused(), "Second track reuses the kept-alive connection");
+        TEST_ASSERT_EQ(b.seek(150000), static_cast<int64_t>(150000), "Short forward seek reads through");
+        TEST_ASSERT(readAll(b, 150000), "Body after seek");
+        TEST_ASSERT_EQ(b.seek(1000), static_cast<int64_t>(1000), "Seek back after the end");
+        TEST_ASSERT(b.reused(), "Seek reuses the connection of the finished response");
+        TEST_ASSERT(readAll(b, 1000), "Body after second seek");
+    }
+    TEST_ASSERT_EQ(server.accepted(), 1, "Two tracks and their seeks on one connection");
+
+    // Per-host cap: a third concurrent stream waits for a slot (aborted here)
+    HttpConnectionPool capped(1);
+    PooledHttpStream holder(capped);
+    TEST_ASSERT_EQ(holder.open(url), 0, "Slot holder opened");
+    PooledHttpStream waiter(capped, abortNow, nullptr);
+    TEST_ASSERT_EQ(waiter.open(url), -EBUSY, "Second stream blocked by the per-host cap");
+    TEST_ASSERT_EQ(capped.getStats().waits, static_cast<uint64_t>(1), "Wait counted");
+    holder.close();
+    PooledHttpStream after(capped);
+    TEST_ASSERT_EQ(after.open(url), 0, "Slot free once the holder closed");
+    return true;
+}
+
+//=============================================================================
+// Group 16: Stream Probe Cache
+//=============================================================================
+
+bool test_stream_probe_cache_lru() {
+    StreamProbeCache cache(2);
+    auto probe = [](int64_t size, int rate) {
+        StreamProbe p;
+        p.demuxer = "flac";
+        p.size = size;
+        p.streamIndex = 0;
+        p.sampleRate = rate;
+        p.extradata = {0x10, 0x00, 0x10, 0x00};
+        return p;
+    };
+
+    StreamProbe out;
+    TEST_ASSERT(!cache.lookup("http://a/1.flac", out), "Empty cache misses");
+    cache.store("http://a/live", probe(-1, 44100));
+    TEST_ASSERT(!cache.lookup("http://a/live", out), "Unknown size is not cached");
+
+    cache.store("http://a/1.flac", probe(1000, 44100));
+    cache.store("http://a/2.flac", probe(2000, 96000));
+    TEST_ASSERT(cache.lookup("http://a/1.flac", out), "Stored entry found");
+    TEST_ASSERT(out.size == 1000 && out.sampleRate == 44100 && out.extradata.size() == 4, "Entry copied out");
+
+    // 1 was used last: adding 3 evicts 2
+    cache.store("http://a/3.flac", probe(3000, 192000));
+    TEST_ASSERT(!cache.lookup("http://a/2.flac", out), "Least recently used evicted");
+    TEST_ASSERT(cache.lookup("http://a/1.flac", out), "Recently used kept");
+    TEST_ASSERT(cache.lookup("http://a/3.flac", out) && out.sampleRate == 192000, "New entry kept");
+
+    cache.invalidate("http://a/3.flac");
+    TEST_ASSERT(!cache.lookup("http://a/3.flac", out), "Invalidated entry gone");
+
+    StreamProbeCache::Stats st = cache.getStats();
+    TEST_ASSERT_EQ(st.hits, static_cast<uint64_t>(2), "Hits exclude the stale one");
+    TEST_ASSERT_EQ(st.stale, static_cast<uint64_t>(1), "Stale counted");
+    TEST_ASSERT_EQ(st.misses, static_cast<uint64_t>(4), "Misses");
+    TEST_ASSERT_EQ(st.entries, static_cast<size_t>(1), "Entries");
+    return true;
+}
+
+//=============================================================================
+// Group 17: Parallel Range Download
+//=============================================================================
+
+bool test_parallel_range_reader_in_order() {
+    const size_t seg = ParallelRangeReader::SEGMENT_SIZE;
+    std::vector<uint8_t> body(5 * seg + 12345);
+    for (size_t i = 0; i < body.size(); i++) body[i] = static_cast<uint8_t>((i * 131) ^ (i >> 12));
+    LoopbackRangeServer server(body);
+    std::string url = "http://127.0.0.1:" + std::to_string(server.port()) + "/hires.wav";
+
+    HttpConnectionPool pool(4);
+    ParallelRangeReader reader(pool, url, static_cast<int64_t>(body.size()), 3);
+    auto readFrom = [&](size_t from) {
+        std::vector<uint8_t> got;
+        std::vector<uint8_t> buf(65536);
+        int n;
+        while ((n = reader.read(buf.data(), static_cast<int>(buf.size()))) > 0) got.insert(got.end(), buf.begin(), buf.begin() + n);
+        return n == 0 && got == std::vector<uint8_t>(body.begin() + static_cast<long>(from), body.end());
+    };
+
+    TEST_ASSERT(readFrom(0), "Segments delivered in order");
+    TEST_ASSERT_EQ(reader.seek(static_cast<int64_t>(2 * seg + 777)), static_cast<int64_t>(2 * seg + 777), "Seek");
+    TEST_ASSERT(readFrom(2 * seg + 777), "Body after seek");
+
+    ParallelRangeReader::Stats st = reader.getStats();
+    TEST_ASSERT(st.peakConnections > 1 && st.peakConnections <= 3, "Connections grew while the reader waited");
+    TEST_ASSERT_EQ(st.failures, static_cast<uint64_t>(0), "No failed fetches");
+    TEST_ASSERT(server.accepted() > 1, "Segments fetched over several connections");
+    reader.stop();
+
+    // Pool cap below the requested connections: extras are refused, not fatal
+    HttpConnectionPool capped(1);
+    ParallelRangeReader limited(capped, url, static_cast<int64_t>(body.size()), 3);
+    std::vector<uint8_t> got;
+    std::vector<uint8_t> buf(65536);
+    int n;
+    while ((n = limited.read(buf.data(), static_cast<int>(buf.size()))) > 0) got.insert(got.end(), buf.begin(), buf.begin() + n);
+    TEST_ASSERT(n == 0 && got == body, "Complete over one connection when the cap refuses more");
+    return true;
+}
+
+bool test_parallel_range_reader_abort_stalled() {
+    // Listens but never answers: connects succeed, no response ever arrives
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len);
+    ::listen(listener, 8);
+    std::string url = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/stalled.wav";
+
+    static std::atomic<bool> abortFlag{false};
+    abortFlag = false;
+    auto abortCb = [](void*) -> int { return abortFlag.load() ? 1 : 0; };
+
+    HttpConnectionPool pool(4);
+    auto reader = std::make_unique<ParallelRangeReader>(
+        pool, url, static_cast<int64_t>(4 * ParallelRangeReader::SEGMENT_SIZE), 2, abortCb, nullptr);
+    std::atomic<int> result{1};
+    std::thread consumer([&]() {
+        std::vector<uint8_t> buf(65536);
+        result = reader->read(buf.data(), static_cast<int>(buf.size()));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    TEST_ASSERT_EQ(result.load(), 1, "read() waits for the first segment");
+
+    auto t0 = std::chrono::steady_clock::now();
+    abortFlag = true;
+    consumer.join();
+    reader.reset();   // stop() joins workers blocked on the silent server
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    ::close(listener);
+
+    TEST_ASSERT_EQ(result.load(), -EINTR, "Aborted read() returns -EINTR");
+    TEST_ASSERT(ms < 1000, "Abort and stop do not wait for the server");
+    return true;
+}
+
+//=============================================================================
+// Group 18: Seek Index
+//=============================================================================
+
+bool test_seek_index_floor() {
+    SeekIndex index(75);
+    SeekIndex::Point pt;
+    TEST_ASSERT(!index.floor(100, pt), "Empty index has no point");
+
+    // Playback records every frame; only stride multiples are kept
+    for (uint64_t f = 0; f < 300; f++) index.add(f, 1000 + static_cast<int64_t>(f) * 10);
+    TEST_ASSERT_EQ(index.size(), static_cast<size_t>(4), "One point per stride");
+    TEST_ASSERT_EQ(index.last(), static_cast<uint64_t>(225), "Last point");
+
+    TEST_ASSERT(index.floor(0, pt) && pt.position == 0 && pt.offset == 1000, "Floor of the first frame");
+    TEST_ASSERT(index.floor(149, pt) && pt.position == 75 && pt.offset == 1750, "Floor between points");
+    TEST_ASSERT(index.floor(150, pt) && pt.position == 150, "Floor on a point");
+    TEST_ASSERT(index.floor(10000, pt) && pt.position == 225, "Floor past the end");
+
+    // Seek back and replay: no duplicates; a later gap fills in order
+    index.add(150, 99);
+    TEST_ASSERT(index.floor(150, pt) && pt.offset == 2500, "Replayed point kept");
+    index.add(600, 7000);
+    index.add(450, 5500);
+    TEST_ASSERT_EQ(index.size(), static_cast<size_t>(6), "Out-of-order points inserted");
+    TEST_ASSERT(index.floor(500, pt) && pt.position == 450 && pt.offset == 5500, "Inserted point found");
+    TEST_ASSERT(index.floor(599, pt) && pt.position == 450, "Sorted after insert");
+    return true;
+}
+
+//=============================================================================
+// Group 19: io_uring File Reader
+//=============================================================================
+
+bool test_uring_reader_sequential_and_seek() {
+    std::string path = "/tmp/diretta_uring_test_" + std::to_string(getpid());
+    const size_t block = UringFileReader::CHUNK_SIZE;
+    std::vector<uint8_t> body(3 * block + 54321);
+    uint32_t seed = 7;
+    for (auto& b : body) { seed = seed * 1664525u + 1013904223u; b = static_cast<uint8_t>(seed >> 24); }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+    }
+
+    UringFileReader reader(2);   // Fewer slots than blocks: read-ahead has to refill
+    int ret = reader.open(path);
+    if (ret == -ENOSYS || ret == -EPERM) {
+        std::cout << "(io_uring unavailable, skipped) ";
+        unlink(path.c_str());
+        return true;
+    }
+    TEST_ASSERT_EQ(ret, 0, "Open");
+    TEST_ASSERT_EQ(reader.size(), static_cast<int64_t>(body.size()), "Size");
+
+    // Odd chunk sizes straddle block boundaries
+    std::vector<uint8_t> got;
+    std::vector<uint8_t> buf(100000);
+    int n;
+    while ((n = reader.read(buf.data(), 77777)) > 0) got.insert(got.end(), buf.begin(), buf.begin() + n);
+    TEST_ASSERT(n == 0 && got == body, "Sequential read matches the file");
+
+    // Backward seek restarts read-ahead; forward seek inside the read-ahead keeps it
+    TEST_ASSERT_EQ(reader.seek(1000), static_cast<int64_t>(1000), "Seek back");
+    n = reader.read(buf.data(), 5000);
+    TEST_ASSERT(n > 0 && std::memcmp(buf.data(), body.data() + 1000, static_cast<size_t>(n)) == 0, "Data after seek back");
+    int64_t ahead = static_cast<int64_t>(block + 12345);
+    TEST_ASSERT_EQ(reader.seek(ahead), ahead, "Seek ahead");
+    n = reader.read(buf.data(), 4096);
+    TEST_ASSERT(n > 0 && std::memcmp(buf.data(), body.data() + ahead, static_cast<size_t>(n)) == 0, "Data after seek ahead");
+    TEST_ASSERT_EQ(reader.seek(static_cast<int64_t>(body.size())), static_cast<int64_t>(body.size()), "Seek to end");
+    TEST_ASSERT_EQ(reader.read(buf.data(), 4096), 0, "EOF at the end");
+
+    UringFileReader::Stats st = reader.getStats();
+    TEST_ASSERT(st.reads >= 4 && st.bytes >= body.size(), "Stats counted");
+    reader.close();
+
+    // One slot, still reading ahead when the decoder seeks away: no false EOF
+    std::vector<uint8_t> big(4 << 20);
+    for (size_t i = 0; i < big.size(); i++) big[i] = static_cast<uint8_t>((i * 37) ^ (i >> 16));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(big.data()), static_cast<std::streamsize>(big.size()));
+    }
+    UringFileReader single(1);
+    TEST_ASSERT_EQ(single.open(path), 0, "Open single-slot reader");
+    buf.resize(block);
+    int first = 0;
+    while (first < static_cast<int>(block)) {
+        n = single.read(buf.data() + first, static_cast<int>(block) - first);
+        TEST_ASSERT(n > 0, "First block");
+        first += n;
+    }
+    const int64_t target = 3 << 20;
+    TEST_ASSERT_EQ(single.seek(target), target, "Seek past the slot in flight");
+    n = single.read(buf.data(), 4096);
+    TEST_ASSERT(n > 0 && std::memcmp(buf.data(), big.data() + target, static_cast<size_t>(n)) == 0,
+                "Data after seek, not EOF");
+    single.close();
+    TEST_ASSERT(reader.open(path + ".missing") == -ENOENT, "Missing file reports ENOENT");
+    unlink(path.c_str());
+    return true;
+}
+
+//=============================================================================
+// Group 20: Mapped File
+//=============================================================================
+
+bool test_mapped_file_view_and_seek() {
+    std::string path = "/tmp/diretta_mmap_test_" + std::to_string(getpid());
+    std::vector<uint8_t> body(MappedFile::WILLNEED_BYTES + 12345);
+    for (size_t i = 0; i < body.size(); i++) body[i] = static_cast<uint8_t>(i * 31 + (i >> 12));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+    }
+
+    MappedFile file;
+    TEST_ASSERT_EQ(file.open(path), 0, "Open");
+    TEST_ASSERT_EQ(file.size(), static_cast<int64_t>(body.size()), "Size");
+
+    // Views walk the file in place, across the read-ahead window
+    std::vector<uint8_t> got;
+    size_t n;
+    do {
+        const uint8_t* p = file.view(1 << 20, n);
+        got.insert(got.end(), p, p + n);
+    } while (n > 0);
+    TEST_ASSERT(got == body, "Views cover the file");
+    TEST_ASSERT_EQ(file.position(), static_cast<int64_t>(body.size()), "Position at the end");
+
+    // read() (the AVIO path) and seek share the position
+    std::vector<uint8_t> buf(4096);
+    TEST_ASSERT_EQ(file.seek(777), static_cast<int64_t>(777), "Seek back");
+    TEST_ASSERT_EQ(file.read(buf.data(), 4096), 4096, "Read after seek");
+    TEST_ASSERT(std::memcmp(buf.data(), body.data() + 777, 4096) == 0, "Data after seek");
+    const uint8_t* p = file.view(10, n);
+    TEST_ASSERT(n == 10 && p[0] == body[777 + 4096], "View continues after read");
+    TEST_ASSERT_EQ(file.seek(static_cast<int64_t>(body.size()) - 5), static_cast<int64_t>(body.size()) - 5, "Seek near end");
+    TEST_ASSERT_EQ(file.read(buf.data(), 4096), 5, "Short read at the end");
+    TEST_ASSERT_EQ(file.read(buf.data(), 4096), 0, "EOF");
+
+    file.close();
+    TEST_ASSERT(!file.isOpen(), "Closed");
+    TEST_ASSERT(file.open(path + ".missing") == -ENOENT, "Missing file reports ENOENT");
+    unlink(path.c_str());
+    return true;
+}
+
+//=============================================================================
+// Group 21: SPSC Queue
+//=============================================================================
+
+bool test_spsc_queue_order_and_stop() {
+    SpscQueue<uint32_t> q(3);
+    TEST_ASSERT_EQ(q.capacity(), static_cast<size_t>(4), "Capacity rounded to a power of two");
+    uint32_t v = 0;
+    TEST_ASSERT(!q.tryPop(v), "Empty");
+    for (uint32_t i = 0; i < 4; i++) TEST_ASSERT(q.tryPush(i), "Push up to capacity");
+    TEST_ASSERT(!q.tryPush(99), "Full");
+    TEST_ASSERT_EQ(q.size(), static_cast<size_t>(4), "Size when full");
+    TEST_ASSERT(q.tryPop(v) && v == 0, "FIFO order");
+    while (q.tryPop(v)) {}
+
+    // Producer and consumer both block: the queue is tiny next to the count
+    const uint32_t count = 200000;
+    std::atomic<bool> stop{false};
+    std::thread producer([&]() {
+        for (uint32_t i = 1; i <= count; i++) {
+            if (!q.push(i, stop)) return;
+        }
+    });
+    bool ordered = true;
+    uint32_t expected = 1;
+    while (expected <= count) {
+        if (!q.pop(v, stop)) break;
+        if (v != expected) ordered = false;
+        expected++;
+    }
+    producer.join();
+    TEST_ASSERT(ordered && expected == count + 1, "Every element once, in order, across threads");
+
+    // A consumer waiting on an empty queue returns once stop is set
+    std::thread stopper([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        stop.store(true);
+        q.wakeAll();
+    });
+    bool popped = q.pop(v, stop);
+    stopper.join();
+    TEST_ASSERT(!popped, "pop() gives up on stop");
+    return true;
+}